@@ -0,0 +1,161 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Public functions for running work on Wima's thread pool.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#ifndef WIMA_JOB_H
+#define WIMA_JOB_H
+
+/* For C++ compatibility. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <wima/wima.h>
+
+#include <yc/opt.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Job functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @defgroup job job
+ * Functions for running work on Wima's thread pool.
+ * The pool is started by @a wima_init() and stopped by
+ * @a wima_exit(). It has one worker per CPU (less one
+ * for the main thread), and idle workers steal jobs
+ * from busy ones, so apps and plugins should use it
+ * instead of starting their own threads.
+ *
+ * Jobs must not call Wima functions that are not
+ * documented as thread-safe. To get results back to
+ * the main thread, use @a wima_job_post().
+ * @{
+ */
+
+/**
+ * A job.
+ * @param data	The user pointer given when
+ *				the job was started.
+ */
+typedef void (*WimaJobFunc)(void* data);
+
+/**
+ * A job that produces a result for a window.
+ * @param data	The user pointer given when
+ *				the job was started.
+ * @return		The result, which is delivered
+ *				as the data of a user event.
+ */
+typedef void* (*WimaJobResultFunc)(void* data);
+
+/**
+ * One iteration of a parallel loop.
+ * @param data	The user pointer given to
+ *				@a wima_job_parallel().
+ * @param idx	The index of the iteration.
+ */
+typedef void (*WimaJobRangeFunc)(void* data, size_t idx);
+
+/**
+ * Runs @a func on the thread pool. This
+ * can be called from any thread.
+ * @param func	The job to run.
+ * @param data	The user pointer to pass to @a func.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ * @pre			Wima must be initialized.
+ * @pre			@a func must not be NULL.
+ */
+WimaStatus wima_job_run(WimaJobFunc func, void* data) yparamsnonnull(1);
+
+/**
+ * Runs @a func on the thread pool, then posts its result
+ * to @a wwh as a user event with type @a type (see
+ * @a wima_window_postEvent()). The event is delivered to
+ * the app's user event callback on the main thread. This
+ * can be called from any thread.
+ *
+ * If the window is closed before the event is delivered,
+ * the event is dropped, so if the result needs to be
+ * freed, the app should not close windows with jobs
+ * that are still running.
+ * @param wwh	The window to post the result to.
+ * @param type	The type of the user event.
+ * @param func	The job to run.
+ * @param data	The user pointer to pass to @a func.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ * @pre			Wima must be initialized.
+ * @pre			@a func must not be NULL.
+ */
+WimaStatus wima_job_post(WimaWindow wwh, uint32_t type, WimaJobResultFunc func, void* data) yparamsnonnull(3);
+
+/**
+ * Calls @a func @a count times, with indices from 0 to
+ * @a count - 1, on the thread pool and waits for all of
+ * the calls to finish. The calling thread runs jobs while
+ * it waits, so this can be called from jobs as well.
+ * @param count	The number of iterations.
+ * @param func	The function to call for each iteration.
+ * @param data	The user pointer to pass to @a func.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise. On error,
+ *				no iterations have been run.
+ * @pre			Wima must be initialized.
+ * @pre			@a func must not be NULL.
+ */
+WimaStatus wima_job_parallel(size_t count, WimaJobRangeFunc func, void* data) yparamsnonnull(2);
+
+/**
+ * Returns the number of worker threads in the pool.
+ * @return	The number of worker threads.
+ * @pre		Wima must be initialized.
+ */
+uint32_t wima_job_threads(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // WIMA_JOB_H
@@ -64,7 +64,7 @@ extern "C" {
  * @def WIMA_LAYOUT_INVALID
  * A handle indicating an invalid layout.
  */
-#define WIMA_LAYOUT_INVALID ((uint16_t) -1)
+#define WIMA_LAYOUT_INVALID ((uint32_t) -1)
 
 /**
  * @def WIMA_LAYOUT_MAX
@@ -107,8 +107,9 @@ extern "C" {
  */
 typedef struct WimaLayout
 {
-	/// The ID of the layout.
-	uint16_t layout;
+	/// The ID of the layout. This is its
+	/// index in the region's items.
+	uint32_t layout;
 
 	/// The area the layout is in.
 	WimaAreaNode area;
@@ -121,6 +122,25 @@ typedef struct WimaLayout
 
 } WimaLayout;
 
+/**
+ * A function type to build a row of a virtual list.
+ * See @a wima_layout_virtualList().
+ * @param row	The layout to put the row's widgets in.
+ * @param idx	The index of the row in the list.
+ * @return		WIMA_STATUS_SUCCESS on success,
+ *				an error code otherwise.
+ */
+typedef WimaStatus (*WimaLayoutRowFunc)(WimaLayout row, uint32_t idx);
+
+/**
+ * A function type to estimate the height of a
+ * row of a virtual list without building it.
+ * See @a wima_layout_virtualList().
+ * @param idx	The index of the row in the list.
+ * @return		The height of the row.
+ */
+typedef float (*WimaLayoutRowHeightFunc)(uint32_t idx);
+
 /**
  * Sets whether @a wlh (and its children) are enabled.
  * If a layout is not enabled, none of its children are.
@@ -213,6 +233,47 @@ WimaLayout wima_layout_grid(WimaLayout parent, uint16_t flags, uint32_t cols) yi
  */
 WimaWidget wima_layout_widget(WimaLayout parent, WimaProperty prop);
 
+/**
+ * Creates a virtual list in @a parent. A virtual list has
+ * @a rows rows, but only the rows that are in view (plus
+ * a few on either side) are built, by calling @a build,
+ * so the cost of a list does not depend on its length.
+ * The list scrolls its rows vertically on its own, and
+ * the rows are built again whenever it scrolls.
+ *
+ * If @a height is NULL, every row is @a rowHeight tall.
+ * Otherwise, @a height is called once for every row when
+ * the list is first created, and the heights are kept
+ * until @a rows, @a height, or @a version changes. Change
+ * @a version whenever the height of any row changes.
+ *
+ * Widget data for the widgets in a row is kept while the
+ * row is built, which is while it is in view or close to
+ * it, and is freed when the row scrolls farther away than
+ * that, so the memory a list uses stays the size of its
+ * view. A row that scrolls back into view starts with
+ * new widget data.
+ * @param parent	The parent layout to insert into.
+ * @param flags		The flags to set in the list.
+ * @param rows		The number of rows in the list.
+ * @param rowHeight	The height of every row, if @a height
+ *					is NULL. Otherwise, this is ignored.
+ * @param height	The function to get row heights, or NULL.
+ * @param version	The version of the row heights. The
+ *					heights are asked for again when
+ *					this differs from the last time.
+ *					This is ignored if @a height is NULL.
+ * @param build		The function to build a row.
+ * @return			The list layout.
+ * @pre				@a parent must be a valid WimaLayout.
+ * @pre				@a parent must be in a region of an area.
+ * @pre				@a build must not be NULL.
+ * @pre				@a rowHeight must be greater than 0 if
+ *					@a height is NULL.
+ */
+WimaLayout wima_layout_virtualList(WimaLayout parent, uint16_t flags, uint32_t rows, float rowHeight,
+                                   WimaLayoutRowHeightFunc height, uint32_t version, WimaLayoutRowFunc build);
+
 /**
  * @}
  */
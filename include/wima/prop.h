@@ -260,6 +260,18 @@ void wima_prop_setIcon(WimaProperty wph, WimaIcon icon) yinline;
  */
 WimaIcon wima_prop_icon(WimaProperty wph) yinline;
 
+/**
+ * Returns the version of @a wph. The version is
+ * incremented every time @a wph is updated, so
+ * clients can cheaply tell whether it changed.
+ * Updating a property also redraws the areas
+ * of all widgets that show it.
+ * @param wph	The property to query.
+ * @return		The version of @a wph.
+ * @pre			@a wph must be a valid @a WimaProperty.
+ */
+uint32_t wima_prop_version(WimaProperty wph) yinline;
+
 /**
  * Returns the @a WimaProperty with @a name. If there is no
  * WimaProperty with @a name, it returns @a WIMA_PROP_INVALID.
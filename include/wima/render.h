@@ -154,7 +154,12 @@ typedef enum WimaImageFlags
 } WimaImageFlags;
 
 /**
- * Loads an image from @a path with @a flags.
+ * Loads an image from @a path with @a flags. The image
+ * is decoded once on the thread pool and then uploaded
+ * to every window. The handle is valid right away, and
+ * until the upload is done, a placeholder is drawn. If
+ * decoding fails, the app's error callback gets
+ * WIMA_STATUS_IMAGE_LOAD_ERR, and the placeholder stays.
  * @param path	The path to the image file.
  * @param flags	The flags to load the image with.
  * @return		The newly-created image.
@@ -742,12 +747,13 @@ WimaPaint wima_paint_radialGradient(WimaRenderContext* ctx, WimaVecf c, float in
  * @param o		The top left corner.
  * @param e		Size (extent) of one image.
  * @param angle	The rotation around the top left corner in radians.
- * @param image	The image handle for the pattern.
+ * @param image	The image for the pattern. If it has not
+ *				finished loading, a placeholder is used.
  * @param alpha	The alpha to render at.
  * @return		The image pattern as a paint.
  * @pre			@a ctx must not be NULL.
  */
-WimaPaint wima_paint_imagePattern(WimaRenderContext* ctx, WimaVecf o, WimaSizef e, float angle, int image,
+WimaPaint wima_paint_imagePattern(WimaRenderContext* ctx, WimaVecf o, WimaSizef e, float angle, WimaImage image,
                                   float alpha) yallnonnull yinline;
 
 /**
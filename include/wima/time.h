@@ -42,8 +42,11 @@
 extern "C" {
 #endif
 
+#include <wima/wima.h>
+
 #include <yc/opt.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,6 +95,215 @@ uint64_t wima_time_raw() yinline;
  */
 uint64_t wima_time_freq() yinline;
 
+/**
+ * The phases of a frame that Wima keeps timing for.
+ */
+typedef enum WimaFramePhase
+{
+	/// Processing the window's events.
+	WIMA_FRAME_PHASE_EVENTS = 0,
+
+	/// Laying out areas and the header.
+	WIMA_FRAME_PHASE_LAYOUT,
+
+	/// Drawing areas, overlays, and tooltips.
+	WIMA_FRAME_PHASE_DRAW,
+
+	/// Ending the NanoVG frame (the GL calls)
+	/// and copying the window's framebuffer.
+	WIMA_FRAME_PHASE_END,
+
+	/// Swapping buffers.
+	WIMA_FRAME_PHASE_SWAP,
+
+	/// The sum of all of the other phases.
+	WIMA_FRAME_PHASE_TOTAL
+
+} WimaFramePhase;
+
+/**
+ * Statistics about a phase over the recent frames of a
+ * window. Only frames that drew something are counted;
+ * event processing in between is added to the next one.
+ */
+typedef struct WimaFrameStats
+{
+	/// The shortest time, in seconds.
+	double min;
+
+	/// The average time, in seconds.
+	double avg;
+
+	/// The 99th percentile time, in seconds.
+	double p99;
+
+	/// The longest time, in seconds.
+	double max;
+
+	/// The number of frames the stats are over.
+	uint32_t frames;
+
+} WimaFrameStats;
+
+/**
+ * Returns statistics about how long @a phase took in the
+ * recent frames of @a wwh. If no frames have been drawn,
+ * all fields are zero.
+ * @param wwh	The window to query.
+ * @param phase	The phase to query.
+ * @return		The stats for @a phase.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+WimaFrameStats wima_time_frameStats(WimaWindow wwh, WimaFramePhase phase);
+
+/**
+ * Forgets all recent frame timings of @a wwh.
+ * @param wwh	The window to clear.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_time_clearFrames(WimaWindow wwh);
+
+/**
+ * @}
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Timer functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @defgroup timer timer
+ * Functions for scheduling callbacks. Timers are kept in a
+ * hierarchical timing wheel with millisecond ticks, and
+ * they are run by @a wima_main() after events have been
+ * processed, so callbacks can safely update properties.
+ * The event loop sleeps until the next timer is due.
+ * @{
+ */
+
+/**
+ * A handle to a timer. Handles of stopped timers
+ * are never reused for new timers (until 65536
+ * timers have used the same slot).
+ */
+typedef uint32_t WimaTimer;
+
+/**
+ * @def WIMA_TIMER_INVALID
+ * A handle indicating an invalid timer.
+ */
+#define WIMA_TIMER_INVALID ((WimaTimer) -1)
+
+/**
+ * @def WIMA_TIMER_MAX
+ * The max number of timers that can be running at once.
+ */
+#define WIMA_TIMER_MAX (0xFFFF)
+
+/**
+ * A timer callback.
+ * @param timer	The timer that expired.
+ * @param user	The user pointer given when
+ *				the timer was started.
+ */
+typedef void (*WimaTimerFunc)(WimaTimer timer, void* user);
+
+/**
+ * Starts a timer that calls @a func after @a delay seconds,
+ * and then, if @a interval is not zero, every @a interval
+ * seconds until it is stopped. Timers never fire early, but
+ * they can fire late if the event loop is busy; a repeating
+ * timer that falls behind skips the periods it missed.
+ * @param delay		The number of seconds until the first call.
+ * @param interval	The number of seconds between calls, or 0
+ *					for a one-shot timer.
+ * @param func		The function to call.
+ * @param user		A pointer to pass to @a func.
+ * @return			The timer, or WIMA_TIMER_INVALID on error.
+ * @pre				Wima must be initialized.
+ * @pre				@a delay and @a interval must be finite
+ *					and not negative.
+ * @pre				@a func must not be NULL.
+ */
+WimaTimer wima_timer_start(double delay, double interval, WimaTimerFunc func, void* user) yparamsnonnull(3);
+
+/**
+ * Stops @a timer. One-shot timers stop on their own
+ * after they fire, and stopping a timer that is already
+ * stopped does nothing, so this is safe to call with
+ * any handle returned by @a wima_timer_start(). It is
+ * also safe to call from any timer callback.
+ * @param timer	The timer to stop.
+ * @pre			Wima must be initialized.
+ */
+void wima_timer_stop(WimaTimer timer);
+
+/**
+ * Returns whether or not @a timer is still running.
+ * @param timer	The timer to query.
+ * @return		true if @a timer will fire again,
+ *				false otherwise.
+ * @pre			Wima must be initialized.
+ */
+bool wima_timer_active(WimaTimer timer);
+
+/**
+ * @}
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Trace functions.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @defgroup trace trace
+ * Functions for recording traces of what Wima does.
+ * Traces are written as Chrome trace-event JSON, which
+ * can be opened in chrome://tracing or Perfetto.
+ *
+ * Event processing (by event type), region layout,
+ * widget drawing, icon and image loading, and window
+ * activation are traced. Each thread records into its
+ * own buffer without locking. When tracing is stopped,
+ * the only cost is one atomic load per span.
+ * @{
+ */
+
+/**
+ * Starts recording spans. The trace is written to
+ * @a path when @a wima_trace_write() is called and
+ * when @a wima_exit() is called.
+ * @param path	The path of the file to write the trace to.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ * @pre			Wima must be initialized.
+ */
+WimaStatus wima_trace_start(const char* path) yallnonnull;
+
+/**
+ * Stops recording spans. Spans already recorded are kept
+ * and will still be written. Tracing can be restarted.
+ * @pre	Wima must be initialized.
+ */
+void wima_trace_stop(void);
+
+/**
+ * Returns whether or not spans are being recorded.
+ * @return	true if spans are being recorded,
+ *			false otherwise.
+ */
+bool wima_trace_enabled(void);
+
+/**
+ * Writes all spans recorded so far, on all threads, to
+ * the path given to @a wima_trace_start(). Recording
+ * continues while, and after, the trace is written.
+ * @return	WIMA_STATUS_SUCCESS on success, an
+ *			error code otherwise.
+ * @pre		Wima must be initialized.
+ */
+WimaStatus wima_trace_write(void);
+
 /**
  * @}
  */
@@ -46,7 +46,6 @@ extern "C" {
 
 #include <KHR/khrplatform.h>
 #include <dyna/string.h>
-#include <dyna/tree.h>
 #include <dyna/vector.h>
 #include <glad/glad.h>
 
@@ -257,10 +256,9 @@ typedef uint8_t WimaDialog;
  */
 
 /**
- * A handle to a node. This is to make the node size
- * smaller than the 64 bits that Dyna uses. I am pretty
- * sure that nothing will go over the limit, so I feel
- * comfortable doing this.
+ * A handle to a node in an area tree. Nodes are
+ * kept in a pool, so the limit is on the number
+ * of areas in a tree, not on how deep it is.
  */
 typedef uint16_t WimaAreaNode;
 
@@ -302,7 +300,7 @@ typedef struct WimaArea
  * @def WIMA_WIDGET_INVALID
  * A handle indicating an invalid widget.
  */
-#define WIMA_WIDGET_INVALID ((uint16_t) -1)
+#define WIMA_WIDGET_INVALID ((uint32_t) -1)
 
 /**
  * @def WIMA_WIDGET_MAX
@@ -315,8 +313,9 @@ typedef struct WimaArea
  */
 typedef struct WimaWidget
 {
-	/// A handle to the widget itself.
-	uint16_t widget;
+	/// A handle to the widget itself. This is
+	/// its index in the region's items.
+	uint32_t widget;
 
 	/// The area that the widget is in.
 	WimaAreaNode area;
@@ -719,6 +718,22 @@ typedef struct WimaCharEvent
 
 } WimaCharEvent;
 
+/**
+ * A user-defined event. These are posted with
+ * @a wima_window_postEvent() and delivered to
+ * the app's user event callback.
+ */
+typedef struct WimaUserEvent
+{
+	/// The type of the event. Wima does
+	/// not interpret this; the app does.
+	uint32_t type;
+
+	/// The data of the event.
+	void* data;
+
+} WimaUserEvent;
+
 /**
  * @}
  */
@@ -1454,6 +1469,28 @@ void* wima_widget_data(WimaWidget wdgt);
  */
 bool wima_widget_inOverlay(WimaWidget wdgt) yconst yinline;
 
+/**
+ * Sets whether @a wdgt receives every mouse position,
+ * drag, and scroll event. By default, consecutive
+ * events of those kinds are merged before they are
+ * dispatched: positions keep only the latest, and
+ * scroll offsets are summed. Widgets that need the
+ * full history (like a paint stroke) can opt out.
+ * @param wdgt	The widget to set.
+ * @param raw	true if the widget wants raw events,
+ *				false otherwise.
+ */
+void wima_widget_setRawEvents(WimaWidget wdgt, bool raw) yinline;
+
+/**
+ * Returns whether @a wdgt receives raw events,
+ * as set by @a wima_widget_setRawEvents().
+ * @param wdgt	The widget to query.
+ * @return		true if the widget wants raw
+ *				events, false otherwise.
+ */
+bool wima_widget_rawEvents(WimaWidget wdgt) yinline;
+
 /**
  * Sets whether the widget is enabled or not.
  * @param wdgt		The widget to enable or disable.
@@ -1937,6 +1974,32 @@ void wima_area_setScale(WimaArea wah, float scale) yinline;
  */
 float wima_area_scale(WimaArea wah) yinline;
 
+/**
+ * Tells Wima that what is drawn in @a wah has changed
+ * and needs to be redrawn. Only @a wah is redrawn, and
+ * if area caching is enabled on its window, its cache
+ * is redrawn as well.
+ * @param wah	The area to redraw.
+ * @pre			@a wah must be valid.
+ */
+void wima_area_refresh(WimaArea wah);
+
+/**
+ * Tells Wima that the widgets in @a wah need to be
+ * laid out again by calling its regions' layout
+ * functions. Normally, Wima keeps the widgets from
+ * the last layout and only moves and resizes them.
+ * They are only generated again when a property
+ * that the layout functions read changes, when
+ * the area's size changes a lot (if they read
+ * it with @a wima_area_rect()), or when this is
+ * called. Use this if they depend on anything else.
+ * @param wah	The area to invalidate.
+ * @pre			@a wah must be valid.
+ * @pre			@a wah must be a leaf area.
+ */
+void wima_area_invalidate(WimaArea wah);
+
 /**
  * Sets the type for @a wah. Areas are always
  * automatically created with a type, so this
@@ -2313,6 +2376,35 @@ void wima_window_disableHeader(WimaWindow wwh);
  */
 bool wima_window_headerEnabled(WimaWindow wwh);
 
+/**
+ * Enables area caching on the given window. When it is
+ * enabled, every leaf area is drawn into its own texture,
+ * and that texture is only redrawn when the area's size,
+ * scale, layout, or contents change, or when the theme
+ * changes. This makes drawing windows with many static
+ * areas faster at the cost of video memory.
+ * @param wwh	The window to enable caching on.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_window_enableAreaCache(WimaWindow wwh);
+
+/**
+ * Disables area caching on the given window.
+ * @param wwh	The window to disable caching on.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_window_disableAreaCache(WimaWindow wwh);
+
+/**
+ * Returns true if area caching is enabled on
+ * the given window, false otherwise.
+ * @param wwh	The window to query.
+ * @return		true if area caching is enabled
+ *				on @a wwh, false otherwise.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+bool wima_window_areaCacheEnabled(WimaWindow wwh);
+
 /**
  * Gives the current window focus.
  * @param wwh	The window to focus.
@@ -2589,6 +2681,100 @@ WimaWidget wima_window_focusWidget(WimaWindow wwh) yinline;
  */
 void wima_window_clearEvents(WimaWindow wwh) yinline;
 
+/**
+ * Posts a user-defined event to @a wwh and wakes up the
+ * event loop. The event is delivered to the app's user
+ * event callback on the main thread, in order with the
+ * window's other events.
+ *
+ * Unlike almost every other function, this one can be
+ * called from any thread. If the window is closed before
+ * the event is delivered, the event is dropped.
+ * @param wwh	The window to post the event to.
+ * @param event	The event to post.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+WimaStatus wima_window_postEvent(WimaWindow wwh, WimaUserEvent event);
+
+/**
+ * Gives @a wwh a key event as if it came from the platform.
+ * This is for driving windows in tests and benchmarks,
+ * usually headless ones. See @a wima_setHeadless().
+ * @param wwh	The window to give the event to.
+ * @param e		The event.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_window_injectKey(WimaWindow wwh, WimaKeyEvent e);
+
+/**
+ * Gives @a wwh a mouse button event as if it came from
+ * the platform. This is for driving windows in tests and
+ * benchmarks, usually headless ones.
+ * @param wwh	The window to give the event to.
+ * @param e		The event. Only one button may be set.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_window_injectMouseBtn(WimaWindow wwh, WimaMouseBtnEvent e);
+
+/**
+ * Gives @a wwh a mouse position event as if it came
+ * from the platform. This is for driving windows in
+ * tests and benchmarks, usually headless ones.
+ * @param wwh	The window to give the event to.
+ * @param pos	The new cursor position.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_window_injectMousePos(WimaWindow wwh, WimaVec pos);
+
+/**
+ * Gives @a wwh a scroll event as if it came from the
+ * platform. This is for driving windows in tests and
+ * benchmarks, usually headless ones.
+ * @param wwh	The window to give the event to.
+ * @param e		The event.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_window_injectScroll(WimaWindow wwh, WimaScrollEvent e);
+
+/**
+ * Gives @a wwh a char event as if it came from the
+ * platform. This is for driving windows in tests and
+ * benchmarks, usually headless ones.
+ * @param wwh	The window to give the event to.
+ * @param e		The event.
+ * @pre			@a wwh must be a valid WimaWindow.
+ */
+void wima_window_injectChar(WimaWindow wwh, WimaCharEvent e);
+
+/**
+ * Runs one frame of @a wwh without the main loop:
+ * processes its queued (and injected) events, then
+ * lays it out and draws it if necessary.
+ * @param wwh	The window to run a frame of.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ * @pre			@a wwh must be a valid, activated
+ *				WimaWindow.
+ */
+WimaStatus wima_window_step(WimaWindow wwh);
+
+/**
+ * Reads back what was last drawn on @a wwh. The
+ * pixels are RGBA, 8 bits per channel, tightly
+ * packed, with the bottom row first, and the size
+ * is given by @a wima_window_framebufferSize().
+ * @param wwh		The window to read.
+ * @param pixels	The array to read into. It must be
+ *					at least width * height * 4 bytes.
+ * @return			WIMA_STATUS_SUCCESS on success, an
+ *					error code otherwise.
+ * @pre				@a wwh must be a valid, activated
+ *					WimaWindow.
+ * @pre				@a pixels must not be NULL.
+ */
+WimaStatus wima_window_readPixels(WimaWindow wwh, uint8_t* pixels) yallnonnull;
+
 /**
  * Requests a refresh on @a wwh. The refresh will
  * happen the next time drawing happens, which is
@@ -2617,7 +2803,9 @@ bool wima_window_needsRefresh(WimaWindow wwh) yinline;
 
 /**
  * Requests layout on @a wwh. This will also force
- * a refresh.
+ * a refresh. Unlike the layout that Wima does on
+ * its own (when the window is resized, for example),
+ * this calls the layout functions of all regions.
  * @param wwh	The window to request layout on.
  * @pre			@a wwh must be a valid WimaWindow.
  */
@@ -3046,6 +3234,13 @@ typedef void (*WimaWindowFocusFunc)(WimaWindow window, bool focused);
  */
 typedef bool (*WimaWindowCloseFunc)(WimaWindow window);
 
+/**
+ * A callback type to handle user-defined events.
+ * @param window	The window that the event was posted to.
+ * @param event		The event.
+ */
+typedef void (*WimaWindowUserEventFunc)(WimaWindow window, WimaUserEvent event);
+
 /**
  * A callback type to handle monitor connection and
  * disconnection events.
@@ -3094,6 +3289,9 @@ typedef struct WimaAppFuncs
 	/// The app monitor connection callback.
 	WimaMonitorConnectedFunc monitor;
 
+	/// The app user event callback.
+	WimaWindowUserEventFunc user;
+
 } WimaAppFuncs;
 
 /**
@@ -3163,6 +3361,33 @@ WimaStatus wima_init(const char* name, WimaAppFuncs funcs, const char* fontPath,
  */
 WimaStatus wima_main();
 
+/**
+ * Sets whether or not windows are headless. Headless
+ * windows are never shown, never wait for the vertical
+ * blank, and never swap buffers; they only render into
+ * their framebuffer, which can be read back with @a
+ * wima_window_readPixels(). They are meant to be driven
+ * with @a wima_window_step() and synthetic input.
+ *
+ * When Wima is built with WIMA_HEADLESS, GLFW uses its
+ * OSMesa backend (no display server is needed), and
+ * this defaults to true. Otherwise, it defaults to
+ * false and windows still need a display server.
+ * @param headless	true if windows should be headless,
+ *					false otherwise.
+ * @pre				Wima must be initialized.
+ * @pre				No windows may have been created.
+ */
+void wima_setHeadless(bool headless);
+
+/**
+ * Returns whether or not windows are headless.
+ * See @a wima_setHeadless().
+ * @return	true if windows are headless,
+ *			false otherwise.
+ */
+bool wima_headless();
+
 /**
  * Terminates Wima and frees all resources.
  */
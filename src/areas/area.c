@@ -50,7 +50,6 @@
 #include "../windows/window.h"
 
 #include <dyna/nvector.h>
-#include <dyna/tree.h>
 #include <yc/assert.h>
 #include <yc/error.h>
 
@@ -59,6 +58,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+//! @cond Doxygen suppress.
+#include <nanovg.h>
+#include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
+//! @endcond Doxygen suppress.
+
 //! @cond Doxygen suppress.
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -73,7 +78,7 @@ WimaArea wima_area(WimaWindow wwh, WimaAreaNode node)
 
 #ifdef __YASSERT__
 	WimaWin* win = dvec_get(wg.windows, wwh);
-	wassert(dtree_exists(WIMA_WIN_AREAS(win), node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(WIMA_WIN_AREAS(win), node), WIMA_ASSERT_AREA);
 #endif
 
 	WimaArea wah;
@@ -103,6 +108,14 @@ WimaRect wima_area_rect(WimaArea wah)
 	WimaAr* area = wima_area_ptr(wah.window, wah.area);
 	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
 
+	// If a region of this area is being generated,
+	// it now depends on the area's size class.
+	if (wg.layoutRegion.region != WIMA_REGION_INVALID_IDX && wg.layoutRegion.window == wah.window &&
+	    wg.layoutRegion.area == wah.area)
+	{
+		area->area.regions[wg.layoutRegion.region].sized = true;
+	}
+
 	return area->rect;
 }
 
@@ -114,6 +127,7 @@ void wima_area_setScale(WimaArea wah, float scale)
 	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
 
 	area->area.scale = wima_fmaxf(scale, 0.1f);
+	area->area.cacheStale = true;
 }
 
 float wima_area_scale(WimaArea wah)
@@ -135,12 +149,39 @@ void wima_area_setType(WimaArea wah, WimaEditor type)
 
 	area->area.type = type;
 
+	wima_area_invalidateRegions(area);
+
 	wassert(wima_window_valid(wah.window), WIMA_ASSERT_WIN);
 
 	WimaWin* win = dvec_get(wg.windows, wah.window);
 	wima_window_setDirty(win, true);
 }
 
+void wima_area_refresh(WimaArea wah)
+{
+	wima_assert_init;
+
+	wassert(wima_window_valid(wah.window), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wah.window);
+	wima_window_damageArea(win, wah.area, false);
+}
+
+void wima_area_invalidate(WimaArea wah)
+{
+	wima_assert_init;
+
+	WimaAr* area = wima_area_ptr(wah.window, wah.area);
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+
+	wima_area_invalidateRegions(area);
+
+	wassert(wima_window_valid(wah.window), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wah.window);
+	wima_window_damageArea(win, wah.area, true);
+}
+
 WimaEditor wima_area_type(WimaArea wah)
 {
 	wima_assert_init;
@@ -158,7 +199,7 @@ int wima_area_numItems(WimaArea wah)
 	WimaAr* area = wima_area_ptr(wah.window, wah.area);
 	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
 
-	return dvec_len(area->area.items);
+	return wima_item_len(area->area.items);
 }
 
 bool wima_area_contains(WimaArea wah, WimaVec pos)
@@ -264,7 +305,7 @@ void wima_area_switchRegionSide(WimaArea wah, uint8_t region)
  * @param node	The node of the current area to process.
  * @param rect	The rectangle of the area.
  */
-static void wima_area_node_init(WimaWindow win, DynaTree areas, DynaNode node, WimaRect rect);
+static void wima_area_node_init(WimaWindow win, WimaArTree* areas, WimaAreaNode node, WimaRect rect);
 
 /**
  * A recursive function to check if the area tree is valid.
@@ -272,7 +313,7 @@ static void wima_area_node_init(WimaWindow win, DynaTree areas, DynaNode node, W
  * @param node		The current node to check.
  * @return			true if valid, false otherwise.
  */
-static bool wima_area_node_valid(DynaTree editors, DynaNode node);
+static bool wima_area_node_valid(WimaArTree* editors, WimaAreaNode node);
 
 /**
  * Recursive function to draw a tree of areas.
@@ -283,7 +324,43 @@ static bool wima_area_node_valid(DynaTree editors, DynaNode node);
  * @return		WIMA_STATUS_SUCCESS on success, an
  *				error code otherwise.
  */
-static WimaStatus wima_area_node_draw(WimaRenderContext* ctx, DynaTree areas, DynaNode node, WimaPropData* bg);
+static WimaStatus wima_area_node_draw(WimaRenderContext* ctx, WimaArTree* areas, WimaAreaNode node, WimaPropData* bg);
+
+/**
+ * Recursive function to draw the damaged areas in a tree.
+ * @param ctx	The context to render to.
+ * @param areas	The tree of areas to draw.
+ * @param node	The current node being drawn.
+ * @param bg	The data for the background color.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+static WimaStatus wima_area_node_drawDamaged(WimaRenderContext* ctx, WimaArTree* areas, WimaAreaNode node,
+                                             WimaPropData* bg);
+
+/**
+ * Recursive function to update the caches of a tree of areas.
+ * @param ctx			The context to render to.
+ * @param areas			The tree of areas to update.
+ * @param node			The current node being updated.
+ * @param bg			The data for the background color.
+ * @param pixelRatio	The pixel ratio of the window.
+ * @param enabled		Whether or not caches are enabled.
+ * @param force			If true, all caches are redrawn.
+ * @return				WIMA_STATUS_SUCCESS on success,
+ *						an error code otherwise.
+ */
+static WimaStatus wima_area_node_updateCache(WimaRenderContext* ctx, WimaArTree* areas, WimaAreaNode node,
+                                             WimaPropData* bg, float pixelRatio, bool enabled, bool force);
+
+/**
+ * Draws the contents of a leaf area (everything that
+ * can be cached) with the origin at the area's corner.
+ * @param ctx	The context to render to.
+ * @param area	The area to draw.
+ * @param bg	The data for the background color.
+ */
+static void wima_area_drawContents(WimaRenderContext* ctx, WimaAr* area, WimaPropData* bg);
 
 /**
  * Recursive function to resize a tree of areas.
@@ -293,17 +370,30 @@ static WimaStatus wima_area_node_draw(WimaRenderContext* ctx, DynaTree areas, Dy
  * @param adjustSplit	Whether or not the split should be moved.
  *						See @a wima_area_resize().
  */
-static void wima_area_node_resize(DynaTree areas, DynaNode node, WimaRect rect, bool adjustSplit);
+static void wima_area_node_resize(WimaArTree* areas, WimaAreaNode node, WimaRect rect, bool adjustSplit);
 
 /**
  * Recursive function to layout a tree of areas.
  * @param areas	The tree to layout.
  * @param node	The current node being laid out.
  * @param min	A pointer to store the min size in.
+ * @param regen	Whether to generate every region's
+ *				items again. See @a wima_area_layout().
  * @return		WIMA_STATUS_SUCCESS on success,
  *				an error code otherwise.
  */
-static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef* min);
+static WimaStatus wima_area_node_layout(WimaArTree* areas, WimaAreaNode node, WimaSizef* min, bool regen);
+
+/**
+ * Checks whether the items of @a region in @a area
+ * need to be generated again, or just reflowed.
+ * @param area		The area to check.
+ * @param region	The index of the region to check.
+ * @param sizeClass	The area's current size class.
+ * @return			true if the region is stale,
+ *					false otherwise.
+ */
+static bool wima_area_regionStale(WimaAr* area, uint8_t region, WimaSize sizeClass);
 
 /**
  * Recursive function to determine which area has the mouse.
@@ -312,7 +402,7 @@ static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef
  * @param cursor	The position of the cursor.
  * @return			The node that has the cursor, or WIMA_AREA_INVALID.
  */
-static WimaAreaNode wima_area_node_containsMouse(DynaTree areas, WimaAr* area, WimaVec cursor);
+static WimaAreaNode wima_area_node_containsMouse(WimaArTree* areas, WimaAr* area, WimaVec cursor);
 
 /**
  * A recursive function to test whether the mouse is on a split.
@@ -323,7 +413,7 @@ static WimaAreaNode wima_area_node_containsMouse(DynaTree areas, WimaAr* area, W
  *					mouse *is* on a split.
  * @return			true if the mouse is on a split, false otherwise.
  */
-static bool wima_area_node_mouseOnSplit(DynaTree areas, DynaNode node, WimaVec pos, WimaAreaSplit* result);
+static bool wima_area_node_mouseOnSplit(WimaArTree* areas, WimaAreaNode node, WimaVec pos, WimaAreaSplit* result);
 
 /**
  * A recursive function to move splits.
@@ -335,7 +425,7 @@ static bool wima_area_node_mouseOnSplit(DynaTree areas, DynaNode node, WimaVec p
  *					left area, false otherwise.
  * @param vertical	Whether the split was vertical or not.
  */
-static void wima_area_node_moveSplit(DynaTree areas, DynaNode node, int diff, bool left, bool vertical);
+static void wima_area_node_moveSplit(WimaArTree* areas, WimaAreaNode node, int diff, bool left, bool vertical);
 
 /**
  * A recursive function to determine the limit that a split can be moved.
@@ -347,7 +437,7 @@ static void wima_area_node_moveSplit(DynaTree areas, DynaNode node, int diff, bo
  * @param vertical	Whether the split was vertical or not.
  * @return			The limit that @a node's split can be moved.
  */
-static int wima_area_node_moveSplit_limit(DynaTree areas, DynaNode node, bool isLeft, bool vertical);
+static int wima_area_node_moveSplit_limit(WimaArTree* areas, WimaAreaNode node, bool isLeft, bool vertical);
 
 /**
  * A recursive function to find the widget under the mouse.
@@ -359,7 +449,61 @@ static int wima_area_node_moveSplit_limit(DynaTree areas, DynaNode node, bool is
  *				be returned.
  * @return		The widget at the pos, or WIMA_WIDGET_INVALID.
  */
-static WimaWidget wima_area_node_findWidget(DynaTree areas, WimaAr* area, WimaVec pos, uint32_t flags);
+static WimaWidget wima_area_node_findWidget(WimaArTree* areas, WimaAr* area, WimaVec pos, uint32_t flags);
+
+/**
+ * Rebuilds the hit-testing grid of a region
+ * after its layout has been calculated.
+ * @param area		The area with the region.
+ * @param region	The index of the region.
+ * @return			WIMA_STATUS_SUCCESS on success, an
+ *					error code otherwise.
+ */
+static WimaStatus wima_area_grid_build(WimaAr* area, uint8_t region);
+
+/**
+ * A recursive function to collect the enabled widgets
+ * under @a layout into @a grid's items.
+ * @param area		The area with the items.
+ * @param grid		The grid to collect into.
+ * @param layout	The index of the layout whose
+ *					children will be collected.
+ * @param x			The x coordinate of @a layout.
+ * @param y			The y coordinate of @a layout.
+ * @return			WIMA_STATUS_SUCCESS on success, an
+ *					error code otherwise.
+ */
+static WimaStatus wima_area_grid_collect(WimaAr* area, WimaArGrid* grid, uint32_t layout, float x, float y);
+
+/**
+ * Finds the first widget in @a grid that contains the
+ * given position and matches @a flags.
+ * @param grid	The grid to search.
+ * @param x		The x coordinate to test.
+ * @param y		The y coordinate to test.
+ * @param flags	The flags that the widget must match.
+ * @return		The widget, or NULL if none.
+ */
+static WimaArGridItem* wima_area_grid_find(WimaArGrid* grid, float x, float y, uint32_t flags);
+
+/**
+ * Frees the hit-testing grids of @a area.
+ * @param area	The area whose grids will be freed.
+ */
+static void wima_area_grid_free(WimaAr* area);
+
+/**
+ * Frees the memory used by a virtual list's state.
+ * This is a DynaDestructFunc.
+ * @param ptr	The list state to free.
+ */
+static void wima_area_list_destroy(void* ptr);
+
+/**
+ * Frees the virtual list states of @a area.
+ * @param area	The area whose list states will be freed.
+ */
+static void wima_area_list_free(WimaAr* area);
 
 /**
  * Fills the two given rectangles with the
@@ -426,28 +570,29 @@ WimaAr* wima_area_ptr(WimaWindow wwh, WimaAreaNode node)
 
 	WimaWin* win = dvec_get(wg.windows, wwh);
 
-	wassert(dtree_exists(WIMA_WIN_AREAS(win), node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(WIMA_WIN_AREAS(win), node), WIMA_ASSERT_AREA);
 
-	return dtree_node(WIMA_WIN_AREAS(win), node);
+	return wima_area_tree_node(WIMA_WIN_AREAS(win), node);
 }
 
-WimaStatus wima_area_init(WimaWindow win, DynaTree areas, WimaRect rect, WimaSizef* min)
+WimaStatus wima_area_init(WimaWindow win, WimaArTree* areas, WimaRect rect, WimaSizef* min)
 {
 	wima_assert_init;
 	wassert(areas, WIMA_ASSERT_WIN_AREAS);
-	wima_area_node_init(win, areas, dtree_root(), rect);
-	return wima_area_node_layout(areas, dtree_root(), min);
+	wima_area_node_init(win, areas, WIMA_AREA_TREE_ROOT, rect);
+	return wima_area_node_layout(areas, WIMA_AREA_TREE_ROOT, min, true);
 }
 
-static void wima_area_node_init(WimaWindow win, DynaTree areas, DynaNode node, WimaRect rect)
+static void wima_area_node_init(WimaWindow win, WimaArTree* areas, WimaAreaNode node, WimaRect rect)
 {
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	area->node = node;
 	area->rect = rect;
 	area->window = win;
+	area->damaged = false;
 
 	if (WIMA_AREA_IS_PARENT(area))
 	{
@@ -459,8 +604,8 @@ static void wima_area_node_init(WimaWindow win, DynaTree areas, DynaNode node, W
 
 		wima_area_childrenRects(area, &left, &right);
 
-		wima_area_node_init(win, areas, dtree_left(node), left);
-		wima_area_node_init(win, areas, dtree_right(node), right);
+		wima_area_node_init(win, areas, wima_area_tree_left(areas, node), left);
+		wima_area_node_init(win, areas, wima_area_tree_right(areas, node), right);
 	}
 	else
 	{
@@ -501,6 +646,29 @@ WimaStatus wima_area_setup(WimaAr* area, bool allocate)
 
 	WimaStatus status = WIMA_STATUS_SUCCESS;
 
+	area->area.cache = NULL;
+	area->area.cacheStale = true;
+
+	area->area.hit.widget = WIMA_WIDGET_INVALID;
+
+	// Nothing has been generated yet.
+	wima_area_invalidateRegions(area);
+
+	// The grids and lists are allocated on the first layout.
+	for (uint8_t i = 0; i < area->area.numRegions; ++i)
+	{
+		WimaArGrid* grid = &area->area.regions[i].grid;
+
+		grid->items = NULL;
+		grid->cells = NULL;
+		grid->refs = NULL;
+		grid->cols = grid->rows = 0;
+
+		area->area.regions[i].lists = NULL;
+		area->area.regions[i].numLists = 0;
+		area->area.regions[i].building = WIMA_ITEM_LIST_INVALID;
+	}
+
 	// If we don't need to allocate, set NULL and return happy.
 	// We also don't even need to set up the user pointer.
 	if (!allocate)
@@ -510,48 +678,51 @@ WimaStatus wima_area_setup(WimaAr* area, bool allocate)
 		return WIMA_STATUS_SUCCESS;
 	}
 
-	area->area.items = dvec_create(0, sizeof(WimaItem), wima_item_free, NULL);
+	area->area.items = wima_item_store_create(wima_item_free);
 	if (yerror(!area->area.items)) return WIMA_STATUS_MALLOC_ERR;
 
 	area->area.widgetData = dpool_create(0.9f, sizeof(uint64_t), NULL, NULL, NULL);
 	if (yerror(!area->area.widgetData))
 	{
-		dvec_free(area->area.items);
+		wima_item_store_free(area->area.items);
 		return WIMA_STATUS_MALLOC_ERR;
 	}
 
 	return status;
 }
 
-bool wima_area_valid(DynaTree editors)
+bool wima_area_valid(WimaArTree* editors)
 {
 	wima_assert_init;
 	wassert(editors, WIMA_ASSERT_WIN_AREAS);
-	return wima_area_node_valid(editors, dtree_root());
+	return wima_area_node_valid(editors, WIMA_AREA_TREE_ROOT);
 }
 
-static bool wima_area_node_valid(DynaTree editors, DynaNode node)
+static bool wima_area_node_valid(WimaArTree* editors, WimaAreaNode node)
 {
-	wassert(dtree_exists(editors, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(editors, node), WIMA_ASSERT_AREA);
 
 	bool result = true;
 
-	WimaAr* area = dtree_node(editors, node);
+	WimaAr* area = wima_area_tree_node(editors, node);
 
 	if (WIMA_AREA_IS_PARENT(area))
 	{
 		// Make sure a parent has both left and right children.
 		// A parent ***MUST*** have both children because otherwise
 		// you may as well just set an area.
-		result = dtree_hasLeft(editors, node) && dtree_hasRight(editors, node) &&
-		         wima_area_node_valid(editors, dtree_left(node)) && wima_area_node_valid(editors, dtree_right(node));
+		result = wima_area_tree_left(editors, node) != WIMA_AREA_INVALID &&
+		         wima_area_tree_right(editors, node) != WIMA_AREA_INVALID &&
+		         wima_area_node_valid(editors, wima_area_tree_left(editors, node)) &&
+		         wima_area_node_valid(editors, wima_area_tree_right(editors, node));
 	}
 	else
 	{
 		// Make sure the node does ***NOT*** have children.
 		// Actual areas should never have children because
 		// that kind of defeats the purpose.
-		result = !(dtree_hasLeft(editors, node) || dtree_hasRight(editors, node));
+		result = wima_area_tree_left(editors, node) == WIMA_AREA_INVALID &&
+		         wima_area_tree_right(editors, node) == WIMA_AREA_INVALID;
 	}
 
 	return result;
@@ -563,7 +734,12 @@ void wima_area_destroy(void* ptr)
 
 	if (WIMA_AREA_IS_PARENT(area)) return;
 
-	if (area->area.items && area->area.items != WIMA_PTR_INVALID) dvec_free(area->area.items);
+	if (area->area.cache) nvgluDeleteFramebuffer(area->area.cache);
+
+	wima_area_grid_free(area);
+	wima_area_list_free(area);
+
+	if (area->area.items && area->area.items != WIMA_PTR_INVALID) wima_item_store_free(area->area.items);
 
 	if (area->area.widgetData)
 	{
@@ -614,7 +790,7 @@ void wima_area_mouseEnter(WimaAr* area, bool enter)
 	if (mouse_enter) mouse_enter(wima_area(area->window, area->node), enter);
 }
 
-WimaStatus wima_area_draw(WimaRenderContext* ctx, DynaTree areas)
+WimaStatus wima_area_draw(WimaRenderContext* ctx, WimaArTree* areas)
 {
 	wima_assert_init;
 
@@ -623,74 +799,210 @@ WimaStatus wima_area_draw(WimaRenderContext* ctx, DynaTree areas)
 
 	WimaPropData* bg = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wg.themes[WIMA_THEME_BG]);
 
-	return wima_area_node_draw(ctx, areas, dtree_root(), bg);
+	return wima_area_node_draw(ctx, areas, WIMA_AREA_TREE_ROOT, bg);
 }
 
-static WimaStatus wima_area_node_draw(WimaRenderContext* ctx, DynaTree areas, DynaNode node, WimaPropData* bg)
+static WimaStatus wima_area_node_draw(WimaRenderContext* ctx, WimaArTree* areas, WimaAreaNode node, WimaPropData* bg)
 {
 	wima_assert_init;
 
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
 	WimaStatus status;
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
+
+	area->damaged = false;
 
 	if (WIMA_AREA_IS_PARENT(area))
 	{
-		status = wima_area_node_draw(ctx, areas, dtree_left(node), bg);
+		status = wima_area_node_draw(ctx, areas, wima_area_tree_left(areas, node), bg);
 		if (yerror(status)) return status;
 
-		status = wima_area_node_draw(ctx, areas, dtree_right(node), bg);
+		status = wima_area_node_draw(ctx, areas, wima_area_tree_right(areas, node), bg);
 	}
 	else
 	{
 		wima_area_pushViewport(ctx->nvg, area->rect);
 
-		wima_area_background(area, ctx->nvg, bg);
+		if (area->area.cache)
+		{
+			// The cache is already up to date, so just composite it.
+			NVGpaint paint = nvgImagePattern(ctx->nvg, 0.0f, 0.0f, area->rect.w, area->rect.h, 0.0f,
+			                                 area->area.cache->image, 1.0f);
+
+			nvgBeginPath(ctx->nvg);
+			nvgRect(ctx->nvg, 0.0f, 0.0f, area->rect.w, area->rect.h);
+			nvgFillPaint(ctx->nvg, paint);
+			nvgFill(ctx->nvg);
+		}
+		else
+		{
+			wima_area_drawContents(ctx, area, bg);
+		}
+
+		// These are not cached because they are cheap, and
+		// they are the only things that change with splits.
+		wima_area_drawSplitWidgets(area, ctx->nvg);
+		wima_area_drawBorders(area, ctx->nvg);
+
+		wima_area_popViewport(ctx->nvg);
+
+		status = WIMA_STATUS_SUCCESS;
+	}
+
+	return status;
+}
+
+WimaStatus wima_area_drawDamaged(WimaRenderContext* ctx, WimaArTree* areas)
+{
+	wima_assert_init;
 
-		if (dvec_len(area->area.items))
+	wassert(areas, WIMA_ASSERT_WIN_AREAS);
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	WimaPropData* bg = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wg.themes[WIMA_THEME_BG]);
+
+	return wima_area_node_drawDamaged(ctx, areas, WIMA_AREA_TREE_ROOT, bg);
+}
+
+static WimaStatus wima_area_node_drawDamaged(WimaRenderContext* ctx, WimaArTree* areas, WimaAreaNode node,
+                                             WimaPropData* bg)
+{
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
+
+	WimaAr* area = wima_area_tree_node(areas, node);
+
+	// A damaged node is redrawn completely, children and all.
+	// The clear is needed for parents because the gaps between
+	// their children (the splits) are not covered by anything.
+	if (area->damaged)
+	{
+		WimaWin* win = dvec_get(wg.windows, area->window);
+		wima_window_clearRect(win, area->rect);
+
+		return wima_area_node_draw(ctx, areas, node, bg);
+	}
+
+	if (WIMA_AREA_IS_LEAF(area)) return WIMA_STATUS_SUCCESS;
+
+	WimaStatus status = wima_area_node_drawDamaged(ctx, areas, wima_area_tree_left(areas, node), bg);
+	if (yerror(status)) return status;
+
+	return wima_area_node_drawDamaged(ctx, areas, wima_area_tree_right(areas, node), bg);
+}
+
+WimaStatus wima_area_updateCaches(WimaRenderContext* ctx, WimaArTree* areas, float pixelRatio, bool enabled, bool force)
+{
+	wima_assert_init;
+
+	wassert(areas, WIMA_ASSERT_WIN_AREAS);
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	WimaPropData* bg = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wg.themes[WIMA_THEME_BG]);
+
+	WimaStatus status = wima_area_node_updateCache(ctx, areas, WIMA_AREA_TREE_ROOT, bg, pixelRatio, enabled, force);
+
+	nvgluBindFramebuffer(NULL);
+
+	return status;
+}
+
+static WimaStatus wima_area_node_updateCache(WimaRenderContext* ctx, WimaArTree* areas, WimaAreaNode node,
+                                             WimaPropData* bg, float pixelRatio, bool enabled, bool force)
+{
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
+
+	WimaAr* area = wima_area_tree_node(areas, node);
+
+	if (WIMA_AREA_IS_PARENT(area))
+	{
+		WimaAreaNode left = wima_area_tree_left(areas, node);
+		WimaAreaNode right = wima_area_tree_right(areas, node);
+
+		WimaStatus status =
+		    wima_area_node_updateCache(ctx, areas, left, bg, pixelRatio, enabled, force || area->damaged);
+		if (yerror(status)) return status;
+
+		return wima_area_node_updateCache(ctx, areas, right, bg, pixelRatio, enabled, force || area->damaged);
+	}
+
+	if (!enabled)
+	{
+		if (area->area.cache)
 		{
-			wima_render_save(ctx);
+			nvgluDeleteFramebuffer(area->area.cache);
+			area->area.cache = NULL;
+		}
 
-			nvgScale(ctx->nvg, area->area.scale, area->area.scale);
+		return WIMA_STATUS_SUCCESS;
+	}
+
+	int w = (int) ceilf(area->rect.w * pixelRatio);
+	int h = (int) ceilf(area->rect.h * pixelRatio);
 
-			WimaItem* item = dvec_get(area->area.items, 0);
+	bool stale = force || area->damaged || area->area.cacheStale || area->area.cacheTheme != wg.themeVersion;
 
-			item->rect.x = 0;
-			item->rect.y = 0;
-			item->rect.w = area->rect.w;
-			item->rect.h = area->rect.h;
+	if (area->area.cache)
+	{
+		int cw, ch;
 
-			// TODO: Draw each region.
+		nvgImageSize(ctx->nvg, area->area.cache->image, &cw, &ch);
 
-			// Restore the old render state.
-			wima_render_restore(ctx);
+		if (cw != w || ch != h)
+		{
+			nvgluDeleteFramebuffer(area->area.cache);
+			area->area.cache = NULL;
 		}
+	}
 
-		wima_area_drawSplitWidgets(area, ctx->nvg);
-		wima_area_drawBorders(area, ctx->nvg);
+	if (!area->area.cache)
+	{
+		// NanoVG's images are upside down compared to GL's
+		// framebuffers, and NanoVG draws premultiplied colors.
+		int flags = NVG_IMAGE_FLIPY | NVG_IMAGE_PREMULTIPLIED;
 
-		wima_area_popViewport(ctx->nvg);
+		area->area.cache = nvgluCreateFramebuffer(ctx->nvg, w, h, flags);
+		if (yerror(!area->area.cache)) return WIMA_STATUS_OPENGL_ERR;
 
-		status = WIMA_STATUS_SUCCESS;
+		stale = true;
 	}
 
-	return status;
+	if (!stale) return WIMA_STATUS_SUCCESS;
+
+	nvgluBindFramebuffer(area->area.cache);
+
+	glViewport(0, 0, w, h);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	nvgBeginFrame(ctx->nvg, area->rect.w, area->rect.h, pixelRatio);
+
+	wima_area_drawContents(ctx, area, bg);
+
+	wima_icon_atlas_upload(ctx);
+
+	nvgEndFrame(ctx->nvg);
+
+	area->area.cacheTheme = wg.themeVersion;
+	area->area.cacheStale = false;
+
+	return WIMA_STATUS_SUCCESS;
 }
 
-void wima_area_resize(DynaTree areas, WimaRect rect)
+void wima_area_resize(WimaArTree* areas, WimaRect rect)
 {
 	wima_assert_init;
 	wassert(areas, WIMA_ASSERT_WIN_AREAS);
-	wima_area_node_resize(areas, dtree_root(), rect, true);
+	wima_area_node_resize(areas, WIMA_AREA_TREE_ROOT, rect, true);
 }
 
-static void wima_area_node_resize(DynaTree areas, DynaNode node, WimaRect rect, bool adjustSplit)
+static void wima_area_node_resize(WimaArTree* areas, WimaAreaNode node, WimaRect rect, bool adjustSplit)
 {
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	area->rect = rect;
 
@@ -715,8 +1027,8 @@ static void wima_area_node_resize(DynaTree areas, DynaNode node, WimaRect rect,
 
 	wima_area_childrenRects(area, &left, &right);
 
-	wima_area_node_resize(areas, dtree_left(node), left, adjustSplit);
-	wima_area_node_resize(areas, dtree_right(node), right, adjustSplit);
+	wima_area_node_resize(areas, wima_area_tree_left(areas, node), left, adjustSplit);
+	wima_area_node_resize(areas, wima_area_tree_right(areas, node), right, adjustSplit);
 }
 
 WimaStatus wima_area_layoutHeader(WimaLayout root)
@@ -744,7 +1056,11 @@ WimaStatus wima_area_layoutHeader(WimaLayout root)
 
 		WimaLayout row = wima_layout_row(root, true);
 
+		uint64_t span = wima_trace_begin();
+
 		status = layout(row);
+
+		wima_trace_end(span, "region: header layout", area->area.type);
 	}
 	else
 	{
@@ -754,18 +1070,25 @@ WimaStatus wima_area_layoutHeader(WimaLayout root)
 	return status;
 }
 
-WimaStatus wima_area_layout(DynaTree areas, WimaSizef* min)
+WimaStatus wima_area_layout(WimaArTree* areas, WimaSizef* min, bool regen)
 {
 	wima_assert_init;
 	wassert(areas, WIMA_ASSERT_WIN_AREAS);
-	return wima_area_node_layout(areas, dtree_root(), min);
+	return wima_area_node_layout(areas, WIMA_AREA_TREE_ROOT, min, regen);
+}
+
+void wima_area_invalidateRegions(WimaAr* area)
+{
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+
+	for (uint8_t i = 0; i < WIMA_EDITOR_MAX_MAX_REGIONS; ++i) area->area.regions[i].stale = true;
 }
 
-static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef* min)
+static WimaStatus wima_area_node_layout(WimaArTree* areas, WimaAreaNode node, WimaSizef* min, bool regen)
 {
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	WimaStatus status;
 
@@ -774,10 +1097,10 @@ static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef
 		WimaSizef lmin, rmin;
 		float ldim, rdim;
 
-		status = wima_area_node_layout(areas, dtree_left(node), &lmin);
+		status = wima_area_node_layout(areas, wima_area_tree_left(areas, node), &lmin, regen);
 		if (yerror(status)) return status;
 
-		status = wima_area_node_layout(areas, dtree_right(node), &rmin);
+		status = wima_area_node_layout(areas, wima_area_tree_right(areas, node), &rmin, regen);
 		if (yerror(status)) return status;
 
 		if (area->parent.vertical)
@@ -810,21 +1133,34 @@ static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef
 	}
 	else
 	{
-		if (yerror(dvec_setLength(area->area.items, 0))) return WIMA_STATUS_MALLOC_ERR;
-
-		WimaArea wah;
-		wah.area = node;
-		wah.window = area->window;
-
-		WimaSize size;
-		size.w = area->rect.w;
-		size.h = area->rect.h;
-
 		wassert(area->area.type < dvec_len(wg.editors), WIMA_ASSERT_EDITOR);
 
 		WimaEdtr* edtr = dvec_get(wg.editors, area->area.type);
 		uint8_t numRegions = edtr->numRegions;
 
+		WimaSize sizeClass;
+		sizeClass.w = area->rect.w >> WIMA_AREA_SIZE_CLASS_SHIFT;
+		sizeClass.h = area->rect.h >> WIMA_AREA_SIZE_CLASS_SHIFT;
+
+		// All regions share the item vector, in order, so
+		// when a region is stale, it and all of the regions
+		// after it are generated again. The ones before it
+		// keep their items and are only reflowed.
+		uint8_t first = 0;
+		while (!regen && first < numRegions && !wima_area_regionStale(area, first, sizeClass)) ++first;
+
+		uint32_t len;
+
+		if (!first)
+			len = 0;
+		else if (first < numRegions)
+			len = area->area.regions[first].root.layout;
+		else
+			len = wima_item_len(area->area.items);
+
+		status = wima_item_setLength(area->area.items, len);
+		if (yerror(status)) return status;
+
 		WimaLayout parent;
 		parent.layout = WIMA_LAYOUT_INVALID;
 		parent.area = node;
@@ -853,21 +1189,55 @@ static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef
 
 			WimaReg* reg = dvec_get(wg.regions, region);
 
-			bool vScroll = WIMA_REG_CAN_SCROLL_VERTICAL(reg) != 0;
-			bool hScroll = WIMA_REG_CAN_SCROLL_HORIZONTAL(reg) != 0;
-			bool vertical = WIMA_REG_IS_VERTICAL(reg) != 0;
-			uint16_t flags = initialFlags;
-			flags |= (WIMA_LAYOUT_FLAG_SCROLL_VER * vScroll) | (WIMA_LAYOUT_FLAG_SCROLL_HOR * hScroll);
-			flags |= (WIMA_LAYOUT_FLAG_FILL_VER * vertical) | (WIMA_LAYOUT_FLAG_FILL_HOR * !vertical);
-			flags |= WIMA_REG_IS_ROW(reg) ? WIMA_LAYOUT_FLAG_ROW : WIMA_LAYOUT_FLAG_COL;
-
-			area->area.regions[i].root = wima_layout_new(parent, flags, 0.0f);
+			WimaArReg* areg = area->area.regions + i;
 
-			status = reg->layout(area->area.regions[i].root);
-			if (yerror(status)) return status;
+			if (i >= first)
+			{
+				bool vScroll = WIMA_REG_CAN_SCROLL_VERTICAL(reg) != 0;
+				bool hScroll = WIMA_REG_CAN_SCROLL_HORIZONTAL(reg) != 0;
+				bool vertical = WIMA_REG_IS_VERTICAL(reg) != 0;
+				uint16_t flags = initialFlags;
+				flags |= (WIMA_LAYOUT_FLAG_SCROLL_VER * vScroll) | (WIMA_LAYOUT_FLAG_SCROLL_HOR * hScroll);
+				flags |= (WIMA_LAYOUT_FLAG_FILL_VER * vertical) | (WIMA_LAYOUT_FLAG_FILL_HOR * !vertical);
+				flags |= WIMA_REG_IS_ROW(reg) ? WIMA_LAYOUT_FLAG_ROW : WIMA_LAYOUT_FLAG_COL;
+
+				areg->root = wima_layout_new(parent, flags, 0.0f);
+
+				// Record what the items are generated from before
+				// calling the layout. While it runs, the props that
+				// it reads are linked to the region, and reading the
+				// area's size sets sized, so that only changes to
+				// those make the region stale.
+				areg->sizeClass = sizeClass;
+				areg->sized = false;
+				areg->stale = false;
+				areg->numLists = 0;
+				areg->building = WIMA_ITEM_LIST_INVALID;
+
+				wg.layoutRegion.window = area->window;
+				wg.layoutRegion.area = node;
+				wg.layoutRegion.region = i;
+
+				uint64_t span = wima_trace_begin();
+
+				status = reg->layout(areg->root);
+
+				wima_trace_end(span, "region: layout", region);
+
+				wg.layoutRegion.region = WIMA_REGION_INVALID_IDX;
+
+				if (yerror(status))
+				{
+					areg->stale = true;
+					return status;
+				}
+
+				// The region's items are all in now,
+				// so its children can be put in spans.
+				wima_item_finish(area->area.items, areg->root.layout);
+			}
 
-			WimaItem* item = wima_layout_ptr(area->area.regions[i].root);
-			WimaSizef size = wima_layout_size(item);
+			WimaSizef size = wima_layout_size(areg->root);
 
 			WimaRectf regRect;
 			float width, height;
@@ -907,7 +1277,7 @@ static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef
 				prev.h += temp.h;
 			}
 
-			item->rect = regRect;
+			area->area.items->rects[areg->root.layout] = regRect;
 		}
 
 		temp = *min;
@@ -917,23 +1287,30 @@ static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef
 
 		for (uint8_t i = 0; i < numRegions; ++i)
 		{
-			WimaItem* item = wima_layout_ptr(area->area.regions[i].root);
+			WimaLayout root = area->area.regions[i].root;
+			WimaRectf* rect = area->area.items->rects + root.layout;
 
-			if (item->layout.flags & WIMA_LAYOUT_FLAG_FILL_VER)
+			if (area->area.items->flags[root.layout] & WIMA_LAYOUT_FLAG_FILL_VER)
 			{
-				item->rect.h = temp.h;
-				temp.w -= item->rect.w;
+				rect->h = temp.h;
+				temp.w -= rect->w;
 			}
 			else
 			{
-				item->rect.w = temp.w;
-				temp.h -= item->rect.h;
+				rect->w = temp.w;
+				temp.h -= rect->h;
 			}
 
-			status = wima_layout_layout(item);
+			status = wima_layout_layout(root);
+			if (yerror(status)) return status;
+
+			status = wima_area_grid_build(area, i);
 			if (yerror(status)) return status;
 		}
 
+		// The old hit is stale now.
+		area->area.hit.widget = WIMA_WIDGET_INVALID;
+
 		min->w *= area->area.scale;
 		min->h *= area->area.scale;
 	}
@@ -947,29 +1324,40 @@ static WimaStatus wima_area_node_layout(DynaTree areas, DynaNode node, WimaSizef
 	return status;
 }
 
-WimaAreaNode wima_area_mouseOver(DynaTree areas, WimaVec cursor)
+static bool wima_area_regionStale(WimaAr* area, uint8_t region, WimaSize sizeClass)
+{
+	WimaArReg* reg = area->area.regions + region;
+
+	if (reg->stale) return true;
+
+	// Props that the region read mark it stale
+	// themselves when they change. See wima_prop_touch().
+	return reg->sized && (reg->sizeClass.w != sizeClass.w || reg->sizeClass.h != sizeClass.h);
+}
+
+WimaAreaNode wima_area_mouseOver(WimaArTree* areas, WimaVec cursor)
 {
 	wima_assert_init;
 	wassert(areas, WIMA_ASSERT_WIN_AREAS);
 
-	DynaNode root = dtree_root();
+	WimaAreaNode root = WIMA_AREA_TREE_ROOT;
 
-	wassert(dtree_exists(areas, root), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, root), WIMA_ASSERT_AREA);
 
-	return wima_area_node_containsMouse(areas, dtree_node(areas, root), cursor);
+	return wima_area_node_containsMouse(areas, wima_area_tree_node(areas, root), cursor);
 }
 
-static WimaAreaNode wima_area_node_containsMouse(DynaTree areas, WimaAr* area, WimaVec cursor)
+static WimaAreaNode wima_area_node_containsMouse(WimaArTree* areas, WimaAr* area, WimaVec cursor)
 {
 	WimaAreaNode result;
 
 	if (WIMA_AREA_IS_PARENT(area))
 	{
-		DynaNode leftNode = dtree_left(area->node);
+		WimaAreaNode leftNode = wima_area_tree_left(areas, area->node);
 
-		wassert(dtree_exists(areas, leftNode), WIMA_ASSERT_AREA);
+		wassert(wima_area_tree_exists(areas, leftNode), WIMA_ASSERT_AREA);
 
-		WimaAr* left = dtree_node(areas, leftNode);
+		WimaAr* left = wima_area_tree_node(areas, leftNode);
 
 		if (wima_rect_contains(left->rect, cursor))
 		{
@@ -977,11 +1365,11 @@ static WimaAreaNode wima_area_node_containsMouse(DynaTree areas, WimaAr* area, W
 		}
 		else
 		{
-			DynaNode rightNode = dtree_right(area->node);
+			WimaAreaNode rightNode = wima_area_tree_right(areas, area->node);
 
-			wassert(dtree_exists(areas, rightNode), WIMA_ASSERT_AREA);
+			wassert(wima_area_tree_exists(areas, rightNode), WIMA_ASSERT_AREA);
 
-			WimaAr* right = dtree_node(areas, rightNode);
+			WimaAr* right = wima_area_tree_node(areas, rightNode);
 
 			// If the right rect has the cursor, send the operation
 			// there. Otherwise, return WIMA_AREA_INVALID, so we know
@@ -1001,18 +1389,18 @@ static WimaAreaNode wima_area_node_containsMouse(DynaTree areas, WimaAr* area, W
 	return result;
 }
 
-bool wima_area_mouseOnSplit(DynaTree areas, WimaVec pos, WimaAreaSplit* result)
+bool wima_area_mouseOnSplit(WimaArTree* areas, WimaVec pos, WimaAreaSplit* result)
 {
 	wima_assert_init;
 	wassert(areas, WIMA_ASSERT_WIN_AREAS);
-	return wima_area_node_mouseOnSplit(areas, dtree_root(), pos, result);
+	return wima_area_node_mouseOnSplit(areas, WIMA_AREA_TREE_ROOT, pos, result);
 }
 
-static bool wima_area_node_mouseOnSplit(DynaTree areas, DynaNode node, WimaVec pos, WimaAreaSplit* result)
+static bool wima_area_node_mouseOnSplit(WimaArTree* areas, WimaAreaNode node, WimaVec pos, WimaAreaSplit* result)
 {
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	if (WIMA_AREA_IS_LEAF(area)) return false;
 
@@ -1036,8 +1424,8 @@ static bool wima_area_node_mouseOnSplit(DynaTree areas, DynaNode node, WimaVec p
 
 	if (!on)
 	{
-		DynaNode leftNode = dtree_left(node);
-		WimaAr* left = dtree_node(areas, leftNode);
+		WimaAreaNode leftNode = wima_area_tree_left(areas, node);
+		WimaAr* left = wima_area_tree_node(areas, leftNode);
 
 		if (wima_rect_contains(left->rect, pos))
 		{
@@ -1045,8 +1433,8 @@ static bool wima_area_node_mouseOnSplit(DynaTree areas, DynaNode node, WimaVec p
 		}
 		else
 		{
-			DynaNode rightNode = dtree_right(node);
-			WimaAr* right = dtree_node(areas, rightNode);
+			WimaAreaNode rightNode = wima_area_tree_right(areas, node);
+			WimaAr* right = wima_area_tree_node(areas, rightNode);
 
 			if (wima_rect_contains(right->rect, pos)) on = wima_area_node_mouseOnSplit(areas, rightNode, pos, result);
 		}
@@ -1062,13 +1450,13 @@ static bool wima_area_node_mouseOnSplit(DynaTree areas, DynaNode node, WimaVec p
 	return on;
 }
 
-void wima_area_moveSplit(DynaTree areas, DynaNode node, WimaAreaSplit split, WimaVec cursor)
+void wima_area_moveSplit(WimaArTree* areas, WimaAreaNode node, WimaAreaSplit split, WimaVec cursor)
 {
 	wima_assert_init;
 
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	WimaVec pos = wima_area_translatePos(area, cursor);
 
@@ -1076,7 +1464,7 @@ void wima_area_moveSplit(DynaTree areas, DynaNode node, WimaAreaSplit split, Wim
 
 	bool isLeft = diff < 0;
 
-	DynaNode child = isLeft ? dtree_left(node) : dtree_right(node);
+	WimaAreaNode child = isLeft ? wima_area_tree_left(areas, node) : wima_area_tree_right(areas, node);
 
 	int limit = wima_area_node_moveSplit_limit(areas, child, diff < 0, split.vertical);
 	limit = isLeft && limit != 0 ? -limit : limit;
@@ -1089,22 +1477,27 @@ void wima_area_moveSplit(DynaTree areas, DynaNode node, WimaAreaSplit split, Wim
 	float dim = (float) (area->rect.v[!split.vertical + 2] - 1);
 	area->parent.split = (float) area->parent.spliti / dim;
 
-	DynaNode leftNode = dtree_left(node);
-	DynaNode rightNode = dtree_right(node);
+	WimaAreaNode leftNode = wima_area_tree_left(areas, node);
+	WimaAreaNode rightNode = wima_area_tree_right(areas, node);
 
 	wima_area_node_moveSplit(areas, leftNode, diff, true, split.vertical);
 	wima_area_node_moveSplit(areas, rightNode, -diff, false, split.vertical);
 
 	wima_area_node_resize(areas, node, area->rect, false);
+
+	// Only the areas under this split changed, but
+	// they need to be laid out again before drawing.
+	WimaWin* win = dvec_get(wg.windows, area->window);
+	wima_window_damageArea(win, node, true);
 }
 
-static void wima_area_node_moveSplit(DynaTree areas, DynaNode node, int diff, bool left, bool vertical)
+static void wima_area_node_moveSplit(WimaArTree* areas, WimaAreaNode node, int diff, bool left, bool vertical)
 {
 	wima_assert_init;
 
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	if (vertical)
 		area->rect.w += diff * (!left * -2 + 1);
@@ -1113,7 +1506,7 @@ static void wima_area_node_moveSplit(DynaTree areas, DynaNode node, int diff, bo
 
 	if (WIMA_AREA_IS_LEAF(area)) return;
 
-	DynaNode child;
+	WimaAreaNode child;
 	float dim;
 
 	// We don't have to move splits of areas
@@ -1130,35 +1523,35 @@ static void wima_area_node_moveSplit(DynaTree areas, DynaNode node, int diff, bo
 	}
 	else
 	{
-		child = left ? dtree_left(node) : dtree_right(node);
+		child = left ? wima_area_tree_left(areas, node) : wima_area_tree_right(areas, node);
 		wima_area_node_moveSplit(areas, child, diff, left, vertical);
 	}
 
-	child = left ? dtree_right(node) : dtree_left(node);
+	child = left ? wima_area_tree_right(areas, node) : wima_area_tree_left(areas, node);
 	wima_area_node_moveSplit(areas, child, diff, left, vertical);
 }
 
-static int wima_area_node_moveSplit_limit(DynaTree areas, DynaNode node, bool isLeft, bool vertical)
+static int wima_area_node_moveSplit_limit(WimaArTree* areas, WimaAreaNode node, bool isLeft, bool vertical)
 {
 	wima_assert_init;
 
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	int limit;
 
 	if (WIMA_AREA_IS_PARENT(area))
 	{
 		// We need the child that is shrinking.
-		DynaNode childNode = isLeft ? dtree_right(area->node) : dtree_left(area->node);
+		WimaAreaNode childNode = isLeft ? wima_area_tree_right(areas, area->node) : wima_area_tree_left(areas, area->node);
 
 		limit = wima_area_node_moveSplit_limit(areas, childNode, isLeft, vertical);
 
 		// We only need to check limits on areas that are oriented the same.
 		if (!vertical != !area->parent.vertical)
 		{
-			childNode = isLeft ? dtree_left(area->node) : dtree_right(area->node);
+			childNode = isLeft ? wima_area_tree_left(areas, area->node) : wima_area_tree_right(areas, area->node);
 			int lim = wima_area_node_moveSplit_limit(areas, childNode, isLeft, vertical);
 			limit = wima_min(limit, lim);
 		}
@@ -1177,18 +1570,18 @@ static int wima_area_node_moveSplit_limit(DynaTree areas, DynaNode node, bool is
 	return limit;
 }
 
-WimaWidget wima_area_findWidget(DynaTree areas, WimaVec pos, uint32_t flags)
+WimaWidget wima_area_findWidget(WimaArTree* areas, WimaVec pos, uint32_t flags)
 {
 	wima_assert_init;
 
-	DynaNode root = dtree_root();
+	WimaAreaNode root = WIMA_AREA_TREE_ROOT;
 
-	wassert(dtree_exists(areas, root), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, root), WIMA_ASSERT_AREA);
 
-	return wima_area_node_findWidget(areas, dtree_node(areas, root), pos, flags);
+	return wima_area_node_findWidget(areas, wima_area_tree_node(areas, root), pos, flags);
 }
 
-static WimaWidget wima_area_node_findWidget(DynaTree areas, WimaAr* area, WimaVec pos, uint32_t flags)
+static WimaWidget wima_area_node_findWidget(WimaArTree* areas, WimaAr* area, WimaVec pos, uint32_t flags)
 {
 	wima_assert_init;
 
@@ -1196,11 +1589,11 @@ static WimaWidget wima_area_node_findWidget(DynaTree areas, WimaAr* area, WimaVe
 
 	if (WIMA_AREA_IS_PARENT(area))
 	{
-		DynaNode leftNode = dtree_left(area->node);
+		WimaAreaNode leftNode = wima_area_tree_left(areas, area->node);
 
-		wassert(dtree_exists(areas, leftNode), WIMA_ASSERT_AREA);
+		wassert(wima_area_tree_exists(areas, leftNode), WIMA_ASSERT_AREA);
 
-		WimaAr* left = dtree_node(areas, leftNode);
+		WimaAr* left = wima_area_tree_node(areas, leftNode);
 
 		if (wima_rect_contains(left->rect, pos))
 		{
@@ -1208,11 +1601,11 @@ static WimaWidget wima_area_node_findWidget(DynaTree areas, WimaAr* area, WimaVe
 		}
 		else
 		{
-			DynaNode rightNode = dtree_right(area->node);
+			WimaAreaNode rightNode = wima_area_tree_right(areas, area->node);
 
-			wassert(dtree_exists(areas, rightNode), WIMA_ASSERT_AREA);
+			wassert(wima_area_tree_exists(areas, rightNode), WIMA_ASSERT_AREA);
 
-			WimaAr* right = dtree_node(areas, rightNode);
+			WimaAr* right = wima_area_tree_node(areas, rightNode);
 
 			if (wima_rect_contains(right->rect, pos))
 			{
@@ -1228,41 +1621,433 @@ static WimaWidget wima_area_node_findWidget(DynaTree areas, WimaAr* area, WimaVe
 	}
 	else
 	{
-		WimaItem* pitem;
+		wdgt.widget = WIMA_WIDGET_INVALID;
+		wdgt.area = area->node;
+		wdgt.region = WIMA_REGION_INVALID_IDX;
+		wdgt.window = area->window;
 
-		WimaWidget item;
-		item.widget = 0;
-		item.area = area->node;
-		item.window = area->window;
+		pos = wima_area_translatePos(area, pos);
 
-		wdgt = item;
-		wdgt.widget = WIMA_WIDGET_INVALID;
+		float x = ((float) pos.x) / area->area.scale;
+		float y = ((float) pos.y) / area->area.scale;
 
-		// TODO: Remove this and make the rest of the code work.
-		return wdgt;
+		// The mouse usually stays in the same widget
+		// for many events, so check that first.
+		if (area->area.hit.widget != WIMA_WIDGET_INVALID && area->area.hitFlags == flags)
+		{
+			WimaRectf r = area->area.hitRect;
 
-		pos = wima_area_translatePos(area, pos);
+			if (x >= r.x && y >= r.y && x < r.x + r.w && y < r.y + r.h) return area->area.hit;
+		}
 
-		while (item.widget != WIMA_WIDGET_INVALID)
+		area->area.hit.widget = WIMA_WIDGET_INVALID;
+
+		for (uint8_t i = 0; i < area->area.numRegions; ++i)
 		{
-			pitem = wima_widget_ptr(item);
+			WimaArGridItem* gitem = wima_area_grid_find(&area->area.regions[i].grid, x, y, flags);
 
-			if (wima_widget_contains(item, pos))
+			if (gitem)
 			{
-				if (!(pitem->layout.flags & WIMA_LAYOUT_ENABLE)) break;
+				wdgt.widget = gitem->widget;
+				wdgt.region = i;
 
-				if (flags == WIMA_ITEM_ANY || pitem->widget.flags & flags) wdgt = item;
+				area->area.hit = wdgt;
+				area->area.hitRect = gitem->rect;
+				area->area.hitFlags = flags;
 
-				item.widget = pitem->layout.firstKid;
+				break;
 			}
-			else
+		}
+	}
+
+	return wdgt;
+}
+
+bool wima_area_scroll(WimaAr* area, WimaVec pos, WimaScrollEvent event)
+{
+	wima_assert_init;
+
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+
+	pos = wima_area_translatePos(area, pos);
+
+	float x = ((float) pos.x) / area->area.scale;
+	float y = ((float) pos.y) / area->area.scale;
+
+	for (uint8_t i = 0; i < area->area.numRegions; ++i)
+	{
+		WimaArReg* areg = area->area.regions + i;
+
+		// Lists are created before the lists inside them,
+		// so going backwards finds the innermost one first.
+		for (uint32_t j = areg->numLists; j > 0; --j)
+		{
+			WimaArList* list = dvec_get(areg->lists, j - 1);
+			WimaRectf r = list->rect;
+
+			if (x < r.x || y < r.y || x >= r.x + r.w || y >= r.y + r.h) continue;
+
+			double max = wima_fmax(list->total - r.h, 0.0);
+			double scroll = list->scroll - ((double) event.yoffset) * WIMA_AREA_LIST_SCROLL;
+
+			scroll = wima_clamp(scroll, 0.0, max);
+
+			if (scroll == list->scroll) return false;
+
+			list->scroll = scroll;
+
+			// Only the rows in view are built,
+			// so they must be built again.
+			areg->stale = true;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+WimaArList* wima_area_list(WimaAr* area, uint8_t region, uint32_t list)
+{
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+	wassert(region < area->area.numRegions, WIMA_ASSERT_REG);
+
+	WimaArReg* areg = area->area.regions + region;
+
+	wassert(list < areg->numLists, WIMA_ASSERT_LAYOUT);
+
+	return dvec_get(areg->lists, list);
+}
+
+WimaArList* wima_area_list_next(WimaAr* area, uint8_t region, uint32_t* list)
+{
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+	wassert(region < area->area.numRegions, WIMA_ASSERT_REG);
+
+	WimaArReg* areg = area->area.regions + region;
+
+	if (!areg->lists)
+	{
+		areg->lists = dvec_create(0, sizeof(WimaArList), wima_area_list_destroy, NULL);
+		if (yerror(!areg->lists)) return NULL;
+	}
+
+	// A list that was not there last time starts at the top.
+	if (areg->numLists == dvec_len(areg->lists))
+	{
+		WimaArList state;
+
+		memset(&state, 0, sizeof(WimaArList));
+
+		if (yerror(dvec_push(areg->lists, &state))) return NULL;
+	}
+
+	*list = areg->numLists++;
+
+	return dvec_get(areg->lists, *list);
+}
+
+static WimaStatus wima_area_grid_build(WimaAr* area, uint8_t region)
+{
+	wima_assert_init;
+
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+	wassert(region < area->area.numRegions, WIMA_ASSERT_REG);
+
+	WimaArGrid* grid = &area->area.regions[region].grid;
+
+	if (!grid->items)
+	{
+		grid->items = dvec_create(0, sizeof(WimaArGridItem), NULL, NULL);
+		if (yerror(!grid->items)) return WIMA_STATUS_MALLOC_ERR;
+
+		grid->cells = dvec_create(0, sizeof(uint32_t), NULL, NULL);
+		if (yerror(!grid->cells)) return WIMA_STATUS_MALLOC_ERR;
+
+		grid->refs = dvec_create(0, sizeof(uint32_t), NULL, NULL);
+		if (yerror(!grid->refs)) return WIMA_STATUS_MALLOC_ERR;
+	}
+
+	grid->cols = grid->rows = 0;
+
+	if (yerror(dvec_setLength(grid->items, 0))) return WIMA_STATUS_MALLOC_ERR;
+
+	uint32_t root = area->area.regions[region].root.layout;
+
+	if (!(area->area.items->flags[root] & WIMA_LAYOUT_ENABLE)) return WIMA_STATUS_SUCCESS;
+
+	// Everything is put in area coordinates so that
+	// hit-testing only has to translate the mouse.
+	float x = area->area.items->rects[root].x - (float) area->rect.x;
+	float y = area->area.items->rects[root].y - (float) area->rect.y;
+
+	WimaStatus status = wima_area_grid_collect(area, grid, root, x, y);
+	if (yerror(status)) return status;
+
+	size_t len = dvec_len(grid->items);
+
+	if (!len) return WIMA_STATUS_SUCCESS;
+
+	WimaArGridItem* items = dvec_get(grid->items, 0);
+
+	float x2, y2;
+
+	grid->bounds = items[0].rect;
+	x2 = grid->bounds.x + grid->bounds.w;
+	y2 = grid->bounds.y + grid->bounds.h;
+
+	for (size_t i = 1; i < len; ++i)
+	{
+		WimaRectf r = items[i].rect;
+
+		grid->bounds.x = wima_fminf(grid->bounds.x, r.x);
+		grid->bounds.y = wima_fminf(grid->bounds.y, r.y);
+		x2 = wima_fmaxf(x2, r.x + r.w);
+		y2 = wima_fmaxf(y2, r.y + r.h);
+	}
+
+	grid->bounds.w = x2 - grid->bounds.x;
+	grid->bounds.h = y2 - grid->bounds.y;
+
+	if (grid->bounds.w <= 0.0f || grid->bounds.h <= 0.0f) return WIMA_STATUS_SUCCESS;
+
+	// Aim for about one widget per cell, with cells
+	// roughly as square as the region allows.
+	float cols = ceilf(sqrtf(len * grid->bounds.w / grid->bounds.h));
+	cols = wima_fmaxf(1.0f, wima_fminf(cols, WIMA_AREA_GRID_MAX));
+
+	float rows = ceilf(len / cols);
+	rows = wima_fmaxf(1.0f, wima_fminf(rows, WIMA_AREA_GRID_MAX));
+
+	uint16_t numCols = (uint16_t) cols;
+	uint16_t numRows = (uint16_t) rows;
+	uint32_t numCells = numCols * numRows;
+
+	float cellW = grid->bounds.w / cols;
+	float cellH = grid->bounds.h / rows;
+
+	if (yerror(dvec_setLength(grid->cells, numCells + 1))) return WIMA_STATUS_MALLOC_ERR;
+
+	uint32_t* cells = dvec_get(grid->cells, 0);
+	memset(cells, 0, (numCells + 1) * sizeof(uint32_t));
+
+	// This is a counting sort. First, count the
+	// widgets in each cell (shifted by one)...
+	for (size_t i = 0; i < len; ++i)
+	{
+		WimaRectf r = items[i].rect;
+
+		uint16_t c1 = (uint16_t) ((r.x - grid->bounds.x) / cellW);
+		uint16_t r1 = (uint16_t) ((r.y - grid->bounds.y) / cellH);
+		uint16_t c2 = (uint16_t) wima_fminf((r.x + r.w - grid->bounds.x) / cellW, cols - 1);
+		uint16_t r2 = (uint16_t) wima_fminf((r.y + r.h - grid->bounds.y) / cellH, rows - 1);
+
+		for (uint16_t row = r1; row <= r2; ++row)
+		{
+			for (uint16_t col = c1; col <= c2; ++col) ++cells[row * numCols + col + 1];
+		}
+	}
+
+	// ...then turn the counts into starts...
+	for (uint32_t i = 0; i < numCells; ++i) cells[i + 1] += cells[i];
+
+	if (yerror(dvec_setLength(grid->refs, cells[numCells]))) return WIMA_STATUS_MALLOC_ERR;
+
+	uint32_t* refs = dvec_get(grid->refs, 0);
+
+	// ...then fill the cells. This uses each start as
+	// a cursor, which moves it to the next cell's start.
+	// Widgets are added in layout order, which is the
+	// order that hit-testing has to respect.
+	for (size_t i = 0; i < len; ++i)
+	{
+		WimaRectf r = items[i].rect;
+
+		uint16_t c1 = (uint16_t) ((r.x - grid->bounds.x) / cellW);
+		uint16_t r1 = (uint16_t) ((r.y - grid->bounds.y) / cellH);
+		uint16_t c2 = (uint16_t) wima_fminf((r.x + r.w - grid->bounds.x) / cellW, cols - 1);
+		uint16_t r2 = (uint16_t) wima_fminf((r.y + r.h - grid->bounds.y) / cellH, rows - 1);
+
+		for (uint16_t row = r1; row <= r2; ++row)
+		{
+			for (uint16_t col = c1; col <= c2; ++col) refs[cells[row * numCols + col]++] = (uint32_t) i;
+		}
+	}
+
+	// Finally, shift the starts back.
+	for (uint32_t i = numCells; i > 0; --i) cells[i] = cells[i - 1];
+	cells[0] = 0;
+
+	grid->cellW = cellW;
+	grid->cellH = cellH;
+	grid->cols = numCols;
+	grid->rows = numRows;
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+static WimaStatus wima_area_grid_collect(WimaAr* area, WimaArGrid* grid, uint32_t layout, float x, float y)
+{
+	WimaItemStore* store = area->area.items;
+
+	WimaItem* item = dvec_get(store->items, layout);
+
+	wassert(WIMA_ITEM_IS_LAYOUT(item), WIMA_ASSERT_LAYOUT);
+
+	uint32_t first = item->layout.firstKid;
+	uint32_t count = item->layout.kidCount;
+
+	bool list = (store->flags[layout] & WIMA_LAYOUT_FLAG_LIST) != 0;
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		uint32_t idx = store->kids[first + i];
+		WimaRectf rect = store->rects[idx];
+
+		// Rows that were built in the overscan can't be hit.
+		if (list && !WIMA_LAYOUT_LIST_SHOWS(store->rects[layout], rect)) continue;
+
+		// Children's rectangles are relative to the parent.
+		float cx = x + rect.x;
+		float cy = y + rect.y;
+
+		WimaItem* child = dvec_get(store->items, idx);
+
+		if (WIMA_ITEM_IS_LAYOUT(child))
+		{
+			uint16_t flags = store->flags[idx];
+
+			if ((flags & WIMA_LAYOUT_ENABLE) && !(flags & WIMA_LAYOUT_FLAG_SEP))
 			{
-				item.widget = pitem->nextSibling;
+				// Lists are scrolled by where they are.
+				if (flags & WIMA_LAYOUT_FLAG_LIST)
+				{
+					WimaArList* state = wima_area_list(area, child->info.layout.region, child->list.list);
+
+					state->rect.x = cx;
+					state->rect.y = cy;
+					state->rect.w = rect.w;
+					state->rect.h = rect.h;
+				}
+
+				WimaStatus status = wima_area_grid_collect(area, grid, idx, cx, cy);
+				if (yerror(status)) return status;
 			}
 		}
+		else
+		{
+			WimaArGridItem gitem;
+
+			gitem.rect.x = cx;
+			gitem.rect.y = cy;
+			gitem.rect.w = rect.w;
+			gitem.rect.h = rect.h;
+			gitem.flags = child->widget.flags;
+			gitem.widget = idx;
+
+			if (yerror(dvec_push(grid->items, &gitem))) return WIMA_STATUS_MALLOC_ERR;
+
+			// Widgets in retained regions are not passed through
+			// wima_layout_widget() again, and their links may have
+			// been dropped while another workspace was up.
+			WimaStatus status = wima_prop_link(child->widget.prop, child->info.widget);
+			if (yerror(status)) return status;
+		}
 	}
 
-	return wdgt;
+	return WIMA_STATUS_SUCCESS;
+}
+
+static WimaArGridItem* wima_area_grid_find(WimaArGrid* grid, float x, float y, uint32_t flags)
+{
+	if (!grid->cols) return NULL;
+
+	float gx = x - grid->bounds.x;
+	float gy = y - grid->bounds.y;
+
+	if (gx < 0.0f || gy < 0.0f || gx >= grid->bounds.w || gy >= grid->bounds.h) return NULL;
+
+	uint16_t col = (uint16_t) wima_fminf(gx / grid->cellW, grid->cols - 1);
+	uint16_t row = (uint16_t) wima_fminf(gy / grid->cellH, grid->rows - 1);
+
+	uint32_t* cells = dvec_get(grid->cells, 0);
+	uint32_t cell = row * grid->cols + col;
+
+	uint32_t start = cells[cell];
+	uint32_t end = cells[cell + 1];
+
+	if (start == end) return NULL;
+
+	uint32_t* refs = dvec_get(grid->refs, 0);
+	WimaArGridItem* items = dvec_get(grid->items, 0);
+
+	for (uint32_t i = start; i < end; ++i)
+	{
+		WimaArGridItem* gitem = items + refs[i];
+		WimaRectf r = gitem->rect;
+
+		if (x < r.x || y < r.y || x >= r.x + r.w || y >= r.y + r.h) continue;
+
+		if (flags == WIMA_ITEM_ANY || (gitem->flags & flags)) return gitem;
+	}
+
+	return NULL;
+}
+
+static void wima_area_grid_free(WimaAr* area)
+{
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+
+	for (uint8_t i = 0; i < area->area.numRegions; ++i)
+	{
+		WimaArGrid* grid = &area->area.regions[i].grid;
+
+		if (grid->items) dvec_free(grid->items);
+		if (grid->cells) dvec_free(grid->cells);
+		if (grid->refs) dvec_free(grid->refs);
+
+		grid->items = NULL;
+		grid->cells = NULL;
+		grid->refs = NULL;
+		grid->cols = grid->rows = 0;
+	}
+}
+
+static void wima_area_list_destroy(void* ptr)
+{
+	WimaArList* list = (WimaArList*) ptr;
+
+	if (list->offsets) dvec_free(list->offsets);
+
+	if (list->data)
+	{
+		size_t len = dvec_len(list->keys);
+
+		for (size_t i = 0; i < len; ++i)
+		{
+			WimaArListData* entry = dvec_get(list->keys, i);
+			wima_widget_destroy(list->data, &entry->key);
+		}
+
+		dpool_free(list->data);
+	}
+
+	if (list->keys) dvec_free(list->keys);
+}
+
+static void wima_area_list_free(WimaAr* area)
+{
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+
+	for (uint8_t i = 0; i < area->area.numRegions; ++i)
+	{
+		WimaArReg* areg = area->area.regions + i;
+
+		if (areg->lists) dvec_free(areg->lists);
+
+		areg->lists = NULL;
+		areg->numLists = 0;
+	}
 }
 
 static void wima_area_childrenRects(WimaAr* area, WimaRect* left, WimaRect* right)
@@ -1324,6 +2109,32 @@ static void wima_area_popViewport(NVGcontext* nvg)
 	nvgResetScissor(nvg);
 }
 
+static void wima_area_drawContents(WimaRenderContext* ctx, WimaAr* area, WimaPropData* bg)
+{
+	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
+
+	wima_area_background(area, ctx->nvg, bg);
+
+	if (wima_item_len(area->area.items))
+	{
+		wima_render_save(ctx);
+
+		nvgScale(ctx->nvg, area->area.scale, area->area.scale);
+
+		WimaRectf* rect = area->area.items->rects;
+
+		rect->x = 0;
+		rect->y = 0;
+		rect->w = area->rect.w;
+		rect->h = area->rect.h;
+
+		// TODO: Draw each region.
+
+		// Restore the old render state.
+		wima_render_restore(ctx);
+	}
+}
+
 static void wima_area_background(WimaAr* area, NVGcontext* nvg, WimaPropData* bg)
 {
 	wima_assert_init;
@@ -1445,14 +2256,14 @@ static void wima_area_drawSplitWidgets(WimaAr* area, NVGcontext* nvg)
 	nvgShapeAntiAlias(nvg, 1);
 }
 
-void wima_area_drawJoinOverlay(DynaTree areas, DynaNode node, NVGcontext* nvg, bool vertical, bool mirror)
+void wima_area_drawJoinOverlay(WimaArTree* areas, WimaAreaNode node, NVGcontext* nvg, bool vertical, bool mirror)
 {
 	wima_assert_init;
 	wassert(nvg, WIMA_ASSERT_WIN_CONTEXT);
 
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
 
@@ -1511,14 +2322,14 @@ void wima_area_drawJoinOverlay(DynaTree areas, DynaNode node, NVGcontext* nvg, b
 	nvgFill(nvg);
 }
 
-void wima_area_drawSplitOverlay(DynaTree areas, DynaNode node, WimaVec cursor, NVGcontext* nvg, bool vertical)
+void wima_area_drawSplitOverlay(WimaArTree* areas, WimaAreaNode node, WimaVec cursor, NVGcontext* nvg, bool vertical)
 {
 	wima_assert_init;
 	wassert(nvg, WIMA_ASSERT_WIN_CONTEXT);
 
-	wassert(dtree_exists(areas, node), WIMA_ASSERT_AREA);
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	WimaAr* area = dtree_node(areas, node);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
 	wassert(WIMA_AREA_IS_LEAF(area), WIMA_ASSERT_AREA_LEAF);
 
@@ -94,6 +94,146 @@ typedef struct WimaAreaSplit
 
 } WimaAreaSplit;
 
+/**
+ * @def WIMA_AREA_GRID_MAX
+ * The max number of rows or columns in the
+ * hit-testing grid of a region.
+ */
+#define WIMA_AREA_GRID_MAX (64)
+
+/**
+ * @def WIMA_AREA_SIZE_CLASS_SHIFT
+ * Two area sizes are in the same size class if they
+ * are equal after shifting right by this many bits.
+ * Regions are only generated again when their area
+ * moves to a different size class; otherwise, their
+ * items are kept and just reflowed.
+ */
+#define WIMA_AREA_SIZE_CLASS_SHIFT (6)
+
+/**
+ * @def WIMA_AREA_LIST_SCROLL
+ * How far (in unscaled pixels) a virtual
+ * list scrolls for each step of the wheel.
+ */
+#define WIMA_AREA_LIST_SCROLL (48.0f)
+
+/**
+ * A widget in a region's hit-testing grid.
+ */
+typedef struct WimaArGridItem
+{
+	/// The widget's rectangle, in unscaled area coordinates.
+	WimaRectf rect;
+
+	/// The widget's flags.
+	uint32_t flags;
+
+	/// The index of the widget.
+	uint32_t widget;
+
+} WimaArGridItem;
+
+/**
+ * A uniform grid over the widgets in a region, used for
+ * hit-testing. It is rebuilt after every layout.
+ */
+typedef struct WimaArGrid
+{
+	/// The bounds of all of the widgets.
+	WimaRectf bounds;
+
+	/// The width of a cell.
+	float cellW;
+
+	/// The height of a cell.
+	float cellH;
+
+	/// The number of columns.
+	uint16_t cols;
+
+	/// The number of rows.
+	uint16_t rows;
+
+	/// The widgets (@a WimaArGridItem) in layout order.
+	DynaVector items;
+
+	/// The start of each cell in @a refs. There is
+	/// one extra at the end for the end of the last.
+	DynaVector cells;
+
+	/// Indices into @a items, grouped by cell.
+	DynaVector refs;
+
+} WimaArGrid;
+
+/**
+ * Widget data owned by a virtual list.
+ */
+typedef struct WimaArListData
+{
+	/// The key of the data in the list's pool.
+	uint64_t key;
+
+	/// The row that created the data.
+	uint32_t row;
+
+	/// The size of the data.
+	uint32_t size;
+
+} WimaArListData;
+
+/**
+ * The state of a virtual list in a region. This is kept
+ * when the region is generated again, matched by the order
+ * that the lists are created in, so that lists keep their
+ * scroll positions.
+ */
+typedef struct WimaArList
+{
+	/// The function that builds rows.
+	WimaLayoutRowFunc build;
+
+	/// The function that estimates row
+	/// heights, or NULL if they are fixed.
+	WimaLayoutRowHeightFunc height;
+
+	/// The top of every row, plus the bottom of
+	/// the last, if @a height is not NULL. These
+	/// are doubles because a float can't hold
+	/// every pixel of a list of millions of rows.
+	DynaVector offsets;
+
+	/// The number of rows.
+	uint32_t rows;
+
+	/// The version of the row heights in @a offsets.
+	uint32_t version;
+
+	/// The height of every row, if @a height is NULL.
+	float rowHeight;
+
+	/// The height of all rows together.
+	double total;
+
+	/// How far the list is scrolled down.
+	double scroll;
+
+	/// The list's rectangle, in unscaled area
+	/// coordinates, from the last layout.
+	WimaRectf rect;
+
+	/// The data of the widgets in the rows, keyed
+	/// like an area's, or NULL if none were built.
+	/// Data for rows that are no longer built is
+	/// dropped, so this stays at the size of a view.
+	DynaPool data;
+
+	/// The entries (@a WimaArListData) in @a data.
+	DynaVector keys;
+
+} WimaArList;
+
 /**
  * The data for a live region on an area.
  */
@@ -116,6 +256,38 @@ typedef struct WimaArReg
 	/// The region's root layout.
 	WimaLayout root;
 
+	/// The hit-testing grid.
+	WimaArGrid grid;
+
+	/// The states of the virtual lists (@a WimaArList)
+	/// in the region, or NULL if it has never had any.
+	DynaVector lists;
+
+	/// The number of lists in @a lists that
+	/// were created by the last generation.
+	uint32_t numLists;
+
+	/// The list whose row is being built, or
+	/// @a WIMA_ITEM_LIST_INVALID if none.
+	uint32_t building;
+
+	/// The row that is being built.
+	uint32_t buildRow;
+
+	/// The area's size class when the region's
+	/// items were generated. See
+	/// @a WIMA_AREA_SIZE_CLASS_SHIFT.
+	WimaSize sizeClass;
+
+	/// Whether generating the region's items used
+	/// the area's size, in which case a change of
+	/// @a sizeClass makes the region stale.
+	bool sized;
+
+	/// Whether the region's items must be
+	/// generated again on the next layout.
+	bool stale;
+
 } WimaArReg;
 
 /**
@@ -135,6 +307,10 @@ typedef struct WimaAr
 	/// Whether this node is a parent or not.
 	bool isParent;
 
+	/// Whether this node (and everything under
+	/// it) needs to be redrawn on the next frame.
+	bool damaged;
+
 	/// The area's minimum size.
 	WimaSize minSize;
 
@@ -148,12 +324,34 @@ typedef struct WimaAr
 		 */
 		struct wima_area_leaf
 		{
-			// The vector of items.
-			DynaVector items;
+			// The items.
+			WimaItemStore* items;
 
 			/// Data for widgets.
 			DynaPool widgetData;
 
+			/// The framebuffer that caches what was
+			/// drawn in the area, or NULL if none.
+			struct NVGLUframebuffer* cache;
+
+			/// The theme version that the cache was
+			/// drawn with. See @a WimaG's themeVersion.
+			uint32_t cacheTheme;
+
+			/// Whether the cache needs to be redrawn.
+			bool cacheStale;
+
+			/// The last widget found by hit-testing. While
+			/// the mouse stays in it, the grids are skipped.
+			WimaWidget hit;
+
+			/// The rectangle of @a hit, in unscaled
+			/// area coordinates.
+			WimaRectf hitRect;
+
+			/// The flags that @a hit was found with.
+			uint32_t hitFlags;
+
 			/// The area's current scale.
 			float scale;
 
@@ -201,6 +399,201 @@ typedef struct WimaAr
  */
 #define WIMA_AREA_IS_PARENT(area) ((area)->isParent)
 
+/**
+ * @def WIMA_AREA_TREE_ROOT
+ * The node of the root of an area tree. The root
+ * is always the first node added to a tree.
+ */
+#define WIMA_AREA_TREE_ROOT ((WimaAreaNode) 0)
+
+/**
+ * The links of a node in an area tree. These are kept
+ * apart from the areas so that walking the tree only
+ * touches a few bytes per node.
+ */
+typedef struct WimaArLink
+{
+	/// The parent of the node, or
+	/// WIMA_AREA_INVALID for the root.
+	WimaAreaNode parent;
+
+	/// The left child, or WIMA_AREA_INVALID.
+	WimaAreaNode left;
+
+	/// The right child, or WIMA_AREA_INVALID.
+	/// For free nodes, this is the next free node.
+	WimaAreaNode right;
+
+	/// Whether the node is in the tree.
+	bool used;
+
+} WimaArLink;
+
+/**
+ * A tree of areas with explicit links. Nodes are kept in
+ * a pool, so a node keeps its index (handle) while it is
+ * in the tree, and memory grows with the number of areas,
+ * not with the depth of the tree. The pool is reallocated
+ * when it grows, so pointers to nodes are not stable.
+ * Nodes that are removed are put on a free list and
+ * reused. A tree that is all zeroes is empty.
+ */
+typedef struct WimaArTree
+{
+	/// The areas, indexed by node.
+	WimaAr* areas;
+
+	/// The links, indexed by node.
+	WimaArLink* links;
+
+	/// The number of nodes allocated.
+	uint32_t cap;
+
+	/// The number of nodes that have ever been used.
+	/// Nodes past this have never been touched.
+	uint32_t len;
+
+	/// The number of nodes in the tree.
+	uint32_t count;
+
+	/// The first free node, or WIMA_AREA_INVALID.
+	WimaAreaNode free;
+
+} WimaArTree;
+
+/**
+ * Creates an empty area tree on the heap.
+ * @return	The new tree, or NULL on malloc failure.
+ */
+WimaArTree* wima_area_tree_create(void) ynoretalias;
+
+/**
+ * Pushes an empty area tree onto @a trees.
+ * @param trees	The vector of @a WimaArTree to push onto.
+ * @return		A pointer to the new tree, or NULL
+ *				on malloc failure.
+ * @pre			@a trees must not be NULL.
+ */
+WimaArTree* wima_area_tree_push(DynaVector trees) yallnonnull;
+
+/**
+ * Adds a node with a copy of @a area to @a tree. If
+ * @a parent is WIMA_AREA_INVALID, the node is the root,
+ * otherwise, it is the left or right child of @a parent.
+ * The node of the new area is set. This may move the
+ * areas in @a tree, so pointers to them are invalidated.
+ * @param tree		The tree to add to.
+ * @param parent	The parent of the new node.
+ * @param left		Whether the node is the left child.
+ * @param area		The area to copy into the new node.
+ * @return			The new node, or WIMA_AREA_INVALID
+ *					on malloc failure or if @a tree
+ *					already has WIMA_TREE_NODE_MAX nodes.
+ * @pre				@a tree must not be NULL.
+ * @pre				@a area must not be NULL.
+ * @pre				If @a parent is WIMA_AREA_INVALID,
+ *					@a tree must be empty. Otherwise,
+ *					@a parent must be in @a tree and
+ *					must not have the child already.
+ */
+WimaAreaNode wima_area_tree_add(WimaArTree* tree, WimaAreaNode parent, bool left, WimaAr* area) yallnonnull;
+
+/**
+ * Removes @a node, and everything under it, from
+ * @a tree. The areas are destroyed.
+ * @param tree	The tree to remove from.
+ * @param node	The node to remove.
+ * @pre			@a tree must not be NULL.
+ * @pre			@a node must be in @a tree.
+ */
+void wima_area_tree_remove(WimaArTree* tree, WimaAreaNode node) yallnonnull;
+
+/**
+ * Returns true if @a node is in @a tree.
+ * @param tree	The tree to query.
+ * @param node	The node to query.
+ * @return		true if @a node is in @a tree,
+ *				false otherwise.
+ * @pre			@a tree must not be NULL.
+ */
+bool wima_area_tree_exists(WimaArTree* tree, WimaAreaNode node) yallnonnull yinline;
+
+/**
+ * Returns the area at @a node in @a tree.
+ * @param tree	The tree to query.
+ * @param node	The node to query.
+ * @return		A pointer to the area.
+ * @pre			@a tree must not be NULL.
+ * @pre			@a node must be in @a tree.
+ */
+WimaAr* wima_area_tree_node(WimaArTree* tree, WimaAreaNode node) yallnonnull yinline;
+
+/**
+ * Returns the left child of @a node in @a tree.
+ * @param tree	The tree to query.
+ * @param node	The node to query.
+ * @return		The left child, or WIMA_AREA_INVALID.
+ * @pre			@a tree must not be NULL.
+ * @pre			@a node must be in @a tree.
+ */
+WimaAreaNode wima_area_tree_left(WimaArTree* tree, WimaAreaNode node) yallnonnull yinline;
+
+/**
+ * Returns the right child of @a node in @a tree.
+ * @param tree	The tree to query.
+ * @param node	The node to query.
+ * @return		The right child, or WIMA_AREA_INVALID.
+ * @pre			@a tree must not be NULL.
+ * @pre			@a node must be in @a tree.
+ */
+WimaAreaNode wima_area_tree_right(WimaArTree* tree, WimaAreaNode node) yallnonnull yinline;
+
+/**
+ * Returns the parent of @a node in @a tree.
+ * @param tree	The tree to query.
+ * @param node	The node to query.
+ * @return		The parent, or WIMA_AREA_INVALID
+ *				if @a node is the root.
+ * @pre			@a tree must not be NULL.
+ * @pre			@a node must be in @a tree.
+ */
+WimaAreaNode wima_area_tree_parent(WimaArTree* tree, WimaAreaNode node) yallnonnull yinline;
+
+/**
+ * Destroys all of the areas in @a tree, leaving it
+ * empty. The memory is kept for reuse.
+ * @param tree	The tree to empty.
+ * @pre			@a tree must not be NULL.
+ */
+void wima_area_tree_empty(WimaArTree* tree) yallnonnull;
+
+/**
+ * Copies the area tree at @a src into @a dest. Like
+ * all DynaCopyFuncs, anything in @a dest is overwritten,
+ * not destroyed. The nodes are the same in both trees.
+ * @param dest	The tree to copy into.
+ * @param src	The tree to copy.
+ * @return		DYNA_STATUS_SUCCESS on success, an error
+ *				code otherwise.
+ */
+DynaStatus wima_area_tree_copy(void* dest, const void* src) yallnonnull;
+
+/**
+ * Destroys the areas in the tree at @a ptr and frees
+ * its memory, but not the tree itself. The tree is
+ * left empty. This is a DynaDestructFunc.
+ * @param ptr	The tree to destroy.
+ */
+void wima_area_tree_destroy(void* ptr) yallnonnull;
+
+/**
+ * Destroys and frees a tree created with
+ * @a wima_area_tree_create().
+ * @param tree	The tree to free.
+ * @pre			@a tree must not be NULL.
+ */
+void wima_area_tree_free(WimaArTree* tree) yallnonnull;
+
 /**
  * Gets a pointer to the area at @a node in @a wwh.
  * @param wwh	The window to query.
@@ -221,7 +614,7 @@ WimaAr* wima_area_ptr(WimaWindow wwh, WimaAreaNode node) yretnonnull;
  *				code otherwise.
  * @pre			@a areas must not be NULL.
  */
-WimaStatus wima_area_init(WimaWindow win, DynaTree areas, WimaRect rect, WimaSizef* min) yallnonnull;
+WimaStatus wima_area_init(WimaWindow win, WimaArTree* areas, WimaRect rect, WimaSizef* min) yallnonnull;
 
 /**
  * Copies an area from @a src to @a dest. This is a DynaCopyFunc.
@@ -249,14 +642,7 @@ WimaStatus wima_area_setup(WimaAr* area, bool allocate) yallnonnull;
  *					otherwise.
  * @pre				@a editors must not be NULL
  */
-bool wima_area_valid(DynaTree editors) yallnonnull yinline;
-
-/**
- * Frees a tree of areas.
- * @param areas	The tree to free.
- * @pre			@a areas must not be NULL.
- */
-void wima_area_free(DynaTree areas) yallnonnull;
+bool wima_area_valid(WimaArTree* editors) yallnonnull yinline;
 
 /**
  * A Dyna DestructFunc that will destroy a node in an area tree.
@@ -290,7 +676,42 @@ void wima_area_mouseEnter(WimaAr* area, bool enter) yallnonnull;
  * @pre			@a ctx must not be NULL.
  * @pre			@a areas must not be NULL.
  */
-WimaStatus wima_area_draw(WimaRenderContext* ctx, DynaTree areas) yallnonnull;
+WimaStatus wima_area_draw(WimaRenderContext* ctx, WimaArTree* areas) yallnonnull;
+
+/**
+ * Draws only the areas that have been marked as
+ * damaged. Each damaged area's rectangle is cleared
+ * before it is redrawn. Undamaged areas are left
+ * alone, so this relies on the previous frame still
+ * being in the render target.
+ * @param ctx	The render context to draw to.
+ * @param areas	The tree of areas to draw.
+ * @return		WIMA_STATUS_SUCCESS on success, a
+ *				user-supplied error code otherwise.
+ * @pre			@a ctx must not be NULL.
+ * @pre			@a areas must not be NULL.
+ */
+WimaStatus wima_area_drawDamaged(WimaRenderContext* ctx, WimaArTree* areas) yallnonnull;
+
+/**
+ * Redraws the cached contents of leaf areas that need it.
+ * A cache needs to be redrawn if its area is damaged, it
+ * is stale, its size is wrong, or the theme has changed.
+ * This must be called before the window's frame starts,
+ * and it leaves the default framebuffer bound. If
+ * @a enabled is false, all caches are freed instead.
+ * @param ctx			The render context to draw with.
+ * @param areas			The tree of areas to update.
+ * @param pixelRatio	The pixel ratio of the window.
+ * @param enabled		Whether or not caches are enabled.
+ * @param force			If true, all caches are redrawn.
+ * @return				WIMA_STATUS_SUCCESS on success,
+ *						an error code otherwise.
+ * @pre					@a ctx must not be NULL.
+ * @pre					@a areas must not be NULL.
+ */
+WimaStatus wima_area_updateCaches(WimaRenderContext* ctx, WimaArTree* areas, float pixelRatio, bool enabled,
+                                  bool force) yallnonnull;
 
 /**
  * Resizes all areas.
@@ -298,7 +719,7 @@ WimaStatus wima_area_draw(WimaRenderContext* ctx, DynaTree areas) yallnonnull;
  * @param rect	The rectangle for the root area.
  * @pre			@a areas must not be NULL.
  */
-void wima_area_resize(DynaTree areas, WimaRect rect) yallnonnull;
+void wima_area_resize(WimaArTree* areas, WimaRect rect) yallnonnull;
 
 /**
  * Lays out the header for an area. Ths is used
@@ -311,14 +732,27 @@ void wima_area_resize(DynaTree areas, WimaRect rect) yallnonnull;
 WimaStatus wima_area_layoutHeader(WimaLayout root);
 
 /**
- * Lays out all areas.
+ * Lays out all areas. Regions whose items are still
+ * valid are only reflowed; their layout functions
+ * are not called.
  * @param areas	The tree of areas.
  * @param min	A pointer to store the min size in.
+ * @param regen	Whether to generate the items of
+ *				every region again, stale or not.
  * @return		WIMA_STATUS_SUCCESS on success, a
  *				user-supplied error code otherwise.
  * @pre			@a areas must not be NULL.
  */
-WimaStatus wima_area_layout(DynaTree areas, WimaSizef* min) yallnonnull;
+WimaStatus wima_area_layout(WimaArTree* areas, WimaSizef* min, bool regen) yallnonnull;
+
+/**
+ * Marks all of the regions in @a area as stale,
+ * so their items will be generated again.
+ * @param area	The area to invalidate.
+ * @pre			@a area must not be NULL.
+ * @pre			@a area must be a leaf.
+ */
+void wima_area_invalidateRegions(WimaAr* area) yallnonnull;
 
 /**
  * Finds the area that the mouse is currently inside.
@@ -330,7 +764,7 @@ WimaStatus wima_area_layout(DynaTree areas, WimaSizef* min) yallnonnull;
  *					WIMA_AREA_INVALID if none.
  * @pre				@a areas must not be NULL.
  */
-WimaAreaNode wima_area_mouseOver(DynaTree areas, WimaVec cursor) yallnonnull;
+WimaAreaNode wima_area_mouseOver(WimaArTree* areas, WimaVec cursor) yallnonnull;
 
 /**
  * Returns true if the mouse is on a split, false otherwise.
@@ -341,7 +775,7 @@ WimaAreaNode wima_area_mouseOver(DynaTree areas, WimaVec cursor) yallnonnull;
  * @return			true if mouse is on a split, false otherwise.
  * @pre				@a areas must not be NULL.
  */
-bool wima_area_mouseOnSplit(DynaTree areas, WimaVec pos, WimaAreaSplit* result) yallnonnull;
+bool wima_area_mouseOnSplit(WimaArTree* areas, WimaVec pos, WimaAreaSplit* result) yallnonnull;
 
 /**
  * Moves an area's split, as well as all of its children's splits.
@@ -351,7 +785,7 @@ bool wima_area_mouseOnSplit(DynaTree areas, WimaVec pos, WimaAreaSplit* result)
  * @param cursor	The position of the cursor.
  * @pre				@a areas must not be NULL.
  */
-void wima_area_moveSplit(DynaTree areas, DynaNode node, WimaAreaSplit split, WimaVec cursor) yallnonnull;
+void wima_area_moveSplit(WimaArTree* areas, WimaAreaNode node, WimaAreaSplit split, WimaVec cursor) yallnonnull;
 
 /**
  * Finds the widget at @a pos.
@@ -363,7 +797,49 @@ void wima_area_moveSplit(DynaTree areas, DynaNode node, WimaAreaSplit split, Wim
  * @return		The widget at the pos, or WIMA_WIDGET_INVALID.
  * @pre			@a areas must not be NULL.
  */
-WimaWidget wima_area_findWidget(DynaTree areas, WimaVec pos, uint32_t flags) yallnonnull;
+WimaWidget wima_area_findWidget(WimaArTree* areas, WimaVec pos, uint32_t flags) yallnonnull;
+
+/**
+ * Scrolls the innermost virtual list in @a area that
+ * is at @a pos. If the list moved, its region is marked
+ * stale, so the caller must force a layout.
+ * @param area	The area that @a pos is in.
+ * @param pos	The position of the cursor.
+ * @param event	The scroll event.
+ * @return		true if a list was scrolled,
+ *				false otherwise.
+ * @pre			@a area must not be NULL.
+ * @pre			@a area must be a leaf area.
+ */
+bool wima_area_scroll(WimaAr* area, WimaVec pos, WimaScrollEvent event) yallnonnull;
+
+/**
+ * Returns the state of the virtual list at index
+ * @a list in region @a region of @a area.
+ * @param area		The area that the list is in.
+ * @param region	The region that the list is in.
+ * @param list		The index of the list.
+ * @return			The list's state.
+ * @pre				@a area must not be NULL.
+ * @pre				@a list must be valid.
+ */
+WimaArList* wima_area_list(WimaAr* area, uint8_t region, uint32_t list) yallnonnull yretnonnull;
+
+/**
+ * Returns the state of the next virtual list in region
+ * @a region of @a area, creating it if necessary. This
+ * must be called in the same order as lists are created
+ * in the region's layout function.
+ * @param area		The area that the list is in.
+ * @param region	The region that the list is in.
+ * @param list		A pointer to return the list's
+ *					index in.
+ * @return			The list's state, or NULL on
+ *					malloc failure.
+ * @pre				@a area must not be NULL.
+ * @pre				@a list must not be NULL.
+ */
+WimaArList* wima_area_list_next(WimaAr* area, uint8_t region, uint32_t* list) yallnonnull;
 
 /**
  * Draws an area's join overlay. This overlay is for when an area is
@@ -374,7 +850,8 @@ WimaWidget wima_area_findWidget(DynaTree areas, WimaVec pos, uint32_t flags) yal
  * @param vertical	Whether the arrow should be vertical or not.
  * @param mirror	Whether the arrow should point left (down) or not.
  */
-void wima_area_drawJoinOverlay(DynaTree areas, DynaNode node, NVGcontext* nvg, bool vertical, bool mirror) yallnonnull;
+void wima_area_drawJoinOverlay(WimaArTree* areas, WimaAreaNode node, NVGcontext* nvg, bool vertical,
+                               bool mirror) yallnonnull;
 
 /**
  * Draw an area's split overlay.
@@ -384,7 +861,7 @@ void wima_area_drawJoinOverlay(DynaTree areas, DynaNode node, NVGcontext* nvg, b
  * @param nvg		The NanoVG context to render to.
  * @param vertical	Whether the line should be vertical or not.
  */
-void wima_area_drawSplitOverlay(DynaTree areas, DynaNode node, WimaVec cursor, NVGcontext* nvg,
+void wima_area_drawSplitOverlay(WimaArTree* areas, WimaAreaNode node, WimaVec cursor, NVGcontext* nvg,
                                 bool vertical) yallnonnull;
 
 /**
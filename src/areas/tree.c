@@ -0,0 +1,359 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Source code for the trees that hold Wima areas.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#include <wima/wima.h>
+
+#include "area.h"
+
+#include "../wima.h"
+
+#include <yc/assert.h>
+#include <yc/error.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static function declarations needed for public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file tree.c
+ */
+
+/**
+ * @addtogroup area_internal area_internal
+ * @{
+ */
+
+/**
+ * @def WIMA_AREA_TREE_MIN_CAP
+ * The number of nodes allocated the first
+ * time that a node is added to a tree.
+ */
+#define WIMA_AREA_TREE_MIN_CAP (8)
+
+/**
+ * Makes sure that @a tree can hold at least @a cap nodes.
+ * @param tree	The tree to grow.
+ * @param cap	The number of nodes needed.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise, including when
+ *				@a cap is over WIMA_TREE_NODE_MAX.
+ * @pre			@a tree must not be NULL.
+ */
+static WimaStatus wima_area_tree_reserve(WimaArTree* tree, uint32_t cap) yallnonnull;
+
+/**
+ * Destroys @a node and everything under it
+ * and puts them on the free list of @a tree.
+ * @param tree	The tree to remove from.
+ * @param node	The node to remove.
+ * @pre			@a tree must not be NULL.
+ */
+static void wima_area_tree_removeNode(WimaArTree* tree, WimaAreaNode node) yallnonnull;
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+//! @cond Doxygen suppress.
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaArTree* wima_area_tree_create(void)
+{
+	WimaArTree* tree = calloc(1, sizeof(WimaArTree));
+	if (yerror(!tree)) return NULL;
+
+	tree->free = WIMA_AREA_INVALID;
+
+	return tree;
+}
+
+WimaArTree* wima_area_tree_push(DynaVector trees)
+{
+	WimaArTree tree;
+
+	memset(&tree, 0, sizeof(WimaArTree));
+	tree.free = WIMA_AREA_INVALID;
+
+	if (yerror(dvec_push(trees, &tree))) return NULL;
+
+	return dvec_get(trees, dvec_len(trees) - 1);
+}
+
+WimaAreaNode wima_area_tree_add(WimaArTree* tree, WimaAreaNode parent, bool left, WimaAr* area)
+{
+	wassert(tree, WIMA_ASSERT_TREE);
+
+	WimaAreaNode node;
+
+	if (parent == WIMA_AREA_INVALID)
+	{
+		wassert(!tree->count, WIMA_ASSERT_TREE_NODE_EXISTS);
+
+		// The root is always the first node.
+		tree->len = 0;
+		tree->free = WIMA_AREA_INVALID;
+	}
+	else
+	{
+		wassert(wima_area_tree_exists(tree, parent), WIMA_ASSERT_TREE_NODE);
+		wassert((left ? tree->links[parent].left : tree->links[parent].right) == WIMA_AREA_INVALID,
+		        WIMA_ASSERT_TREE_NODE_EXISTS);
+	}
+
+	if (tree->free != WIMA_AREA_INVALID)
+	{
+		node = tree->free;
+		tree->free = tree->links[node].right;
+	}
+	else
+	{
+		// The next index would be WIMA_AREA_INVALID.
+		if (yerror(tree->len >= WIMA_TREE_NODE_MAX)) return WIMA_AREA_INVALID;
+
+		if (yerror(wima_area_tree_reserve(tree, tree->len + 1))) return WIMA_AREA_INVALID;
+
+		node = (WimaAreaNode) tree->len;
+		++(tree->len);
+	}
+
+	WimaArLink* link = tree->links + node;
+
+	link->parent = parent;
+	link->left = WIMA_AREA_INVALID;
+	link->right = WIMA_AREA_INVALID;
+	link->used = true;
+
+	area->node = node;
+	memcpy(tree->areas + node, area, sizeof(WimaAr));
+
+	if (parent != WIMA_AREA_INVALID)
+	{
+		if (left)
+			tree->links[parent].left = node;
+		else
+			tree->links[parent].right = node;
+	}
+
+	++(tree->count);
+
+	return node;
+}
+
+void wima_area_tree_remove(WimaArTree* tree, WimaAreaNode node)
+{
+	wassert(wima_area_tree_exists(tree, node), WIMA_ASSERT_AREA);
+
+	WimaAreaNode parent = tree->links[node].parent;
+
+	if (parent != WIMA_AREA_INVALID)
+	{
+		WimaArLink* plink = tree->links + parent;
+
+		if (plink->left == node)
+			plink->left = WIMA_AREA_INVALID;
+		else
+			plink->right = WIMA_AREA_INVALID;
+	}
+
+	wima_area_tree_removeNode(tree, node);
+}
+
+bool wima_area_tree_exists(WimaArTree* tree, WimaAreaNode node)
+{
+	return node < tree->len && tree->links[node].used;
+}
+
+WimaAr* wima_area_tree_node(WimaArTree* tree, WimaAreaNode node)
+{
+	wassert(wima_area_tree_exists(tree, node), WIMA_ASSERT_AREA);
+	return tree->areas + node;
+}
+
+WimaAreaNode wima_area_tree_left(WimaArTree* tree, WimaAreaNode node)
+{
+	wassert(wima_area_tree_exists(tree, node), WIMA_ASSERT_AREA);
+	return tree->links[node].left;
+}
+
+WimaAreaNode wima_area_tree_right(WimaArTree* tree, WimaAreaNode node)
+{
+	wassert(wima_area_tree_exists(tree, node), WIMA_ASSERT_AREA);
+	return tree->links[node].right;
+}
+
+WimaAreaNode wima_area_tree_parent(WimaArTree* tree, WimaAreaNode node)
+{
+	wassert(wima_area_tree_exists(tree, node), WIMA_ASSERT_AREA);
+	return tree->links[node].parent;
+}
+
+void wima_area_tree_empty(WimaArTree* tree)
+{
+	for (uint32_t i = 0; i < tree->len; ++i)
+	{
+		if (tree->links[i].used) wima_area_destroy(tree->areas + i);
+	}
+
+	tree->len = 0;
+	tree->count = 0;
+	tree->free = WIMA_AREA_INVALID;
+}
+
+DynaStatus wima_area_tree_copy(void* dest, const void* src)
+{
+	WimaArTree* dtree = (WimaArTree*) dest;
+	const WimaArTree* stree = (const WimaArTree*) src;
+
+	memset(dtree, 0, sizeof(WimaArTree));
+	dtree->free = WIMA_AREA_INVALID;
+
+	if (!stree->len) return DYNA_STATUS_SUCCESS;
+
+	if (yerror(wima_area_tree_reserve(dtree, stree->len))) return DYNA_STATUS_MALLOC_FAIL;
+
+	// The nodes stay the same, so the free list
+	// and the links can be copied as they are.
+	memcpy(dtree->links, stree->links, stree->len * sizeof(WimaArLink));
+
+	for (uint32_t i = 0; i < stree->len; ++i)
+	{
+		if (!stree->links[i].used) continue;
+
+		DynaStatus status = wima_area_copy(dtree->areas + i, stree->areas + i);
+
+		if (yerror(status))
+		{
+			for (uint32_t j = 0; j < i; ++j)
+			{
+				if (stree->links[j].used) wima_area_destroy(dtree->areas + j);
+			}
+
+			dtree->len = 0;
+			dtree->count = 0;
+			dtree->free = WIMA_AREA_INVALID;
+
+			return status;
+		}
+	}
+
+	dtree->len = stree->len;
+	dtree->count = stree->count;
+	dtree->free = stree->free;
+
+	return DYNA_STATUS_SUCCESS;
+}
+
+void wima_area_tree_destroy(void* ptr)
+{
+	WimaArTree* tree = (WimaArTree*) ptr;
+
+	wima_area_tree_empty(tree);
+
+	free(tree->areas);
+	free(tree->links);
+
+	memset(tree, 0, sizeof(WimaArTree));
+	tree->free = WIMA_AREA_INVALID;
+}
+
+void wima_area_tree_free(WimaArTree* tree)
+{
+	wima_area_tree_destroy(tree);
+	free(tree);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static WimaStatus wima_area_tree_reserve(WimaArTree* tree, uint32_t cap)
+{
+	if (cap <= tree->cap) return WIMA_STATUS_SUCCESS;
+
+	// Node indices past this do not fit in a
+	// WimaAreaNode, and the math below could wrap.
+	if (yerror(cap > WIMA_TREE_NODE_MAX)) return WIMA_STATUS_MALLOC_ERR;
+
+	uint32_t newCap = tree->cap ? tree->cap * 2 : WIMA_AREA_TREE_MIN_CAP;
+
+	while (newCap < cap) newCap *= 2;
+
+	if (newCap > WIMA_TREE_NODE_MAX) newCap = WIMA_TREE_NODE_MAX;
+
+	WimaAr* areas = realloc(tree->areas, newCap * sizeof(WimaAr));
+	if (yerror(!areas)) return WIMA_STATUS_MALLOC_ERR;
+
+	tree->areas = areas;
+
+	WimaArLink* links = realloc(tree->links, newCap * sizeof(WimaArLink));
+	if (yerror(!links)) return WIMA_STATUS_MALLOC_ERR;
+
+	tree->links = links;
+	tree->cap = newCap;
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+static void wima_area_tree_removeNode(WimaArTree* tree, WimaAreaNode node)
+{
+	WimaArLink* link = tree->links + node;
+
+	if (link->left != WIMA_AREA_INVALID) wima_area_tree_removeNode(tree, link->left);
+	if (link->right != WIMA_AREA_INVALID) wima_area_tree_removeNode(tree, link->right);
+
+	wima_area_destroy(tree->areas + node);
+
+	link->used = false;
+	link->left = WIMA_AREA_INVALID;
+	link->right = tree->free;
+	tree->free = node;
+
+	--(tree->count);
+}
+
+//! @endcond Doxygen suppress.
@@ -42,6 +42,7 @@
 #include "../wima.h"
 
 #include "../areas/area.h"
+#include "../layout/item.h"
 #include "../layout/widget.h"
 #include "../windows/overlay.h"
 #include "../windows/window.h"
@@ -55,7 +56,72 @@
 #include <string.h>
 
 ////////////////////////////////////////////////////////////////////////////////
-// Static functions needed for the menus.
+// Static functions needed for the callbacks.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file callbacks.c
+ */
+
+/**
+ * @defgroup callbacks_internal callbacks_internal
+ * @{
+ */
+
+/**
+ * Puts a new event on the back of @a wwin's queue
+ * and reports an error if that fails.
+ * @param wwin	The window to put the event on.
+ * @param wdgt	The widget associated with the event.
+ * @return		The event to fill in, or NULL on error.
+ */
+static WimaEvent* wima_callback_event(WimaWin* wwin, WimaWidget wdgt);
+
+/**
+ * Puts a new event that has no widget on the
+ * back of @a wwin's queue and reports an error
+ * if that fails.
+ * @param wwin	The window to put the event on.
+ * @return		The event to fill in, or NULL on error.
+ */
+static WimaEvent* wima_callback_windowEvent(WimaWin* wwin);
+
+/**
+ * Returns the event on the back of @a wwin's queue if
+ * a new event of @a type for @a wdgt can be merged
+ * into it. Only mouse position, drag, and scroll events
+ * are merged, and only when they are consecutive, so
+ * ordering against every other event is preserved.
+ * @param wwin	The window whose queue will be checked.
+ * @param type	The type of the new event.
+ * @param wdgt	The widget associated with the new event.
+ * @param mods	The modifiers of the new event.
+ * @param btns	The mouse buttons of the new event.
+ * @return		The event to merge into, or NULL if the
+ *				new event must be pushed on its own.
+ */
+static WimaEvent* wima_callback_coalesce(WimaWin* wwin, WimaEventType type, WimaWidget wdgt, WimaMods mods,
+                                         WimaMouseBtn btns);
+
+/**
+ * Returns whether the sum of two scroll offsets
+ * fits in the range that a scroll event can hold.
+ * @param a	The first offset.
+ * @param b	The second offset.
+ * @return	true if the sum fits, false otherwise.
+ */
+static bool wima_callback_scrollFits(int8_t a, int8_t b) yconst;
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+////////////////////////////////////////////////////////////////////////////////
+// Public functions.
 ////////////////////////////////////////////////////////////////////////////////
 
 void wima_callback_key(GLFWwindow* window, int key, int scancode, int action, int mods)
@@ -107,15 +173,8 @@ void wima_callback_key(GLFWwindow* window, int key, int scancode, int action, in
 		}
 	}
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	WimaEvent* event = wima_callback_event(wwin, wwin->ctx.focus);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_KEY;
 	event->area_key.key.key = wkey;
@@ -123,9 +182,6 @@ void wima_callback_key(GLFWwindow* window, int key, int scancode, int action, in
 	event->area_key.key.action = wact;
 	event->area_key.key.mods = wmods;
 	event->area_key.area = wima_area_mouseOver(WIMA_WIN_AREAS(wwin), wwin->ctx.cursorPos);
-
-	wima_window_setDirty(wwin, false);
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_mouseBtn(GLFWwindow* window, int btn, int action, int mods)
@@ -149,21 +205,9 @@ void wima_callback_mouseBtn(GLFWwindow* window, int btn, int action, int mods)
 
 	wima_window_setMouseBtn(wwin, wbtn, wact);
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
-
 	WimaWidget clickItem = wima_area_findWidget(WIMA_WIN_AREAS(wwin), wwin->ctx.cursorPos, WIMA_EVENT_MOUSE_BTN);
 	wwin->ctx.focus = clickItem;
 
-	wima_window_setDirty(wwin, false);
-
 	if (wact == WIMA_ACTION_PRESS)
 	{
 		wwin->ctx.dragStart = wwin->ctx.cursorPos;
@@ -206,35 +250,23 @@ void wima_callback_mouseBtn(GLFWwindow* window, int btn, int action, int mods)
 		return;
 	}
 
-	wwin->ctx.eventItems[numEvents] = clickItem;
+	WimaEvent* event = wima_callback_event(wwin, clickItem);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_MOUSE_BTN;
 	event->mouse_btn.button = wbtn;
 	event->mouse_btn.action = wact;
 	event->mouse_btn.mods = wmods;
 
-	++(wwin->ctx.eventCount);
-
 	if (wwin->ctx.clicks)
 	{
-		numEvents = wwin->ctx.eventCount;
-
-		if (yerror(numEvents >= WIMA_EVENT_MAX))
-		{
-			wima_error(WIMA_STATUS_EVENT_DROPPED);
-			return;
-		}
-
-		event = wwin->ctx.events + numEvents;
-
-		wwin->ctx.eventItems[numEvents] = clickItem;
+		event = wima_callback_event(wwin, clickItem);
+		if (yerror(!event)) return;
 
 		event->type = WIMA_EVENT_MOUSE_CLICK;
 		event->click.timestamp = ts;
 		event->click.mods = wmods;
 		event->click.clicks = wwin->ctx.clicks;
-
-		++(wwin->ctx.eventCount);
 	}
 }
 
@@ -258,17 +290,19 @@ void wima_callback_mousePos(GLFWwindow* window, double x, double y)
 	wwin->ctx.cursorPos = pos;
 
 	WimaAreaSplit sevent;
-	uint32_t numEvents;
 
 	if (WIMA_WIN_IN_SPLIT_MODE(wwin) || WIMA_WIN_IN_JOIN_MODE(wwin) || wwin->ctx.movingSplit)
 	{
-		wima_window_setDirty(wwin, wwin->ctx.movingSplit);
+		// Moving splits reports its own damage when the drag
+		// is processed. The split and join overlays follow
+		// the cursor, and they can be anywhere.
+		if (!wwin->ctx.movingSplit) wima_window_setDirty(wwin, false);
 	}
 	else
 	{
-		wima_window_setDirty(wwin, false);
+		WimaArTree* areas = WIMA_WIN_AREAS(wwin);
 
-		DynaTree areas = WIMA_WIN_AREAS(wwin);
+		WimaWidget hover = wwin->ctx.hover;
 
 		if (WIMA_WIN_HAS_OVERLAY(wwin) || !wima_area_mouseOnSplit(areas, wwin->ctx.cursorPos, &sevent))
 		{
@@ -280,46 +314,35 @@ void wima_callback_mousePos(GLFWwindow* window, double x, double y)
 
 			wwin->ctx.hover = wima_area_findWidget(areas, pos, WIMA_ITEM_EVENT_MASK);
 
+			if (!wima_widget_compare(hover, wwin->ctx.hover))
+			{
+				wima_window_damageWidget(wwin, hover);
+				wima_window_damageWidget(wwin, wwin->ctx.hover);
+			}
+
 			WimaAreaNode area = wima_area_mouseOver(areas, pos);
 			if (area != wwin->ctx.cursorArea)
 			{
-				numEvents = wwin->ctx.eventCount;
-
-				if (yerror(numEvents >= WIMA_EVENT_MAX))
-				{
-					wima_error(WIMA_STATUS_EVENT_DROPPED);
-					return;
-				}
-
 				// Send the events.
 
 				if (wwin->ctx.cursorArea != WIMA_AREA_INVALID)
 				{
-					e = wwin->ctx.events + numEvents;
+					e = wima_callback_windowEvent(wwin);
+					if (yerror(!e)) return;
 
 					e->type = WIMA_EVENT_AREA_ENTER;
 					e->area_enter.area = wwin->ctx.cursorArea;
 					e->area_enter.enter = false;
-
-					++(wwin->ctx.eventCount);
-					++numEvents;
-				}
-
-				if (yerror(numEvents >= WIMA_EVENT_MAX))
-				{
-					wima_error(WIMA_STATUS_EVENT_DROPPED);
-					return;
 				}
 
 				if (area != WIMA_AREA_INVALID)
 				{
-					e = wwin->ctx.events + numEvents;
+					e = wima_callback_windowEvent(wwin);
+					if (yerror(!e)) return;
 
 					e->type = WIMA_EVENT_AREA_ENTER;
 					e->area_enter.area = area;
 					e->area_enter.enter = true;
-
-					++(wwin->ctx.eventCount);
 				}
 
 				wwin->ctx.cursorArea = area;
@@ -335,56 +358,47 @@ void wima_callback_mousePos(GLFWwindow* window, double x, double y)
 
 			wwin->ctx.hover.widget = -1;
 
-			numEvents = wwin->ctx.eventCount;
-
-			if (yerror(numEvents >= WIMA_EVENT_MAX))
-			{
-				wima_error(WIMA_STATUS_EVENT_DROPPED);
-				return;
-			}
+			wima_window_damageWidget(wwin, hover);
 
 			if (wwin->ctx.cursorArea != WIMA_AREA_INVALID)
 			{
 				// Send an exit area event.
 
-				WimaEvent* e = wwin->ctx.events + numEvents;
+				WimaEvent* e = wima_callback_windowEvent(wwin);
+				if (yerror(!e)) return;
 
 				e->type = WIMA_EVENT_AREA_ENTER;
 				e->area_enter.area = wwin->ctx.cursorArea;
 				e->area_enter.enter = false;
 
-				++(wwin->ctx.eventCount);
-
 				wwin->ctx.cursorArea = WIMA_AREA_INVALID;
 			}
 		}
 	}
 
-	numEvents = wwin->ctx.eventCount;
+	WimaEventType type = wwin->ctx.mouseBtns ? WIMA_EVENT_MOUSE_DRAG : WIMA_EVENT_MOUSE_POS;
 
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
+	// A merged drag only replaces the position; where
+	// the drag started is kept in the context, so the
+	// first start survives any number of merges.
+	WimaEvent* event = wima_callback_coalesce(wwin, type, wwin->ctx.focus, wwin->ctx.mods, wwin->ctx.mouseBtns);
+
+	if (!event)
 	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
+		event = wima_callback_event(wwin, wwin->ctx.focus);
+		if (yerror(!event)) return;
 	}
 
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	event->type = type;
 
-	if (!wwin->ctx.mouseBtns)
-	{
-		event->type = WIMA_EVENT_MOUSE_POS;
+	if (type == WIMA_EVENT_MOUSE_POS)
 		event->pos = pos;
-	}
 	else
 	{
-		event->type = WIMA_EVENT_MOUSE_DRAG;
 		event->drag.button = wwin->ctx.mouseBtns;
 		event->drag.mods = wwin->ctx.mods;
 		event->drag.pos = pos;
 	}
-
-	wwin->ctx.eventItems[numEvents] = wwin->ctx.focus;
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_scroll(GLFWwindow* window, double xoffset, double yoffset)
@@ -406,26 +420,27 @@ void wima_callback_scroll(GLFWwindow* window, double xoffset, double yoffset)
 	wwin->ctx.scroll.x += x;
 	wwin->ctx.scroll.y += y;
 
-	int numEvents = wwin->ctx.eventCount;
+	WimaWidget wih = wima_area_findWidget(WIMA_WIN_AREAS(wwin), wwin->ctx.cursorPos, WIMA_EVENT_SCROLL);
+
+	WimaEvent* event = wima_callback_coalesce(wwin, WIMA_EVENT_SCROLL, wih, wwin->ctx.mods, 0);
 
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
+	// If the sums don't fit, a new event is pushed
+	// instead, so that no scroll distance is lost.
+	if (event && wima_callback_scrollFits(event->scroll.xoffset, x) &&
+	    wima_callback_scrollFits(event->scroll.yoffset, y))
 	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
+		event->scroll.xoffset += x;
+		event->scroll.yoffset += y;
 		return;
 	}
 
-	WimaWidget wih = wima_area_findWidget(WIMA_WIN_AREAS(wwin), wwin->ctx.cursorPos, WIMA_EVENT_SCROLL);
-
-	wwin->ctx.eventItems[numEvents] = wih;
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	event = wima_callback_event(wwin, wih);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_SCROLL;
 	event->scroll.xoffset = x;
 	event->scroll.yoffset = y;
 	event->scroll.mods = wwin->ctx.mods;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_char(GLFWwindow* window, unsigned int code)
@@ -445,23 +460,12 @@ void wima_callback_charMod(GLFWwindow* window, unsigned int code, int mods)
 
 	wwin->ctx.mods = (WimaMods) mods;
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	wwin->ctx.eventItems[numEvents] = wwin->ctx.focus;
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	WimaEvent* event = wima_callback_event(wwin, wwin->ctx.focus);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_CHAR;
 	event->char_event.code = code;
 	event->char_event.mods = wwin->ctx.mods;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_fileDrop(GLFWwindow* window, int filec, const char* filev[])
@@ -478,16 +482,6 @@ void wima_callback_fileDrop(GLFWwindow* window, int filec, const char* filev[])
 
 	WimaWin* wwin = dvec_get(wg.windows, wwh);
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
-
 	DynaVector strs = dvec_createStringVec(filec);
 	if (yerror(!strs))
 	{
@@ -505,10 +499,15 @@ void wima_callback_fileDrop(GLFWwindow* window, int filec, const char* filev[])
 		}
 	}
 
+	WimaEvent* event = wima_callback_windowEvent(wwin);
+	if (yerror(!event))
+	{
+		dvec_free(strs);
+		return;
+	}
+
 	event->type = WIMA_EVENT_FILE_DROP;
 	event->file_drop = strs;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_mouseEnter(GLFWwindow* window, int entered)
@@ -521,44 +520,24 @@ void wima_callback_mouseEnter(GLFWwindow* window, int entered)
 
 	WimaWin* wwin = dvec_get(wg.windows, wwh);
 
-	wima_window_setDirty(wwin, false);
-
-	uint32_t numEvents = wwin->ctx.eventCount;
-
 	if (wg.funcs.enter)
 	{
-		if (yerror(numEvents >= WIMA_EVENT_MAX))
-		{
-			wima_error(WIMA_STATUS_EVENT_DROPPED);
-			return;
-		}
-
-		WimaEvent* event = wwin->ctx.events + numEvents;
+		WimaEvent* event = wima_callback_windowEvent(wwin);
+		if (yerror(!event)) return;
 
 		event->type = WIMA_EVENT_WIN_ENTER;
 		event->mouse_enter = entered ? true : false;
-
-		++(wwin->ctx.eventCount);
-
-		numEvents = wwin->ctx.eventCount;
 	}
 
 	if (!entered && wwin->ctx.cursorArea != WIMA_AREA_INVALID)
 	{
-		if (yerror(wwin->ctx.eventCount >= WIMA_EVENT_MAX))
-		{
-			wima_error(WIMA_STATUS_EVENT_DROPPED);
-			return;
-		}
-
-		WimaEvent* e = wwin->ctx.events + wwin->ctx.eventCount;
+		WimaEvent* e = wima_callback_windowEvent(wwin);
+		if (yerror(!e)) return;
 
 		e->type = WIMA_EVENT_AREA_ENTER;
 		e->area_enter.area = wwin->ctx.cursorArea;
 		e->area_enter.enter = false;
 
-		++(wwin->ctx.eventCount);
-
 		wwin->ctx.cursorArea = WIMA_AREA_INVALID;
 	}
 }
@@ -573,25 +552,14 @@ void wima_callback_windowPos(GLFWwindow* window, int xpos, int ypos)
 
 	WimaWin* wwin = dvec_get(wg.windows, wwh);
 
-	wima_window_setDirty(wwin, false);
-
 	if (!wg.funcs.pos) return;
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	WimaEvent* event = wima_callback_windowEvent(wwin);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_WIN_POS;
 	event->pos.x = xpos;
 	event->pos.y = ypos;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_framebufferSize(GLFWwindow* window, int width, int height)
@@ -623,21 +591,12 @@ void wima_callback_framebufferSize(GLFWwindow* window, int width, int height)
 
 	if (!wg.funcs.fbsize) return;
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	WimaEvent* event = wima_callback_windowEvent(wwin);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_FB_SIZE;
 	event->size.w = width;
 	event->size.h = height;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_windowSize(GLFWwindow* window, int width, int height)
@@ -658,21 +617,12 @@ void wima_callback_windowSize(GLFWwindow* window, int width, int height)
 
 	if (!wg.funcs.winsize) return;
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	WimaEvent* event = wima_callback_windowEvent(wwin);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_WIN_SIZE;
 	event->size.w = width;
 	event->size.h = height;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_windowIconify(GLFWwindow* window, int minimized)
@@ -691,20 +641,11 @@ void wima_callback_windowIconify(GLFWwindow* window, int minimized)
 
 	if (!wg.funcs.minimize) return;
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	WimaEvent* event = wima_callback_windowEvent(wwin);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_WIN_MINIMIZE;
 	event->minimized = isMinimized;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_windowFocus(GLFWwindow* window, int focused)
@@ -727,20 +668,11 @@ void wima_callback_windowFocus(GLFWwindow* window, int focused)
 
 	if (!wg.funcs.focus) return;
 
-	int numEvents = wwin->ctx.eventCount;
-
-	if (yerror(numEvents >= WIMA_EVENT_MAX))
-	{
-		wima_error(WIMA_STATUS_EVENT_DROPPED);
-		return;
-	}
-
-	WimaEvent* event = wwin->ctx.events + numEvents;
+	WimaEvent* event = wima_callback_windowEvent(wwin);
+	if (yerror(!event)) return;
 
 	event->type = WIMA_EVENT_WIN_FOCUS;
 	event->focused = hasFocus;
-
-	++(wwin->ctx.eventCount);
 }
 
 void wima_callback_windowRefresh(GLFWwindow* window)
@@ -774,18 +706,7 @@ void wima_callback_windowClose(GLFWwindow* window)
 
 	if (!close || close(wwh))
 	{
-		WimaWin* wwin = dvec_get(wg.windows, wwh);
-		wima_window_destroy(wwin);
-
-		// Either pop the window from the end,
-		// or set it all as NULL (so we know
-		// we can reuse it later. We do this
-		// instead of popping because we want
-		// all window handles to remain valid.
-		if (wwh == dvec_len(wg.windows) - 1)
-			dvec_pop(wg.windows);
-		else
-			memset(wwin, 0, sizeof(WimaWin));
+		wima_window_remove(wwh);
 	}
 	else
 	{
@@ -866,3 +787,72 @@ void wima_callback_error(int error, const char* desc)
 
 	if (status) wima_error_desc(status, desc);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static WimaEvent* wima_callback_event(WimaWin* wwin, WimaWidget wdgt)
+{
+	WimaEvent* event = wima_event_push(&wwin->events, wdgt);
+
+	// The queue grows, so the only failure is malloc.
+	if (yerror(!event)) wima_error(WIMA_STATUS_MALLOC_ERR);
+
+	return event;
+}
+
+static WimaEvent* wima_callback_windowEvent(WimaWin* wwin)
+{
+	WimaWidget wdgt;
+
+	wdgt.widget = WIMA_WIDGET_INVALID;
+	wdgt.area = WIMA_AREA_INVALID;
+	wdgt.region = WIMA_REGION_INVALID_IDX;
+	wdgt.window = WIMA_WINDOW_INVALID;
+
+	return wima_callback_event(wwin, wdgt);
+}
+
+static WimaEvent* wima_callback_coalesce(WimaWin* wwin, WimaEventType type, WimaWidget wdgt, WimaMods mods,
+                                         WimaMouseBtn btns)
+{
+	WimaWidget last;
+
+	WimaEvent* event = wima_event_last(&wwin->events, &last);
+
+	if (!event || event->type != type || !wima_widget_compare(last, wdgt)) return NULL;
+
+	switch (type)
+	{
+		case WIMA_EVENT_MOUSE_POS:
+			break;
+
+		case WIMA_EVENT_MOUSE_DRAG:
+		{
+			if (event->drag.button != btns || event->drag.mods != mods) return NULL;
+			break;
+		}
+
+		case WIMA_EVENT_SCROLL:
+		{
+			if (event->scroll.mods != mods) return NULL;
+			break;
+		}
+
+		default:
+			return NULL;
+	}
+
+	// Widgets that asked for raw events get every one.
+	if (wdgt.widget != WIMA_WIDGET_INVALID && (wima_widget_ptr(wdgt)->widget.flags & WIMA_ITEM_RAW_EVENTS))
+		return NULL;
+
+	return event;
+}
+
+static bool wima_callback_scrollFits(int8_t a, int8_t b)
+{
+	int sum = a + b;
+	return sum <= INT8_MAX && sum >= INT8_MIN;
+}
@@ -0,0 +1,282 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2018 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Source code for Wima's event queues.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#include <wima/wima.h>
+
+#include "event.h"
+
+#include "../wima.h"
+
+#include "../windows/window.h"
+
+#include <yc/error.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+//! @cond INTERNAL
+
+/**
+ * @file event.c
+ */
+
+/**
+ * @defgroup event_internal event_internal
+ * @{
+ */
+
+/**
+ * Doubles the capacity of @a queue. The events are
+ * moved so that the first one is at index 0.
+ * @param queue	The queue to grow.
+ * @return		true on success, false on malloc failure.
+ */
+static bool wima_event_grow(WimaEventQueue* queue);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+//! @cond Doxygen suppress.
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaEvent* wima_event_push(WimaEventQueue* queue, WimaWidget wdgt)
+{
+	wassert(queue, WIMA_ASSERT_PTR_NULL);
+
+	if (queue->count == queue->cap && yerror(!wima_event_grow(queue))) return NULL;
+
+	// The capacity is a power of 2, so this wraps.
+	uint32_t idx = (queue->head + queue->count) & (queue->cap - 1);
+
+	queue->items[idx] = wdgt;
+
+	++(queue->count);
+
+	return queue->events + idx;
+}
+
+WimaEvent* wima_event_last(WimaEventQueue* queue, WimaWidget* wdgt)
+{
+	wassert(queue, WIMA_ASSERT_PTR_NULL);
+	wassert(wdgt, WIMA_ASSERT_PTR_NULL);
+
+	if (!queue->count) return NULL;
+
+	uint32_t idx = (queue->head + queue->count - 1) & (queue->cap - 1);
+
+	*wdgt = queue->items[idx];
+
+	return queue->events + idx;
+}
+
+bool wima_event_pop(WimaEventQueue* queue, WimaEvent* event, WimaWidget* wdgt)
+{
+	wassert(queue, WIMA_ASSERT_PTR_NULL);
+	wassert(event, WIMA_ASSERT_PTR_NULL);
+	wassert(wdgt, WIMA_ASSERT_PTR_NULL);
+
+	if (!queue->count) return false;
+
+	*event = queue->events[queue->head];
+	*wdgt = queue->items[queue->head];
+
+	queue->head = (queue->head + 1) & (queue->cap - 1);
+	--(queue->count);
+
+	return true;
+}
+
+void wima_event_clear(WimaEventQueue* queue)
+{
+	wassert(queue, WIMA_ASSERT_PTR_NULL);
+
+	queue->head = 0;
+	queue->count = 0;
+}
+
+void wima_event_free(WimaEventQueue* queue)
+{
+	wassert(queue, WIMA_ASSERT_PTR_NULL);
+
+	free(queue->events);
+	free(queue->items);
+
+	memset(queue, 0, sizeof(WimaEventQueue));
+}
+
+WimaStatus wima_event_post(WimaWindow wwh, WimaUserEvent event)
+{
+	WimaUserEventNode* node = malloc(sizeof(WimaUserEventNode));
+	if (yerror(!node)) return WIMA_STATUS_MALLOC_ERR;
+
+	node->window = wwh;
+	node->event = event;
+	node->next = atomic_load_explicit(&wg.userEvents, memory_order_relaxed);
+
+	// On failure, this reloads the current top into next.
+	while (!atomic_compare_exchange_weak_explicit(&wg.userEvents, &node->next, node, memory_order_release,
+	                                              memory_order_relaxed))
+	{
+		continue;
+	}
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+void wima_event_dispatchUser()
+{
+	wima_assert_init;
+
+	// Take the whole stack at once. Because nodes are
+	// never popped one at a time, there is no ABA problem.
+	WimaUserEventNode* node = atomic_exchange_explicit(&wg.userEvents, NULL, memory_order_acquire);
+
+	if (!node) return;
+
+	// The stack is newest first, so reverse it
+	// to keep events in the order they were posted.
+	WimaUserEventNode* prev = NULL;
+
+	while (node)
+	{
+		WimaUserEventNode* next = node->next;
+		node->next = prev;
+		prev = node;
+		node = next;
+	}
+
+	node = prev;
+
+	WimaWidget none;
+	none.widget = WIMA_WIDGET_INVALID;
+	none.area = WIMA_AREA_INVALID;
+	none.region = WIMA_REGION_INVALID_IDX;
+
+	while (node)
+	{
+		WimaUserEventNode* next = node->next;
+
+		// The window may have been closed since
+		// the event was posted. If so, drop it.
+		if (wima_window_valid(node->window))
+		{
+			WimaWin* win = dvec_get(wg.windows, node->window);
+
+			none.window = node->window;
+
+			WimaEvent* event = wima_event_push(&win->events, none);
+
+			if (yerror(!event))
+			{
+				wima_error(WIMA_STATUS_MALLOC_ERR);
+			}
+			else
+			{
+				event->type = WIMA_EVENT_USER;
+				event->user = node->event;
+			}
+		}
+
+		free(node);
+
+		node = next;
+	}
+}
+
+void wima_event_freeUser()
+{
+	WimaUserEventNode* node = atomic_exchange_explicit(&wg.userEvents, NULL, memory_order_acquire);
+
+	while (node)
+	{
+		WimaUserEventNode* next = node->next;
+		free(node);
+		node = next;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool wima_event_grow(WimaEventQueue* queue)
+{
+	uint32_t cap = queue->cap ? queue->cap * 2 : WIMA_EVENT_MAX;
+
+	WimaEvent* events = malloc(cap * sizeof(WimaEvent));
+	if (yerror(!events)) return false;
+
+	WimaWidget* items = malloc(cap * sizeof(WimaWidget));
+	if (yerror(!items))
+	{
+		free(events);
+		return false;
+	}
+
+	// Unwrap the ring. The part from the head to the end
+	// of the old buffer goes first, then the wrapped part.
+	uint32_t first = queue->cap - queue->head;
+	first = first < queue->count ? first : queue->count;
+
+	uint32_t second = queue->count - first;
+
+	if (queue->count)
+	{
+		memcpy(events, queue->events + queue->head, first * sizeof(WimaEvent));
+		memcpy(events + first, queue->events, second * sizeof(WimaEvent));
+
+		memcpy(items, queue->items + queue->head, first * sizeof(WimaWidget));
+		memcpy(items + first, queue->items, second * sizeof(WimaWidget));
+	}
+
+	free(queue->events);
+	free(queue->items);
+
+	queue->events = events;
+	queue->items = items;
+	queue->cap = cap;
+	queue->head = 0;
+
+	return true;
+}
+
+//! @endcond Doxygen suppress.
@@ -46,6 +46,10 @@ extern "C" {
 
 #include <wima/wima.h>
 
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 /**
  * @file event.h
  */
@@ -60,7 +64,8 @@ extern "C" {
 
 /**
  * @def WIMA_EVENT_MAX
- * Max events Wima will process on one frame.
+ * The initial capacity of a window's event queue.
+ * The queue grows past this; it never drops events.
  */
 #define WIMA_EVENT_MAX 64
 
@@ -119,7 +124,10 @@ typedef enum WimaEventType
 	WIMA_EVENT_WIN_MINIMIZE = 1 << 23,
 
 	/// Window focus event.
-	WIMA_EVENT_WIN_FOCUS = 1 << 24
+	WIMA_EVENT_WIN_FOCUS = 1 << 24,
+
+	/// User-defined event.
+	WIMA_EVENT_USER = 1 << 25
 
 } WimaEventType;
 
@@ -197,10 +205,127 @@ typedef struct WimaEvent
 
 		/// A window focused event.
 		bool focused;
+
+		/// A user-defined event.
+		WimaUserEvent user;
 	};
 
 } WimaEvent;
 
+/**
+ * A growable queue of events. This is a ring
+ * buffer, so events are taken off the front
+ * and put on the back without moving any.
+ */
+typedef struct WimaEventQueue
+{
+	/// The events.
+	WimaEvent* events;
+
+	/// The widgets associated with the events.
+	WimaWidget* items;
+
+	/// The capacity. This is always a power of 2.
+	uint32_t cap;
+
+	/// The index of the first event.
+	uint32_t head;
+
+	/// The number of events.
+	uint32_t count;
+
+} WimaEventQueue;
+
+/**
+ * A user event that has been posted, but not yet put
+ * in a window's queue. These form a lock-free stack
+ * that any thread can push onto.
+ */
+typedef struct WimaUserEventNode
+{
+	/// The next node in the stack.
+	struct WimaUserEventNode* next;
+
+	/// The window that the event was posted to.
+	WimaWindow window;
+
+	/// The event.
+	WimaUserEvent event;
+
+} WimaUserEventNode;
+
+/**
+ * Puts an event on the back of @a queue,
+ * growing the queue if necessary.
+ * @param queue	The queue to push onto.
+ * @param wdgt	The widget associated with the event.
+ * @return		A pointer to the event to fill in,
+ *				or NULL on malloc failure.
+ * @pre			@a queue must not be NULL.
+ */
+WimaEvent* wima_event_push(WimaEventQueue* queue, WimaWidget wdgt) yallnonnull;
+
+/**
+ * Returns the event on the back of @a queue, if any,
+ * so that a new event can be merged into it.
+ * @param queue	The queue to query.
+ * @param wdgt	A pointer to return the event's widget in.
+ * @return		The last event, or NULL if the queue is empty.
+ * @pre			@a queue must not be NULL.
+ * @pre			@a wdgt must not be NULL.
+ */
+WimaEvent* wima_event_last(WimaEventQueue* queue, WimaWidget* wdgt) yallnonnull;
+
+/**
+ * Takes the event off the front of @a queue.
+ * @param queue	The queue to pop from.
+ * @param event	A pointer to return the event in.
+ * @param wdgt	A pointer to return the event's widget in.
+ * @return		true if there was an event, false otherwise.
+ * @pre			@a queue must not be NULL.
+ * @pre			@a event must not be NULL.
+ * @pre			@a wdgt must not be NULL.
+ */
+bool wima_event_pop(WimaEventQueue* queue, WimaEvent* event, WimaWidget* wdgt) yallnonnull;
+
+/**
+ * Removes all events from @a queue.
+ * @param queue	The queue to clear.
+ * @pre			@a queue must not be NULL.
+ */
+void wima_event_clear(WimaEventQueue* queue) yallnonnull;
+
+/**
+ * Frees the memory used by @a queue.
+ * @param queue	The queue to free.
+ * @pre			@a queue must not be NULL.
+ */
+void wima_event_free(WimaEventQueue* queue) yallnonnull;
+
+/**
+ * Posts a user event to @a wwh. This is lock-free
+ * and can be called from any thread.
+ * @param wwh	The window to post the event to. This is
+ *				not checked until the event is dispatched.
+ * @param event	The event to post.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+WimaStatus wima_event_post(WimaWindow wwh, WimaUserEvent event);
+
+/**
+ * Moves all posted user events into the queues of
+ * the windows they were posted to. This must be
+ * called on the main thread.
+ */
+void wima_event_dispatchUser(void);
+
+/**
+ * Frees all posted user events that
+ * have not been dispatched yet.
+ */
+void wima_event_freeUser(void);
+
 /**
  * @}
  */
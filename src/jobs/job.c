@@ -0,0 +1,700 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	A work-stealing thread pool.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#include <wima/job.h>
+#include <wima/wima.h>
+
+#include "job.h"
+
+#include "../wima.h"
+
+#include <yc/error.h>
+#include <yc/opt.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions needed by the public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file jobs/job.c
+ */
+
+/**
+ * @defgroup job_internal job_internal
+ * @{
+ */
+
+/**
+ * A job started by @a wima_job_run().
+ */
+typedef struct WimaJobRun
+{
+	/// The job. This must be first so
+	/// that freeing the job frees this.
+	WimaJb job;
+
+	/// The function to run.
+	WimaJobFunc func;
+
+	/// The user pointer.
+	void* data;
+
+} WimaJobRun;
+
+/**
+ * A job started by @a wima_job_post().
+ */
+typedef struct WimaJobPost
+{
+	/// The job. This must be first so
+	/// that freeing the job frees this.
+	WimaJb job;
+
+	/// The function to run.
+	WimaJobResultFunc func;
+
+	/// The user pointer.
+	void* data;
+
+	/// The window to post the result to.
+	WimaWindow wwh;
+
+	/// The type of the user event.
+	uint32_t type;
+
+} WimaJobPost;
+
+/**
+ * A loop started by @a wima_job_parallel().
+ * Each job runs a contiguous range of it.
+ */
+typedef struct WimaJobRange
+{
+	/// The function to call for each iteration.
+	WimaJobRangeFunc func;
+
+	/// The user pointer.
+	void* data;
+
+	/// The number of iterations.
+	size_t count;
+
+	/// The number of jobs the loop is split into.
+	size_t jobs;
+
+} WimaJobRange;
+
+/**
+ * The worker that the current thread is,
+ * or NULL if it is not a worker.
+ */
+static _Thread_local WimaJobWorker* wima_job_worker;
+
+/**
+ * The state for picking workers to steal from.
+ */
+static _Thread_local uint32_t wima_job_seed;
+
+/**
+ * The function that worker threads run.
+ * @param arg	The worker.
+ * @return		NULL.
+ */
+static void* wima_job_main(void* arg);
+
+/**
+ * Queues @a count jobs and wakes workers to run them.
+ * On workers, jobs go in their own deque. Everywhere
+ * else, they go in the shared queue.
+ * @param jobs	The jobs to queue.
+ * @param count	The number of jobs.
+ */
+static void wima_job_submit(WimaJb* jobs[], size_t count);
+
+/**
+ * Finds a job for the current thread to run. Workers
+ * check their own deque first. Then the shared queue
+ * is checked, and then other workers are stolen from.
+ * @return	A job, or NULL if none was found.
+ */
+static WimaJb* wima_job_find(void);
+
+/**
+ * Runs @a job and marks it done.
+ * @param job	The job to run.
+ */
+static void wima_job_execute(WimaJb* job);
+
+/**
+ * Pushes @a job on the bottom of @a deque. This
+ * must only be called by the owner of @a deque.
+ * @param deque	The deque to push onto.
+ * @param job	The job to push.
+ * @return		true if pushed, false if @a deque is full.
+ */
+static bool wima_job_deque_push(WimaJobDeque* deque, WimaJb* job);
+
+/**
+ * Takes a job from the bottom of @a deque. This
+ * must only be called by the owner of @a deque.
+ * @param deque	The deque to take from.
+ * @return		The job, or NULL if @a deque is empty.
+ */
+static WimaJb* wima_job_deque_take(WimaJobDeque* deque);
+
+/**
+ * Steals a job from the top of @a deque.
+ * This can be called by any thread.
+ * @param deque	The deque to steal from.
+ * @return		The job, or NULL if @a deque is
+ *				empty or another thread won.
+ */
+static WimaJb* wima_job_deque_steal(WimaJobDeque* deque);
+
+/**
+ * Runs the iterations in @a data that job @a idx owns.
+ * @param data	The WimaJobRange.
+ * @param idx	The index of the job.
+ */
+static void wima_job_range(void* data, size_t idx);
+
+/**
+ * Runs a job started by @a wima_job_run().
+ * @param data	The WimaJobRun.
+ * @param idx	Unused.
+ */
+static void wima_job_runAdapter(void* data, size_t idx);
+
+/**
+ * Runs a job started by @a wima_job_post()
+ * and posts its result.
+ * @param data	The WimaJobPost.
+ * @param idx	Unused.
+ */
+static void wima_job_postAdapter(void* data, size_t idx);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+////////////////////////////////////////////////////////////////////////////////
+// Public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaStatus wima_job_run(WimaJobFunc func, void* data)
+{
+	wima_assert_init;
+
+	wassert(func, WIMA_ASSERT_JOB_FUNC);
+
+	WimaJobRun* run = malloc(sizeof(WimaJobRun));
+	if (yerror(!run)) return WIMA_STATUS_MALLOC_ERR;
+
+	run->func = func;
+	run->data = data;
+
+	run->job.func = wima_job_runAdapter;
+	run->job.data = run;
+	run->job.idx = 0;
+	run->job.pending = NULL;
+	run->job.owned = true;
+
+	WimaJb* job = &run->job;
+
+	wima_job_submit(&job, 1);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+WimaStatus wima_job_post(WimaWindow wwh, uint32_t type, WimaJobResultFunc func, void* data)
+{
+	wima_assert_init;
+
+	wassert(func, WIMA_ASSERT_JOB_FUNC);
+
+	WimaJobPost* post = malloc(sizeof(WimaJobPost));
+	if (yerror(!post)) return WIMA_STATUS_MALLOC_ERR;
+
+	post->func = func;
+	post->data = data;
+	post->wwh = wwh;
+	post->type = type;
+
+	post->job.func = wima_job_postAdapter;
+	post->job.data = post;
+	post->job.idx = 0;
+	post->job.pending = NULL;
+	post->job.owned = true;
+
+	WimaJb* job = &post->job;
+
+	wima_job_submit(&job, 1);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+WimaStatus wima_job_parallel(size_t count, WimaJobRangeFunc func, void* data)
+{
+	wima_assert_init;
+
+	wassert(func, WIMA_ASSERT_JOB_FUNC);
+
+	if (!count) return WIMA_STATUS_SUCCESS;
+
+	// A few jobs per thread is enough to balance the
+	// load without paying for a job per iteration.
+	size_t numJobs = (wg.jobs.numWorkers + 1) * 4;
+	numJobs = numJobs < count ? numJobs : count;
+
+	WimaJobRange range;
+
+	range.func = func;
+	range.data = data;
+	range.count = count;
+	range.jobs = numJobs;
+
+	// There is no point in queuing the only job.
+	if (numJobs == 1)
+	{
+		wima_job_range(&range, 0);
+		return WIMA_STATUS_SUCCESS;
+	}
+
+	WimaJb* jobs = malloc(numJobs * sizeof(WimaJb));
+	if (yerror(!jobs)) return WIMA_STATUS_MALLOC_ERR;
+
+	WimaJb** ptrs = malloc(numJobs * sizeof(WimaJb*));
+	if (yerror(!ptrs))
+	{
+		free(jobs);
+		return WIMA_STATUS_MALLOC_ERR;
+	}
+
+	atomic_size_t pending;
+	atomic_init(&pending, numJobs);
+
+	for (size_t i = 0; i < numJobs; ++i)
+	{
+		jobs[i].func = wima_job_range;
+		jobs[i].data = &range;
+		jobs[i].idx = i;
+		jobs[i].pending = &pending;
+		jobs[i].owned = false;
+
+		ptrs[i] = jobs + i;
+	}
+
+	wima_job_submit(ptrs, numJobs);
+
+	free(ptrs);
+
+	// Help instead of blocking. This is what lets jobs
+	// call this without deadlocking the pool.
+	while (atomic_load_explicit(&pending, memory_order_acquire))
+	{
+		WimaJb* job = wima_job_find();
+
+		if (job)
+			wima_job_execute(job);
+		else
+			sched_yield();
+	}
+
+	free(jobs);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+uint32_t wima_job_threads()
+{
+	wima_assert_init;
+
+	return wg.jobs.numWorkers;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaStatus wima_job_init()
+{
+	WimaJobPool* pool = &wg.jobs;
+
+	// Leave a CPU for the main thread.
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	uint32_t numWorkers = cpus > 2 ? (uint32_t) (cpus - 1) : 1;
+	numWorkers = numWorkers < WIMA_JOB_MAX_WORKERS ? numWorkers : WIMA_JOB_MAX_WORKERS;
+
+	pool->workers = calloc(numWorkers, sizeof(WimaJobWorker));
+	if (yerror(!pool->workers)) return WIMA_STATUS_MALLOC_ERR;
+
+	if (yerror(pthread_mutex_init(&pool->lock, NULL))) goto wima_job_init_err;
+
+	if (yerror(pthread_cond_init(&pool->cond, NULL)))
+	{
+		pthread_mutex_destroy(&pool->lock);
+		goto wima_job_init_err;
+	}
+
+	pool->initialized = true;
+
+	atomic_init(&pool->queued, 0);
+	atomic_init(&pool->sleeping, 0);
+	atomic_init(&pool->stop, false);
+
+	for (uint32_t i = 0; i < numWorkers; ++i)
+	{
+		WimaJobWorker* worker = pool->workers + i;
+
+		atomic_init(&worker->deque.top, 0);
+		atomic_init(&worker->deque.bottom, 0);
+
+		worker->idx = i;
+
+		if (yerror(pthread_create(&worker->thread, NULL, wima_job_main, worker))) return WIMA_STATUS_INIT_ERR;
+
+		// Only count workers that were started
+		// so that only those are joined.
+		pool->numWorkers = i + 1;
+	}
+
+	return WIMA_STATUS_SUCCESS;
+
+wima_job_init_err:
+
+	// The pool is not initialized yet, so
+	// wima_job_exit() won't free the workers.
+	free(pool->workers);
+	pool->workers = NULL;
+	pool->numWorkers = 0;
+
+	return WIMA_STATUS_INIT_ERR;
+}
+
+void wima_job_exit()
+{
+	WimaJobPool* pool = &wg.jobs;
+
+	if (!pool->initialized) return;
+
+	pthread_mutex_lock(&pool->lock);
+	atomic_store(&pool->stop, true);
+	pthread_cond_broadcast(&pool->cond);
+	pthread_mutex_unlock(&pool->lock);
+
+	// Workers finish all jobs before they exit.
+	for (uint32_t i = 0; i < pool->numWorkers; ++i) pthread_join(pool->workers[i].thread, NULL);
+
+	// If no workers were started, jobs could still be
+	// in the shared queue. They are run here instead.
+	WimaJb* job;
+	while ((job = wima_job_find())) wima_job_execute(job);
+
+	pthread_cond_destroy(&pool->cond);
+	pthread_mutex_destroy(&pool->lock);
+
+	free(pool->workers);
+
+	memset(pool, 0, sizeof(WimaJobPool));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void* wima_job_main(void* arg)
+{
+	WimaJobPool* pool = &wg.jobs;
+	WimaJobWorker* worker = (WimaJobWorker*) arg;
+
+	wima_job_worker = worker;
+	wima_job_seed = worker->idx + 1;
+
+	while (true)
+	{
+		WimaJb* job = wima_job_find();
+
+		if (job)
+		{
+			wima_job_execute(job);
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->lock);
+
+		// Saying that we are sleeping before checking for jobs
+		// means that a thread queuing a job at the same time
+		// either sees us sleeping and wakes us, or we see it.
+		atomic_fetch_add(&pool->sleeping, 1);
+
+		while (!atomic_load(&pool->queued) && !atomic_load(&pool->stop))
+			pthread_cond_wait(&pool->cond, &pool->lock);
+
+		atomic_fetch_sub(&pool->sleeping, 1);
+
+		bool done = atomic_load(&pool->stop) && !atomic_load(&pool->queued);
+
+		pthread_mutex_unlock(&pool->lock);
+
+		if (done) break;
+	}
+
+	wima_job_worker = NULL;
+
+	return NULL;
+}
+
+static void wima_job_submit(WimaJb* jobs[], size_t count)
+{
+	WimaJobPool* pool = &wg.jobs;
+
+	// This is counted first so that workers never sleep while
+	// a job is queued. They may spin briefly until it is.
+	atomic_fetch_add(&pool->queued, count);
+
+	size_t i = 0;
+
+	if (wima_job_worker)
+	{
+		WimaJobDeque* deque = &wima_job_worker->deque;
+
+		while (i < count && wima_job_deque_push(deque, jobs[i])) ++i;
+	}
+
+	if (i < count)
+	{
+		pthread_mutex_lock(&pool->lock);
+
+		for (; i < count; ++i)
+		{
+			jobs[i]->next = NULL;
+
+			if (pool->tail)
+				pool->tail->next = jobs[i];
+			else
+				pool->head = jobs[i];
+
+			pool->tail = jobs[i];
+		}
+
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	if (atomic_load(&pool->sleeping))
+	{
+		pthread_mutex_lock(&pool->lock);
+
+		if (count == 1)
+			pthread_cond_signal(&pool->cond);
+		else
+			pthread_cond_broadcast(&pool->cond);
+
+		pthread_mutex_unlock(&pool->lock);
+	}
+}
+
+static WimaJb* wima_job_find()
+{
+	WimaJobPool* pool = &wg.jobs;
+
+	WimaJb* job = NULL;
+
+	if (wima_job_worker) job = wima_job_deque_take(&wima_job_worker->deque);
+
+	if (!job && atomic_load_explicit(&pool->queued, memory_order_relaxed))
+	{
+		pthread_mutex_lock(&pool->lock);
+
+		job = pool->head;
+
+		if (job)
+		{
+			pool->head = job->next;
+			if (!pool->head) pool->tail = NULL;
+		}
+
+		pthread_mutex_unlock(&pool->lock);
+
+		uint32_t numWorkers = pool->numWorkers;
+
+		// Start at a random worker so that thieves spread out.
+		if (!job && numWorkers)
+		{
+			uint32_t seed = wima_job_seed ? wima_job_seed : (uint32_t) (uintptr_t) &job | 1;
+
+			// xorshift32.
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+
+			wima_job_seed = seed;
+
+			for (uint32_t i = 0; !job && i < numWorkers; ++i)
+			{
+				WimaJobWorker* victim = pool->workers + ((seed + i) % numWorkers);
+
+				if (victim != wima_job_worker) job = wima_job_deque_steal(&victim->deque);
+			}
+		}
+	}
+
+	if (job) atomic_fetch_sub(&pool->queued, 1);
+
+	return job;
+}
+
+static void wima_job_execute(WimaJb* job)
+{
+	// The job cannot be touched after the counter is
+	// decremented because the waiter may free it.
+	atomic_size_t* pending = job->pending;
+	bool owned = job->owned;
+
+	job->func(job->data, job->idx);
+
+	if (owned) free(job);
+
+	if (pending) atomic_fetch_sub_explicit(pending, 1, memory_order_release);
+}
+
+static bool wima_job_deque_push(WimaJobDeque* deque, WimaJb* job)
+{
+	int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+	int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+
+	if (b - t >= WIMA_JOB_DEQUE_CAP) return false;
+
+	atomic_store_explicit(deque->jobs + (b & (WIMA_JOB_DEQUE_CAP - 1)), job, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+
+	return true;
+}
+
+static WimaJb* wima_job_deque_take(WimaJobDeque* deque)
+{
+	int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+
+	atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+	// Empty.
+	if (t > b)
+	{
+		atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+		return NULL;
+	}
+
+	WimaJb* job = atomic_load_explicit(deque->jobs + (b & (WIMA_JOB_DEQUE_CAP - 1)), memory_order_relaxed);
+
+	// This is the last job, so race thieves for it.
+	if (t == b)
+	{
+		if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst,
+		                                             memory_order_relaxed))
+		{
+			job = NULL;
+		}
+
+		atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+	}
+
+	return job;
+}
+
+static WimaJb* wima_job_deque_steal(WimaJobDeque* deque)
+{
+	int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+	if (t >= b) return NULL;
+
+	WimaJb* job = atomic_load_explicit(deque->jobs + (t & (WIMA_JOB_DEQUE_CAP - 1)), memory_order_relaxed);
+
+	if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+		return NULL;
+
+	return job;
+}
+
+static void wima_job_range(void* data, size_t idx)
+{
+	WimaJobRange* range = (WimaJobRange*) data;
+
+	size_t start = idx * range->count / range->jobs;
+	size_t end = (idx + 1) * range->count / range->jobs;
+
+	for (size_t i = start; i < end; ++i) range->func(range->data, i);
+}
+
+static void wima_job_runAdapter(void* data, size_t idx yunused)
+{
+	WimaJobRun* run = (WimaJobRun*) data;
+
+	run->func(run->data);
+}
+
+static void wima_job_postAdapter(void* data, size_t idx yunused)
+{
+	WimaJobPost* post = (WimaJobPost*) data;
+
+	WimaUserEvent event;
+
+	event.type = post->type;
+	event.data = post->func(post->data);
+
+	// There is no thread-safe way to report an
+	// error here, so the result is just dropped.
+	wima_window_postEvent(post->wwh, event);
+}
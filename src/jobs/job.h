@@ -0,0 +1,214 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Data structures for Wima's work-stealing thread pool.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#ifndef WIMA_JOB_PRIVATE_H
+#define WIMA_JOB_PRIVATE_H
+
+/* For C++ compatibility. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @cond INTERNAL
+
+#include <wima/job.h>
+#include <wima/wima.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file jobs/job.h
+ */
+
+/**
+ * @defgroup job_internal job_internal
+ * Internal functions and data structures for jobs.
+ * @{
+ */
+
+/**
+ * @def WIMA_JOB_DEQUE_CAP
+ * The capacity of each worker's deque. Jobs that do
+ * not fit go in the shared queue. This must be a
+ * power of 2.
+ */
+#define WIMA_JOB_DEQUE_CAP (4096)
+
+/**
+ * @def WIMA_JOB_MAX_WORKERS
+ * The max number of worker threads.
+ */
+#define WIMA_JOB_MAX_WORKERS (64)
+
+/**
+ * The function that a job runs. All public
+ * job types are adapted to this.
+ * @param data	The job's data.
+ * @param idx	The job's index.
+ */
+typedef void (*WimaJbFunc)(void* data, size_t idx);
+
+/**
+ * A job.
+ */
+typedef struct WimaJb
+{
+	/// The function to run.
+	WimaJbFunc func;
+
+	/// The data to pass to @a func.
+	void* data;
+
+	/// The index to pass to @a func.
+	size_t idx;
+
+	/// The counter to decrement when the job
+	/// is done, or NULL if nobody waits.
+	atomic_size_t* pending;
+
+	/// The next job in the shared queue.
+	struct WimaJb* next;
+
+	/// Whether the job was allocated by itself
+	/// and should be freed when it is done.
+	bool owned;
+
+} WimaJb;
+
+/**
+ * A Chase-Lev work-stealing deque. The owning worker
+ * pushes and takes at the bottom (LIFO, which is good
+ * for cache); other threads steal from the top (FIFO).
+ */
+typedef struct WimaJobDeque
+{
+	/// The index that thieves steal from.
+	_Atomic(int64_t) top;
+
+	/// The index that the owner pushes to.
+	_Atomic(int64_t) bottom;
+
+	/// The jobs, indexed modulo the capacity.
+	_Atomic(WimaJb*) jobs[WIMA_JOB_DEQUE_CAP];
+
+} WimaJobDeque;
+
+/**
+ * A worker thread.
+ */
+typedef struct WimaJobWorker
+{
+	/// The worker's deque.
+	WimaJobDeque deque;
+
+	/// The thread.
+	pthread_t thread;
+
+	/// The index of the worker.
+	uint32_t idx;
+
+} WimaJobWorker;
+
+/**
+ * The thread pool.
+ */
+typedef struct WimaJobPool
+{
+	/// The workers.
+	WimaJobWorker* workers;
+
+	/// The front of the shared queue, where threads
+	/// that are not workers put jobs. This, and
+	/// @a tail, are protected by @a lock.
+	WimaJb* head;
+
+	/// The back of the shared queue.
+	WimaJb* tail;
+
+	/// The lock for the shared queue and sleeping.
+	pthread_mutex_t lock;
+
+	/// The condition that sleeping workers wait on.
+	pthread_cond_t cond;
+
+	/// The number of jobs that have been queued but not
+	/// yet taken. Workers only sleep when this is 0.
+	atomic_size_t queued;
+
+	/// The number of workers that are sleeping.
+	atomic_uint sleeping;
+
+	/// The number of workers that were started.
+	uint32_t numWorkers;
+
+	/// Whether @a lock and @a cond were initialized.
+	bool initialized;
+
+	/// Whether the workers should exit once
+	/// there are no more jobs.
+	atomic_bool stop;
+
+} WimaJobPool;
+
+/**
+ * Starts the thread pool.
+ * @return	WIMA_STATUS_SUCCESS on success, an
+ *			error code otherwise.
+ */
+WimaStatus wima_job_init(void);
+
+/**
+ * Runs all remaining jobs, then stops
+ * the workers and frees the pool.
+ */
+void wima_job_exit(void);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // WIMA_JOB_PRIVATE_H
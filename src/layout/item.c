@@ -43,9 +43,13 @@
 #include "../props/prop.h"
 #include "../windows/window.h"
 
+#include <yc/error.h>
+
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
-WimaItem* wima_item_ptr(WimaWindow wwh, WimaAreaNode area, WimaRegion reg, uint16_t idx)
+WimaItem* wima_item_ptr(WimaWindow wwh, WimaAreaNode area, WimaRegion reg, uint32_t idx)
 {
 	wima_assert_init;
 	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
@@ -56,14 +60,14 @@ WimaItem* wima_item_ptr(WimaWindow wwh, WimaAreaNode area, WimaRegion reg, uint1
 	{
 		WimaAr* ar = wima_area_ptr(wwh, area);
 		wassert(WIMA_AREA_IS_LEAF(ar), WIMA_ASSERT_AREA_LEAF);
-		wassert(idx < dvec_len(ar->area.items), WIMA_ASSERT_ITEM);
-		item = dvec_get(ar->area.items, idx);
+		wassert(idx < dvec_len(ar->area.items->items), WIMA_ASSERT_ITEM);
+		item = dvec_get(ar->area.items->items, idx);
 	}
 	else
 	{
 		WimaWin* win = dvec_get(wg.windows, wwh);
-		wassert(idx < dvec_len(win->overlayItems), WIMA_ASSERT_ITEM);
-		item = dvec_get(win->overlayItems, idx);
+		wassert(idx < dvec_len(win->overlayItems->items), WIMA_ASSERT_ITEM);
+		item = dvec_get(win->overlayItems->items, idx);
 	}
 
 	return item;
@@ -74,6 +78,9 @@ void wima_item_free(void* item)
 	WimaItem* i = item;
 	if (WIMA_ITEM_IS_LAYOUT(i)) return;
 
+	// Lists free the data of their rows' widgets.
+	if (i->widget.list != WIMA_ITEM_LIST_INVALID) return;
+
 	WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, i->widget.prop);
 
 	if (info->type != WIMA_PROP_PTR) return;
@@ -89,23 +96,147 @@ void wima_item_free(void* item)
 	pfree(dpool_get(pool, &key));
 }
 
-DynaVector wima_item_vector(WimaWindow wwh, WimaAreaNode node, WimaRegion reg)
+WimaItemStore* wima_item_store(WimaWindow wwh, WimaAreaNode node, WimaRegion reg)
 {
-	DynaVector vec;
+	WimaItemStore* store;
 
 	if (ylikely(reg != WIMA_REGION_INVALID_IDX))
 	{
 		WimaAr* area = wima_area_ptr(wwh, node);
-		vec = area->area.items;
+		store = area->area.items;
 	}
 	else
 	{
 		wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
 		WimaWin* win = dvec_get(wg.windows, wwh);
-		vec= win->overlayItems;
+		store = win->overlayItems;
+	}
+
+	return store;
+}
+
+WimaItemStore* wima_item_store_create(DynaDestructFunc destruct)
+{
+	WimaItemStore* store = calloc(1, sizeof(WimaItemStore));
+	if (yerror(!store)) return NULL;
+
+	store->items = dvec_create(0, sizeof(WimaItem), destruct, NULL);
+
+	if (yerror(!store->items))
+	{
+		free(store);
+		return NULL;
+	}
+
+	// The arrays are allocated on the first push.
+	return store;
+}
+
+void wima_item_store_free(WimaItemStore* store)
+{
+	dvec_free(store->items);
+
+	free(store->rects);
+	free(store->minSizes);
+	free(store->flags);
+	free(store->parents);
+	free(store->kids);
+
+	free(store);
+}
+
+uint32_t wima_item_len(WimaItemStore* store)
+{
+	return (uint32_t) dvec_len(store->items);
+}
+
+WimaStatus wima_item_push(WimaItemStore* store, WimaItem* item, uint16_t flags, uint32_t parent)
+{
+	uint32_t idx = wima_item_len(store);
+
+	if (idx == store->cap)
+	{
+		uint32_t cap = store->cap ? store->cap * 2 : WIMA_ITEM_STORE_MIN;
+		void* ptr;
+
+		// If one of these fails, the ones before it are just
+		// bigger than they need to be, and the cap is not set,
+		// so they are all grown again on the next push.
+		ptr = realloc(store->rects, cap * sizeof(WimaRectf));
+		if (yerror(!ptr)) return WIMA_STATUS_MALLOC_ERR;
+		store->rects = ptr;
+
+		ptr = realloc(store->minSizes, cap * sizeof(WimaSizef));
+		if (yerror(!ptr)) return WIMA_STATUS_MALLOC_ERR;
+		store->minSizes = ptr;
+
+		ptr = realloc(store->flags, cap * sizeof(uint16_t));
+		if (yerror(!ptr)) return WIMA_STATUS_MALLOC_ERR;
+		store->flags = ptr;
+
+		ptr = realloc(store->parents, cap * sizeof(uint32_t));
+		if (yerror(!ptr)) return WIMA_STATUS_MALLOC_ERR;
+		store->parents = ptr;
+
+		ptr = realloc(store->kids, cap * sizeof(uint32_t));
+		if (yerror(!ptr)) return WIMA_STATUS_MALLOC_ERR;
+		store->kids = ptr;
+
+		store->cap = cap;
+	}
+
+	if (yerror(dvec_push(store->items, item))) return WIMA_STATUS_MALLOC_ERR;
+
+	memset(store->rects + idx, 0, sizeof(WimaRectf));
+	memset(store->minSizes + idx, 0, sizeof(WimaSizef));
+
+	store->flags[idx] = flags;
+	store->parents[idx] = parent;
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+WimaStatus wima_item_setLength(WimaItemStore* store, uint32_t len)
+{
+	wassert(len <= wima_item_len(store), WIMA_ASSERT_ITEM);
+
+	// The arrays don't have to change; everything
+	// past the length of the items is unused.
+	return dvec_setLength(store->items, len) ? WIMA_STATUS_MALLOC_ERR : WIMA_STATUS_SUCCESS;
+}
+
+void wima_item_finish(WimaItemStore* store, uint32_t root)
+{
+	uint32_t len = wima_item_len(store);
+
+	wassert(root < len, WIMA_ASSERT_ITEM);
+	wassert(store->parents[root] == WIMA_LAYOUT_INVALID, WIMA_ASSERT_ITEM);
+
+	WimaItem* items = dvec_get(store->items, 0);
+
+	// Every item after the root is the kid of exactly one
+	// layout, so the spans take up exactly [root + 1, len).
+	// First, give every layout a span, in item order...
+	uint32_t cursor = root + 1;
+
+	for (uint32_t i = root; i < len; ++i)
+	{
+		if (!items[i].isLayout) continue;
+
+		items[i].layout.firstKid = cursor;
+		cursor += items[i].layout.kidCount;
+		items[i].layout.kidCount = 0;
 	}
 
-	return vec;
+	wassert(cursor == len, WIMA_ASSERT_ITEM);
+
+	// ...then fill them. Kids are added in item order,
+	// which is the order they were added to the layout.
+	for (uint32_t i = root + 1; i < len; ++i)
+	{
+		WimaItem* parent = items + store->parents[i];
+		store->kids[parent->layout.firstKid + parent->layout.kidCount++] = i;
+	}
 }
 
 DynaPool wima_item_pool(WimaWindow wwh, WimaAreaNode node, WimaRegion reg)
@@ -127,7 +258,7 @@ DynaPool wima_item_pool(WimaWindow wwh, WimaAreaNode node, WimaRegion reg)
 }
 
 #ifdef __YASSERT__
-bool wima_item_valid(WimaWindow window, WimaAreaNode node, WimaRegion region, uint16_t idx)
+bool wima_item_valid(WimaWindow window, WimaAreaNode node, WimaRegion region, uint32_t idx)
 {
 	wima_assert_init;
 	wassert(wima_window_valid(window), WIMA_ASSERT_WIN);
@@ -136,6 +267,6 @@ bool wima_item_valid(WimaWindow window, WimaAreaNode node, WimaRegion region, ui
 
 	wassert(win->ctx.stage == WIMA_UI_STAGE_LAYOUT, WIMA_ASSERT_STAGE_LAYOUT);
 
-	return idx < dvec_len(wima_item_vector(window, node, region));
+	return idx < wima_item_len(wima_item_store(window, node, region));
 }
 #endif  // __YASSERT__
@@ -45,6 +45,8 @@ extern "C" {
 #include <wima/layout.h>
 #include <wima/wima.h>
 
+#include "../events/event.h"
+
 #include <dyna/pool.h>
 #include <dyna/vector.h>
 #include <yc/assert.h>
@@ -53,11 +55,11 @@ extern "C" {
 
 // TODO: Remove the defines that are not used.
 
-// These bits, starting at bit 24, can be safely assigned by the
+// These bits, starting at bit 27, can be safely assigned by the
 // application, e.g. as item types, other event types, drop targets, etc.
 // They can be set and queried using wima_ui_item_setFlags() and
 // wima_ui_item_flags()
-#define WIMA_ITEM_USERMASK (0xff000000)
+#define WIMA_ITEM_USERMASK (0xf8000000)
 
 // A special mask passed to wima_ui_item_find().
 #define WIMA_ITEM_ANY (0xffffffff)
@@ -79,6 +81,19 @@ extern "C" {
 	 WIMA_EVENT_CHAR)
 // TODO: Make sure this has all events.
 
+// Item wants every mouse position, drag, and scroll
+// event instead of coalesced ones (bit 26). This is
+// above every event type because widget flags are
+// matched against event types when hit-testing.
+#define WIMA_ITEM_RAW_EVENTS (0x4000000)
+
+// Every event type bit (bits 10-25).
+#define WIMA_ITEM_EVENT_ALL (((WIMA_EVENT_USER << 1) - 1) & ~(WIMA_EVENT_KEY - 1))
+
+_Static_assert(!(WIMA_ITEM_RAW_EVENTS & WIMA_ITEM_EVENT_ALL), "raw events flag overlaps an event type");
+_Static_assert(!(WIMA_ITEM_USERMASK & WIMA_ITEM_EVENT_ALL), "user flags overlap an event type");
+_Static_assert(!(WIMA_ITEM_USERMASK & WIMA_ITEM_RAW_EVENTS), "user flags overlap the raw events flag");
+
 // Item is frozen (bit 19).
 #define WIMA_ITEM_FROZEN_BIT (0x080000)
 
@@ -117,6 +132,20 @@ extern "C" {
  */
 #define WIMA_ITEM_SEP_DIM (12)
 
+/**
+ * @def WIMA_ITEM_LIST_INVALID
+ * The list index of widgets that are
+ * not in a row of a virtual list.
+ */
+#define WIMA_ITEM_LIST_INVALID ((uint32_t) -1)
+
+/**
+ * @def WIMA_ITEM_STORE_MIN
+ * The number of items that an item store
+ * has room for when it first grows.
+ */
+#define WIMA_ITEM_STORE_MIN (64)
+
 // Forward declaration.
 typedef struct WimaAr WimaAr;
 //! @endcond Doxygen suppress.
@@ -148,7 +177,10 @@ typedef union WimaItemInfo
 } WimaItemInfo;
 
 /**
- * A struct storing all data for items.
+ * The data of an item that the layout passes do not
+ * walk over. What they do walk over, the rectangles,
+ * min sizes, flags and links, is in parallel arrays
+ * in the item's @a WimaItemStore instead.
  */
 typedef struct WimaItem
 {
@@ -158,33 +190,17 @@ typedef struct WimaItem
 	/// True if the item is a layout, false otherwise.
 	bool isLayout;
 
-	/// The index to the parent.
-	uint16_t parent;
-
-	/// Index of next sibling with same parent.
-	uint16_t nextSibling;
-
-	/// The minimum size.
-	WimaSizef minSize;
-
-	/// The item's rectangle.
-	WimaRectf rect;
-
 	union
 	{
 		struct WimaLayoutInfo
 		{
-			/// Index of the first kid.
-			uint16_t firstKid;
-
-			/// Index of the last kid.
-			uint16_t lastKid;
+			/// Where the kids start in the kids of the
+			/// item store. This is only set once the
+			/// layout is finished; see @a wima_item_finish().
+			uint32_t firstKid;
 
 			/// The number of kids in this layout.
-			uint16_t kidCount;
-
-			/// Flags for the layout. See @a src/layout.h
-			uint16_t flags;
+			uint32_t kidCount;
 
 			/// The split location or width minimum.
 			float w_min;
@@ -192,16 +208,39 @@ typedef struct WimaItem
 			/// Height minimum.
 			float h_min;
 
-			/// The number of children that can expand
-			/// in the x direction.
-			uint16_t x_expand_children;
-
-			/// The number of children that can expand
-			/// in the y direction.
-			uint16_t y_expand_children;
+			/// The number of children that can expand in
+			/// the direction of the layout (x for rows,
+			/// y for columns). The other direction is
+			/// never needed after sizing.
+			uint32_t expand_children;
 
 		} layout;
 
+		/**
+		 * A virtual list. The first two fields must
+		 * match @a layout so that the children can be
+		 * walked the same way for both.
+		 */
+		struct WimaLytList
+		{
+			/// Where the rows that were built start
+			/// in the kids of the item store.
+			uint32_t firstKid;
+
+			/// The number of rows that were built.
+			uint32_t kidCount;
+
+			/// The index of the list's state in
+			/// its region. See @a WimaArList.
+			uint32_t list;
+
+			/// Where the first row that was built starts,
+			/// relative to the top of the list. This is
+			/// negative when the list is scrolled.
+			float top;
+
+		} list;
+
 		struct WimaWdgt
 		{
 			/// About 27 bits worth of flags.
@@ -210,11 +249,57 @@ typedef struct WimaItem
 			/// The property that this refers to.
 			WimaProperty prop;
 
+			/// The index of the virtual list (@a WimaArList)
+			/// whose row the widget is in, which keeps its
+			/// data, or @a WIMA_ITEM_LIST_INVALID.
+			uint32_t list;
+
 		} widget;
 	};
 
 } WimaItem;
 
+_Static_assert(sizeof(WimaItem) == 32, "WimaItem is not half of a cache line");
+
+/**
+ * The items of an area, or of a window's header and overlays.
+ * The data that the layout passes walk over is kept in
+ * parallel arrays that are indexed by item index, which is
+ * the index in the item's handle, so handles are the same
+ * as for @a items. All of the arrays have room for @a cap
+ * items, and they are only valid up to the length of
+ * @a items.
+ */
+typedef struct WimaItemStore
+{
+	/// The items (@a WimaItem).
+	DynaVector items;
+
+	/// The rectangle of each item,
+	/// relative to its parent.
+	WimaRectf* rects;
+
+	/// The minimum size of each item.
+	WimaSizef* minSizes;
+
+	/// The layout flags of each item (see
+	/// @a src/layout/layout.h); 0 for widgets.
+	uint16_t* flags;
+
+	/// The parent of each item, or
+	/// @a WIMA_LAYOUT_INVALID for roots.
+	uint32_t* parents;
+
+	/// The kids of every layout. The kids of one
+	/// layout are a contiguous span, in order. See
+	/// @a wima_item_finish().
+	uint32_t* kids;
+
+	/// The number of items that the arrays have room for.
+	uint32_t cap;
+
+} WimaItemStore;
+
 /**
  * @def WIMA_ITEM_IS_LAYOUT
  * Tests whether an item is a layout.
@@ -245,7 +330,7 @@ typedef struct WimaItem
  * @pre			@a area must be a leaf area.
  * @pre			@a idx must be within the size of the array.
  */
-WimaItem* wima_item_ptr(WimaWindow wwh, WimaAreaNode area, WimaRegion reg, uint16_t idx) yretnonnull yinline;
+WimaItem* wima_item_ptr(WimaWindow wwh, WimaAreaNode area, WimaRegion reg, uint32_t idx) yretnonnull yinline;
 
 /**
  * Frees the item pointed to by @a item.
@@ -255,14 +340,81 @@ WimaItem* wima_item_ptr(WimaWindow wwh, WimaAreaNode area, WimaRegion reg, uint1
 void wima_item_free(void* item) yallnonnull;
 
 /**
- * Returns the DynaVector that an item in the given
+ * Returns the item store that an item in the given
  * window, area, and region would be in.
  * @param wwh	The window that the item would be in.
  * @param node	The area that the item would be in.
  * @param reg	The region that the item would be in.
- * @return		The DynaVector that the item would be in.
+ * @return		The item store that the item would be in.
+ */
+WimaItemStore* wima_item_store(WimaWindow wwh, WimaAreaNode node, WimaRegion reg) yretnonnull;
+
+/**
+ * Creates an empty item store.
+ * @param destruct	The destructor for items, or NULL.
+ * @return			The new store, or NULL on malloc error.
+ */
+WimaItemStore* wima_item_store_create(DynaDestructFunc destruct);
+
+/**
+ * Frees @a store and all of its items.
+ * @param store	The store to free.
+ * @pre			@a store must not be NULL.
+ */
+void wima_item_store_free(WimaItemStore* store) yallnonnull;
+
+/**
+ * Returns the number of items in @a store.
+ * @param store	The store to query.
+ * @return		The number of items.
+ * @pre			@a store must not be NULL.
+ */
+uint32_t wima_item_len(WimaItemStore* store) yallnonnull yinline;
+
+/**
+ * Pushes @a item onto @a store, with an empty
+ * rectangle and min size, and links it to @a parent.
+ * This does not add it to the kids of @a parent;
+ * that is done by @a wima_item_finish().
+ * @param store		The store to push onto.
+ * @param item		The item to push.
+ * @param flags		The layout flags of the item,
+ *					or 0 for a widget.
+ * @param parent	The index of the parent, or
+ *					@a WIMA_LAYOUT_INVALID for a root.
+ * @return			WIMA_STATUS_SUCCESS on success,
+ *					an error code otherwise.
+ * @pre				@a store must not be NULL.
+ * @pre				@a item must not be NULL.
+ */
+WimaStatus wima_item_push(WimaItemStore* store, WimaItem* item, uint16_t flags, uint32_t parent) yallnonnull;
+
+/**
+ * Truncates @a store to @a len items.
+ * @param store	The store to truncate.
+ * @param len	The new number of items.
+ * @return		WIMA_STATUS_SUCCESS on success,
+ *				an error code otherwise.
+ * @pre			@a store must not be NULL.
+ */
+WimaStatus wima_item_setLength(WimaItemStore* store, uint32_t len) yallnonnull;
+
+/**
+ * Puts the kids of every layout from @a root to the end
+ * of @a store into contiguous spans in the kids array,
+ * in the order that they were added, and sets the
+ * @a firstKid of every layout to the start of its span.
+ * This must be called once all of the items of @a root,
+ * and no others, have been added, and before any of
+ * the layout passes run on them. The spans of @a root
+ * and its posterity take up [root + 1, end) of the kids
+ * array, so the spans of roots before it are left alone.
+ * @param store	The store that @a root is in.
+ * @param root	The index of the root to finish.
+ * @pre			@a store must not be NULL.
+ * @pre			@a root must be the index of a root.
  */
-DynaVector wima_item_vector(WimaWindow wwh, WimaAreaNode node, WimaRegion reg) yretnonnull;
+void wima_item_finish(WimaItemStore* store, uint32_t root) yallnonnull;
 
 /**
  * Returns the DynaPool that would have the widget data
@@ -284,7 +436,7 @@ DynaPool wima_item_pool(WimaWindow wwh, WimaAreaNode node, WimaRegion reg) yretn
  * @param idx		The item index.
  * @return			true if valid, false otherwise.
  */
-bool wima_item_valid(WimaWindow window, WimaAreaNode node, WimaRegion region, uint16_t idx);
+bool wima_item_valid(WimaWindow window, WimaAreaNode node, WimaRegion region, uint32_t idx);
 #endif  // __YASSERT
 
 /**
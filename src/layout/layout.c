@@ -70,74 +70,148 @@
  */
 
 /**
- * A function to adjust a dimension.
- * @param result	The result.
- * @param size		The starting size.
+ * Calculates the size of the layout at @a idx and stores
+ * it in the min sizes of @a store. This is the recursive
+ * part of @a wima_layout_size().
+ * @param store	The item store that the layout is in.
+ * @param idx	The index of the layout.
+ * @return		The size of the layout.
  */
-typedef void (*WimaLayoutAdjustFunc)(WimaSizef*, WimaSizef*);
+static WimaSizef wima_layout_size_node(WimaItemStore* store, uint32_t idx) yallnonnull;
 
 /**
- * Calculates the size of a row. Negative numbers in the size mean
- * that the absolute value is a minimum, but it can grow. Positive
- * numbers mean that it is a hard limit.
- * @param item	The item to calculate the size for.
- * @return		The size of the item.
+ * Calculates the size of the item at @a idx, which
+ * can be a layout or a widget, and stores it in
+ * the min sizes of @a store.
+ * @param store	The item store that the item is in.
+ * @param idx	The index of the item.
  */
-static WimaSizef wima_layout_size_row(WimaItem* item) yallnonnull yinline;
+static void wima_layout_size_kid(WimaItemStore* store, uint32_t idx) yallnonnull yinline;
 
 /**
- * Calculates the size of a column. Negative numbers in the size mean
+ * Calculates the size of a row or column. Negative numbers in the
+ * size mean that the absolute value is a minimum, but it can grow.
+ * Positive numbers mean that it is a hard limit.
+ * @param store	The item store that the layout is in.
+ * @param idx	The index of the layout.
+ * @param row	Whether the layout is a row (true) or a column.
+ * @return		The size of the layout.
+ */
+static WimaSizef wima_layout_size_rowcol(WimaItemStore* store, uint32_t idx, bool row) yallnonnull;
+
+/**
+ * Calculates the size of a split. Negative numbers in the size mean
  * that the absolute value is a minimum, but it can grow. Positive
  * numbers mean that it is a hard limit.
- * @param item	The item to calculate the size for.
- * @return		The size of the item.
+ * @param store	The item store that the layout is in.
+ * @param idx	The index of the layout.
+ * @return		The size of the layout.
  */
-static WimaSizef wima_layout_size_col(WimaItem* item) yallnonnull yinline;
+static WimaSizef wima_layout_size_split(WimaItemStore* store, uint32_t idx) yallnonnull yinline;
 
 /**
- * Calculates the size of a row or column. Negative numbers in the
- * size mean that the absolute value is a minimum, but it can grow.
- * Positive numbers mean that it is a hard limit.
- * @param item		The item to calculate the size for.
- * @param adjust	The adjustment function.
- * @return			The size of the item.
+ * Calculates the size of a virtual list. The width is
+ * the widest row that was built, and the height is one
+ * row, but it can grow.
+ * @param store	The item store that the list is in.
+ * @param idx	The index of the list.
+ * @return		The size of the list.
  */
-static WimaSizef wima_layout_size_rowcol(WimaItem* item, WimaLayoutAdjustFunc adjust) yallnonnull;
+static WimaSizef wima_layout_size_list(WimaItemStore* store, uint32_t idx) yallnonnull;
 
 /**
- * Adjusts for a row.
- * @param result	The result.
- * @param size		The starting size.
+ * Lays out the layout at @a idx. This is the
+ * recursive part of @a wima_layout_layout().
+ * @param store	The item store that the layout is in.
+ * @param idx	The index of the layout.
+ * @return		WIMA_STATUS_SUCCESS on succes,
+ *				an error code otherwise.
  */
-static void wima_layout_row_adjust(WimaSizef* result, WimaSizef* size);
+static WimaStatus wima_layout_layout_node(WimaItemStore* store, uint32_t idx) yallnonnull;
 
 /**
- * Adjusts for a column.
- * @param result	The result.
- * @param size		The starting size.
+ * Lays out the rows of the virtual list at @a idx, one
+ * after the other, starting at the list's top. Rows
+ * keep the heights that they were built with.
+ * @param store	The item store that the list is in.
+ * @param idx	The index of the list.
+ * @return		WIMA_STATUS_SUCCESS on succes,
+ *				an error code otherwise.
  */
-static void wima_layout_col_adjust(WimaSizef* result, WimaSizef* size);
+static WimaStatus wima_layout_layout_list(WimaItemStore* store, uint32_t idx) yallnonnull;
 
 /**
- * Calculates the size of a split. Negative numbers in the size mean
- * that the absolute value is a minimum, but it can grow. Positive
- * numbers mean that it is a hard limit.
- * @param item	The item to calculate the size for.
- * @return		The size of the item.
+ * Returns the row of @a list that is at @a y.
+ * @param list	The list state to query.
+ * @param y		The position to find the row at,
+ *				relative to the top of the first row.
+ * @return		The index of the row at @a y, which
+ *				is the number of rows if @a y is
+ *				past the end.
+ */
+static uint32_t wima_layout_list_row(WimaArList* list, double y) yallnonnull;
+
+/**
+ * Returns where the row @a row of @a list starts.
+ * @param list	The list state to query.
+ * @param row	The row to query. This can be
+ *				the number of rows.
+ * @return		The top of the row, relative to
+ *				the top of the first row.
+ */
+static double wima_layout_list_top(WimaArList* list, uint32_t row) yallnonnull;
+
+/**
+ * Updates the row heights in @a list if @a height,
+ * @a rows, or @a version have changed since the last time.
+ * @param list		The list state to update.
+ * @param rows		The number of rows.
+ * @param rowHeight	The height of every row, if
+ *					@a height is NULL.
+ * @param height	The function to get row heights.
+ * @param version	The version of the row heights.
+ * @return			WIMA_STATUS_SUCCESS on success, an
+ *					error code otherwise.
  */
-static WimaSizef wima_layout_size_split(WimaItem* item) yallnonnull yinline;
+static WimaStatus wima_layout_list_heights(WimaArList* list, uint32_t rows, float rowHeight,
+                                           WimaLayoutRowHeightFunc height, uint32_t version) yallnonnull;
 
 /**
- * Sets the data for children in the parent.
+ * Drops the widget data of the rows of @a list that
+ * are not in [@a first, @a last), the rows that are
+ * about to be built, so that the data of a list
+ * never grows past what is in view. The data of
+ * the rows that are kept is moved to a new pool.
+ * @param list	The list state.
+ * @param first	The first row that will be built.
+ * @param last	One past the last row that will be built.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+static WimaStatus wima_layout_list_evict(WimaArList* list, uint32_t first, uint32_t last) yallnonnull;
+
+/**
+ * Draws all of the widget posterity of the layout at
+ * @a idx. This is the recursive part of @a wima_layout_draw().
+ * @param store	The item store that the layout is in.
+ * @param idx	The index of the layout.
+ * @param ctx	The render context to render with.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+static WimaStatus wima_layout_draw_node(WimaItemStore* store, uint32_t idx, WimaRenderContext* ctx) yallnonnull;
+
+/**
+ * Counts a new child in the parent. The child is put
+ * in the parent's span by @a wima_item_finish().
  * @param parent	The parent whose data will be set.
- * @param area		The area the parent is in.
- * @param idx		The index of the child's info to set.
+ * @param store		The item store the parent is in.
  * @pre				@a parent must be valid.
  * @pre				@a parent is a layout.
  * @pre				@a parent must not be full already.
- * @pre				@a area must not be NULL.
+ * @pre				@a store must not be NULL.
  */
-static void wima_layout_setChildren(WimaLayout parent, DynaVector items, uint32_t idx) yallnonnull;
+static void wima_layout_setChildren(WimaLayout parent, WimaItemStore* store) yallnonnull;
 
 /**
  * @}
@@ -155,23 +229,23 @@ void wima_layout_setEnabled(WimaLayout wlh, bool enabled)
 {
 	wassert(wima_item_valid(wlh.window, wlh.area, wlh.region, wlh.layout), WIMA_ASSERT_LAYOUT);
 
-	WimaItem* layout = wima_layout_ptr(wlh);
+	WimaItemStore* store = wima_item_store(wlh.window, wlh.area, wlh.region);
 
-	wassert(WIMA_ITEM_IS_LAYOUT(layout), WIMA_ASSERT_ITEM_LAYOUT);
+	wassert(store->flags[wlh.layout] & WIMA_LAYOUT_FLAG_LAYOUT, WIMA_ASSERT_ITEM_LAYOUT);
 
-	layout->layout.flags &= ~(WIMA_LAYOUT_ENABLE);
-	layout->layout.flags |= (enabled << WIMA_LAYOUT_ENABLE_BIT);
+	store->flags[wlh.layout] &= ~(WIMA_LAYOUT_ENABLE);
+	store->flags[wlh.layout] |= (enabled << WIMA_LAYOUT_ENABLE_BIT);
 }
 
 bool wima_layout_enabled(WimaLayout wlh)
 {
 	wassert(wima_item_valid(wlh.window, wlh.area, wlh.region, wlh.layout), WIMA_ASSERT_LAYOUT);
 
-	WimaItem* layout = wima_layout_ptr(wlh);
+	WimaItemStore* store = wima_item_store(wlh.window, wlh.area, wlh.region);
 
-	wassert(WIMA_ITEM_IS_LAYOUT(layout), WIMA_ASSERT_ITEM_LAYOUT);
+	wassert(store->flags[wlh.layout] & WIMA_LAYOUT_FLAG_LAYOUT, WIMA_ASSERT_ITEM_LAYOUT);
 
-	return layout->layout.flags & WIMA_LAYOUT_ENABLE;
+	return store->flags[wlh.layout] & WIMA_LAYOUT_ENABLE;
 }
 
 void wima_layout_separator(WimaLayout parent)
@@ -216,10 +290,30 @@ WimaWidget wima_layout_widget(WimaLayout parent, WimaProperty prop)
 	wassert(wima_prop_valid(prop, WIMA_PROP_NO_TYPE), WIMA_ASSERT_PROP);
 	wassert(wima_item_valid(parent.window, parent.area, parent.region, parent.layout), WIMA_ASSERT_LAYOUT);
 
-	DynaVector items = wima_item_vector(parent.window, parent.area, parent.region);
+	WimaItemStore* store = wima_item_store(parent.window, parent.area, parent.region);
 	DynaPool pool = wima_item_pool(parent.window, parent.area, parent.region);
 
-	uint32_t idx = dvec_len(items);
+	WimaArList* list = NULL;
+	uint32_t listIdx = WIMA_ITEM_LIST_INVALID;
+	uint32_t row = 0;
+
+	// Widgets in the rows of a virtual list keep their data
+	// in the list, so it can be dropped with their rows.
+	if (parent.region != WIMA_REGION_INVALID_IDX)
+	{
+		WimaAr* area = wima_area_ptr(parent.window, parent.area);
+		WimaArReg* areg = area->area.regions + parent.region;
+
+		if (areg->building != WIMA_ITEM_LIST_INVALID)
+		{
+			listIdx = areg->building;
+			row = areg->buildRow;
+			list = wima_area_list(area, parent.region, listIdx);
+			pool = list->data;
+		}
+	}
+
+	uint32_t idx = wima_item_len(store);
 
 	wih.widget.widget = idx;
 	wih.widget.area = parent.area;
@@ -263,6 +357,20 @@ WimaWidget wima_layout_widget(WimaLayout parent, WimaProperty prop)
 			WimaWidgetInitDataFunc init;
 			void* ptr;
 
+			// The entry is recorded before the data is
+			// allocated so that data in a list's pool
+			// always has an entry to destroy it by.
+			if (list)
+			{
+				WimaArListData entry;
+
+				entry.key = key;
+				entry.row = row;
+				entry.size = allocSize;
+
+				if (yerror(dvec_push(list->keys, &entry))) goto wima_lyt_wdgt_malloc_err;
+			}
+
 			init = predefined ? wima_prop_predefinedTypes[ptype].funcs.init : cprop->funcs.init;
 
 			if (init)
@@ -274,36 +382,57 @@ WimaWidget wima_layout_widget(WimaLayout parent, WimaProperty prop)
 				// can happen again later.
 				status = init(wih.widget, bytes);
 
-				if (yerror(status)) goto wima_lyt_wdgt_err;
+				if (yerror(status)) goto wima_lyt_wdgt_data_err;
 
 				ptr = dpool_malloc(pool, &key, allocSize);
 
-				if (yerror(!ptr)) goto wima_lyt_wdgt_malloc_err;
+				if (yerror(!ptr)) goto wima_lyt_wdgt_data_malloc_err;
 
 				memcpy(ptr, bytes, allocSize);
 			}
 			else
 			{
 				ptr = dpool_calloc(pool, &key, allocSize);
-				if (yerror(!ptr)) goto wima_lyt_wdgt_malloc_err;
+				if (yerror(!ptr)) goto wima_lyt_wdgt_data_malloc_err;
 			}
 		}
 	}
 
 	item.info = wih;
 	item.isLayout = false;
-	item.parent = parent.layout;
-	item.nextSibling = WIMA_WIDGET_INVALID;
 
 	item.widget.prop = prop;
 	item.widget.flags = flags;
+	item.widget.list = listIdx;
+
+	status = wima_item_push(store, &item, 0, parent.layout);
+	if (yerror(status)) goto wima_lyt_wdgt_err;
 
-	if (yerror(dvec_push(items, &item))) goto wima_lyt_wdgt_malloc_err;
+	status = wima_prop_link(prop, wih.widget);
 
-	wima_layout_setChildren(parent, items, idx);
+	// The item is only put in the parent after it is linked,
+	// so if that fails, popping it takes it out of the tree.
+	if (yerror(status))
+	{
+		dvec_pop(store->items);
+		goto wima_lyt_wdgt_err;
+	}
+
+	wima_layout_setChildren(parent, store);
 
 	return wih.widget;
 
+wima_lyt_wdgt_data_malloc_err:
+
+	status = WIMA_STATUS_MALLOC_ERR;
+
+wima_lyt_wdgt_data_err:
+
+	// Nothing was put in the pool for the entry.
+	if (list) dvec_pop(list->keys);
+
+	goto wima_lyt_wdgt_err;
+
 wima_lyt_wdgt_malloc_err:
 
 	status = WIMA_STATUS_MALLOC_ERR;
@@ -317,6 +446,121 @@ wima_lyt_wdgt_err:
 	return wih.widget;
 }
 
+WimaLayout wima_layout_virtualList(WimaLayout parent, uint16_t flags, uint32_t rows, float rowHeight,
+                                   WimaLayoutRowHeightFunc height, uint32_t version, WimaLayoutRowFunc build)
+{
+	WimaStatus status;
+	WimaLayout wlh;
+	uint32_t idx;
+
+	wima_assert_init;
+
+	wassert(wima_item_valid(parent.window, parent.area, parent.region, parent.layout), WIMA_ASSERT_LAYOUT);
+	wassert(parent.area != WIMA_AREA_INVALID && parent.region != WIMA_REGION_INVALID_IDX,
+	        WIMA_ASSERT_LAYOUT_LIST_REGION);
+	wassert(height || rowHeight > 0.0f, WIMA_ASSERT_LAYOUT_LIST_HEIGHT);
+
+	WimaWin* win = dvec_get(wg.windows, parent.window);
+	WimaAr* area = wima_area_tree_node(WIMA_WIN_AREAS(win), parent.area);
+
+	WimaArList* list = wima_area_list_next(area, parent.region, &idx);
+	if (yerror(!list)) goto wima_lyt_list_malloc_err;
+
+	if (!list->data)
+	{
+		list->data = dpool_create(WIMA_POOL_LOAD, sizeof(uint64_t), NULL, NULL, NULL);
+		if (yerror(!list->data)) goto wima_lyt_list_malloc_err;
+	}
+
+	if (!list->keys)
+	{
+		list->keys = dvec_create(0, sizeof(WimaArListData), NULL, NULL);
+		if (yerror(!list->keys)) goto wima_lyt_list_malloc_err;
+	}
+
+	status = wima_layout_list_heights(list, rows, rowHeight, height, version);
+	if (yerror(status)) goto wima_lyt_list_err;
+
+	list->build = build;
+
+	// The rows could have changed since the last time.
+	list->scroll = wima_clamp(list->scroll, 0.0, wima_fmax(list->total - list->rect.h, 0.0));
+
+	// The list's rectangle is filled in when it is laid out.
+	memset(&list->rect, 0, sizeof(WimaRectf));
+
+	// The list can't be taller than the biggest area in the
+	// size class, and the region is generated again when the
+	// size class changes, so rows for that much are enough.
+	WimaArReg* areg = area->area.regions + parent.region;
+	areg->sized = true;
+
+	double view = (double) ((areg->sizeClass.h + 1) << WIMA_AREA_SIZE_CLASS_SHIFT) / area->area.scale;
+
+	uint32_t first = wima_layout_list_row(list, list->scroll);
+	uint32_t last = wima_layout_list_row(list, list->scroll + view);
+
+	first = first > WIMA_LAYOUT_LIST_OVERSCAN ? first - WIMA_LAYOUT_LIST_OVERSCAN : 0;
+	last = rows - last > WIMA_LAYOUT_LIST_OVERSCAN ? last + WIMA_LAYOUT_LIST_OVERSCAN + 1 : rows;
+
+	status = wima_layout_list_evict(list, first, last);
+	if (yerror(status)) goto wima_lyt_list_err;
+
+	wlh = wima_layout_new(parent, flags | WIMA_LAYOUT_FLAG_LIST, 0.0f);
+	if (yerror(wlh.layout == WIMA_LAYOUT_INVALID)) goto wima_lyt_list_malloc_err;
+
+	WimaItem* item = wima_layout_ptr(wlh);
+
+	item->list.list = idx;
+	// This is relative to the view, so it is small
+	// enough to be a float even when the list is not.
+	item->list.top = (float) (wima_layout_list_top(list, first) - list->scroll);
+
+	// Lists can be nested, so the list
+	// being built is put back after.
+	uint32_t building = areg->building;
+	uint32_t buildRow = areg->buildRow;
+
+	for (uint32_t i = first; i < last; ++i)
+	{
+		WimaLayout row = wima_layout_new(wlh, WIMA_LAYOUT_FLAG_ROW, 0.0f);
+		if (yerror(row.layout == WIMA_LAYOUT_INVALID)) goto wima_lyt_list_malloc_err;
+
+		areg->building = idx;
+		areg->buildRow = i;
+
+		status = build(row, i);
+
+		areg->building = building;
+		areg->buildRow = buildRow;
+
+		if (yerror(status)) goto wima_lyt_list_err;
+
+		// The list is gotten again because building the
+		// row could have moved the lists, and the rects are
+		// gotten from the store because it could have grown.
+		// Nothing else sets a layout's height before layout,
+		// so the list can use it to keep the row's height.
+		list = wima_area_list(area, parent.region, idx);
+		WimaRectf* rect = area->area.items->rects + row.layout;
+		rect->h = (float) (wima_layout_list_top(list, i + 1) - wima_layout_list_top(list, i));
+	}
+
+	return wlh;
+
+wima_lyt_list_malloc_err:
+
+	status = WIMA_STATUS_MALLOC_ERR;
+
+wima_lyt_list_err:
+
+	wima_error(status);
+
+	memset(&wlh, -1, sizeof(WimaLayout));
+
+	return wlh;
+}
+
 WimaOverlay wima_layout_overlay(WimaLayout layout)
 {
 	wassert(wima_item_valid(layout.window, layout.area, layout.region, layout.layout), WIMA_ASSERT_LAYOUT);
@@ -349,7 +593,7 @@ WimaLayout wima_layout_new(WimaLayout parent, uint16_t flags, float split)
 {
 	wima_assert_init;
 
-	DynaVector items = wima_item_vector(parent.window, parent.area, parent.region);
+	WimaItemStore* store = wima_item_store(parent.window, parent.area, parent.region);
 
 	WimaLayout wlh;
 
@@ -357,64 +601,121 @@ WimaLayout wima_layout_new(WimaLayout parent, uint16_t flags, float split)
 	wlh.region = parent.region;
 	wlh.window = parent.window;
 
-	flags |= WIMA_LAYOUT_ENABLE;
+	flags |= WIMA_LAYOUT_ENABLE | WIMA_LAYOUT_FLAG_LAYOUT;
 
-	uint32_t idx = dvec_len(items);
+	uint32_t idx = wima_item_len(store);
 
 	wlh.layout = idx;
 
-	// If the parent is not valid, we don't have to set children
-	// in the parent because it means that we are doing the root,
-	// which doesn't doesn't have a parent to set.
-	if (ylikely(parent.layout != WIMA_LAYOUT_INVALID)) wima_layout_setChildren(parent, items, idx);
-
 	WimaItem playout;
 
 	playout.isLayout = true;
 
 	playout.info.layout = wlh;
-	playout.parent = parent.layout;
-	playout.nextSibling = WIMA_WIDGET_INVALID;
 
 	playout.layout.w_min = split;
 	playout.layout.firstKid = WIMA_WIDGET_INVALID;
-	playout.layout.lastKid = WIMA_LAYOUT_INVALID;
 	playout.layout.kidCount = 0;
-	playout.layout.flags = flags;
 
-	if (yerror(dvec_push(items, &playout))) memset(&wlh, -1, sizeof(WimaLayout));
+	if (yerror(wima_item_push(store, &playout, flags, parent.layout)))
+	{
+		memset(&wlh, -1, sizeof(WimaLayout));
+		return wlh;
+	}
+
+	// If the parent is not valid, we don't have to set children
+	// in the parent because it means that we are doing the root,
+	// which doesn't doesn't have a parent to set.
+	if (ylikely(parent.layout != WIMA_LAYOUT_INVALID)) wima_layout_setChildren(parent, store);
 
 	return wlh;
 }
 
-WimaSizef wima_layout_size(WimaItem* item)
+WimaSizef wima_layout_size(WimaLayout wlh)
+{
+	wima_assert_init;
+
+	WimaItemStore* store = wima_item_store(wlh.window, wlh.area, wlh.region);
+
+	wassert(wlh.layout < wima_item_len(store), WIMA_ASSERT_LAYOUT);
+	wassert(store->flags[wlh.layout] & WIMA_LAYOUT_FLAG_LAYOUT, WIMA_ASSERT_LAYOUT);
+
+	return wima_layout_size_node(store, wlh.layout);
+}
+
+WimaStatus wima_layout_layout(WimaLayout wlh)
 {
 	wima_assert_init;
 
-	switch (item->layout.flags & WIMA_LAYOUT_TYPE_MASK)
+	WimaItemStore* store = wima_item_store(wlh.window, wlh.area, wlh.region);
+
+	wassert(wlh.layout < wima_item_len(store), WIMA_ASSERT_LAYOUT);
+	wassert(store->flags[wlh.layout] & WIMA_LAYOUT_FLAG_LAYOUT, WIMA_ASSERT_LAYOUT);
+
+	return wima_layout_layout_node(store, wlh.layout);
+}
+
+WimaStatus wima_layout_draw(WimaLayout wlh, WimaRenderContext* ctx)
+{
+	WimaItemStore* store = wima_item_store(wlh.window, wlh.area, wlh.region);
+
+	wassert(wlh.layout < wima_item_len(store), WIMA_ASSERT_LAYOUT);
+	wassert(store->flags[wlh.layout] & WIMA_LAYOUT_FLAG_LAYOUT, WIMA_ASSERT_LAYOUT);
+
+	return wima_layout_draw_node(store, wlh.layout, ctx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void wima_layout_setChildren(WimaLayout parent, WimaItemStore* store)
+{
+	wassert(parent.layout < wima_item_len(store), WIMA_ASSERT_LAYOUT);
+
+	WimaItem* pparent = dvec_get(store->items, parent.layout);
+
+	wassert(WIMA_ITEM_IS_LAYOUT(pparent), WIMA_ASSERT_ITEM_LAYOUT);
+	wassert(!(store->flags[parent.layout] & WIMA_LAYOUT_FLAG_SPLIT) || pparent->layout.kidCount < 2,
+	        WIMA_ASSERT_LAYOUT_SPLIT_MAX);
+
+	++(pparent->layout.kidCount);
+}
+
+static WimaSizef wima_layout_size_node(WimaItemStore* store, uint32_t idx)
+{
+	WimaSizef* min = store->minSizes + idx;
+
+	switch (store->flags[idx] & WIMA_LAYOUT_TYPE_MASK)
 	{
 		case WIMA_LAYOUT_FLAG_ROW:
 		{
-			item->minSize = wima_layout_size_row(item);
+			*min = wima_layout_size_rowcol(store, idx, true);
 			break;
 		}
 
 		case WIMA_LAYOUT_FLAG_COL:
 		{
-			item->minSize = wima_layout_size_col(item);
+			*min = wima_layout_size_rowcol(store, idx, false);
 			break;
 		}
 
 		case WIMA_LAYOUT_FLAG_SPLIT:
 		{
-			item->minSize = wima_layout_size_split(item);
+			*min = wima_layout_size_split(store, idx);
 			break;
 		}
 
 		case WIMA_LAYOUT_FLAG_SEP:
 		{
-			item->minSize.w = -WIMA_ITEM_SEP_DIM;
-			item->minSize.h = -WIMA_ITEM_SEP_DIM;
+			min->w = -WIMA_ITEM_SEP_DIM;
+			min->h = -WIMA_ITEM_SEP_DIM;
+			break;
+		}
+
+		case WIMA_LAYOUT_FLAG_LIST:
+		{
+			*min = wima_layout_size_list(store, idx);
 			break;
 		}
 
@@ -425,39 +726,185 @@ WimaSizef wima_layout_size(WimaItem* item)
 		}
 	}
 
-	return item->minSize;
+	return *min;
 }
 
-WimaStatus wima_layout_layout(WimaItem* item)
+static void wima_layout_size_kid(WimaItemStore* store, uint32_t idx)
 {
-	wima_assert_init;
+	if (store->flags[idx] & WIMA_LAYOUT_FLAG_LAYOUT)
+		wima_layout_size_node(store, idx);
+	else
+		wima_widget_size(store, idx);
+}
+
+static WimaSizef wima_layout_size_rowcol(WimaItemStore* store, uint32_t idx, bool row)
+{
+	WimaSizef result;
+
+	WimaItem* item = dvec_get(store->items, idx);
+
+	uint32_t* kids = store->kids + item->layout.firstKid;
+	uint32_t count = item->layout.kidCount;
+
+	// Size the children first. This is the only
+	// part that calls out, and it fills the min
+	// sizes that the next loop reads.
+	for (uint32_t i = 0; i < count; ++i) wima_layout_size_kid(store, kids[i]);
+
+	WimaSizef* mins = store->minSizes;
+
+	float wsum = 0.0f;
+	float hsum = 0.0f;
+	float wmax = 0.0f;
+	float hmax = 0.0f;
+
+	uint32_t xExpand = 0;
+	uint32_t yExpand = 0;
+
+	// Then add them up. This loop has no calls and no
+	// branches, so it can be vectorized. It still has
+	// to gather the min sizes through the span because
+	// kids are not next to each other in the store.
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		WimaSizef size = mins[kids[i]];
+
+		xExpand += size.w < 0.0f;
+		yExpand += size.h < 0.0f;
+
+		float w = fabsf(size.w);
+		float h = fabsf(size.h);
+
+		wsum += w;
+		hsum += h;
+		wmax = w > wmax ? w : wmax;
+		hmax = h > hmax ? h : hmax;
+	}
+
+	// Rows add widths and take the max height,
+	// and columns do the opposite.
+	result.w = row ? wsum : wmax;
+	result.h = row ? hmax : hsum;
+
+	// Only the count along the flow direction is needed
+	// when laying out, so that is the only one stored.
+	item->layout.expand_children = row ? xExpand : yExpand;
+
+	result.w = xExpand ? -result.w : result.w;
+	result.h = yExpand ? -result.h : result.h;
+
+	item->layout.w_min = result.w;
+	item->layout.h_min = result.h;
+
+	return result;
+}
+
+static WimaSizef wima_layout_size_split(WimaItemStore* store, uint32_t idx)
+{
+	WimaSizef result;
+	WimaSizef size;
+
+	WimaItem* item = dvec_get(store->items, idx);
+
+	float split = item->layout.w_min;
+
+	wassert(item->layout.kidCount == 2, WIMA_ASSERT_ITEM);
+
+	uint32_t* kids = store->kids + item->layout.firstKid;
+
+	wima_layout_size_kid(store, kids[0]);
+	size = store->minSizes[kids[0]];
+
+	float val = split != 0.0f ? size.w / split : 0.0f;
+
+	result.w = val;
+	result.h = size.h;
+
+	wima_layout_size_kid(store, kids[1]);
+	size = store->minSizes[kids[1]];
+
+	val = split != 1.0f ? size.w / (1.0f - split) : 0.0f;
+
+	result.w = wima_fmaxf(result.w, val);
+	result.h = wima_fmaxf(result.h, size.h);
+
+	return result;
+}
+
+static WimaSizef wima_layout_size_list(WimaItemStore* store, uint32_t idx)
+{
+	WimaSizef result;
+
+	WimaItem* item = dvec_get(store->items, idx);
 
-	wassert(WIMA_ITEM_IS_LAYOUT(item), WIMA_ASSERT_LAYOUT);
+	uint32_t* kids = store->kids + item->list.firstKid;
+	uint32_t count = item->list.kidCount;
+
+	// Rows are always layouts.
+	for (uint32_t i = 0; i < count; ++i) wima_layout_size_node(store, kids[i]);
+
+	WimaSizef* mins = store->minSizes;
+
+	float wmax = 0.0f;
+	uint32_t xExpand = 0;
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		float w = mins[kids[i]].w;
+
+		xExpand += w < 0.0f;
+
+		w = fabsf(w);
+		wmax = w > wmax ? w : wmax;
+	}
+
+	result.w = xExpand ? -wmax : wmax;
+	result.h = 0.0f;
 
-	uint16_t flags = item->layout.flags & (WIMA_LAYOUT_TYPE_MASK);
+	// A list needs room for one row, but it
+	// should take all of the room it can get.
+	if (count) result.h = -store->rects[kids[0]].h;
+
+	return result;
+}
+
+static WimaStatus wima_layout_layout_node(WimaItemStore* store, uint32_t idx)
+{
+	uint16_t flags = store->flags[idx] & (WIMA_LAYOUT_TYPE_MASK);
+
+	// Lists can be empty, so this is before the check.
+	if (flags & WIMA_LAYOUT_FLAG_LIST) return wima_layout_layout_list(store, idx);
+
+	WimaItem* item = dvec_get(store->items, idx);
 
 	wassert(item->layout.kidCount || (flags & WIMA_LAYOUT_FLAG_SEP), WIMA_ASSERT_LAYOUT_NO_CHILDREN);
 
 	WimaStatus status = WIMA_STATUS_SUCCESS;
 
-	float count = (float) item->layout.kidCount;
+	uint32_t count = item->layout.kidCount;
+
+	wassert(!(flags & WIMA_LAYOUT_FLAG_SPLIT) || count == 2, WIMA_ASSERT_LAYOUT_SPLIT_MAX);
 
-	wassert(!(item->layout.flags & WIMA_LAYOUT_FLAG_SPLIT) || count == 2, WIMA_ASSERT_LAYOUT_SPLIT_MAX);
+	uint32_t* kids = store->kids + item->layout.firstKid;
+	WimaRectf* rects = store->rects;
+	WimaSizef* mins = store->minSizes;
+	uint16_t* kflags = store->flags;
 
-	uint16_t idx = item->layout.firstKid;
+	WimaRectf rect = rects[idx];
 
 	float wextra = 0.0f;
 	float hextra = 0.0f;
 
-	if (item->layout.x_expand_children)
-		wextra = (item->rect.w - item->layout.w_min) / (float) item->layout.x_expand_children;
-
-	if (item->layout.y_expand_children)
-		hextra = (item->rect.h - item->layout.h_min) / (float) item->layout.y_expand_children;
+	if (item->layout.expand_children)
+	{
+		if (flags & WIMA_LAYOUT_FLAG_ROW)
+			wextra = (rect.w - item->layout.w_min) / (float) item->layout.expand_children;
+		else
+			hextra = (rect.h - item->layout.h_min) / (float) item->layout.expand_children;
+	}
 
 	float x, y;
 	float row, col;
-	WimaItem* child;
 
 	x = y = 0.0f;
 
@@ -469,57 +916,73 @@ WimaStatus wima_layout_layout(WimaItem* item)
 
 		col = (float) (!row);
 
-		base.w = (col * item->rect.w) * (row * (item->minSize.w / count));
-		base.h = (row * item->rect.h) + (col * (item->minSize.h / count));
+		base.w = (col * rect.w) * (row * (mins[idx].w / (float) count));
+		base.h = (row * rect.h) + (col * (mins[idx].h / (float) count));
+
+		float rwextra = row * wextra;
+		float chextra = col * hextra;
+
+		// Size the children first. This loop has no calls
+		// and no branches, so it can be vectorized, with the
+		// min sizes gathered and the rects scattered through
+		// the span.
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint32_t kid = kids[i];
+
+			rects[kid].w = base.w + ((mins[kid].w < 0.0f) * rwextra);
+			rects[kid].h = base.h + ((mins[kid].h < 0.0f) * chextra);
+		}
 
-		while (!status && idx != WIMA_WIDGET_INVALID)
+		// Then flow them. This is a running sum, so
+		// it is serial, but it is still a tight loop.
+		for (uint32_t i = 0; i < count; ++i)
 		{
-			child = wima_item_ptr(item->info.layout.window, item->info.layout.area, item->info.layout.region, idx);
+			uint32_t kid = kids[i];
 
-			// Calculate the child's rectangle.
-			child->rect.x = x;
-			child->rect.y = y;
-			child->rect.w = base.w + (((child->minSize.w < 0.0f) * wextra) * row);
-			child->rect.h = base.h + (((child->minSize.h < 0.0f) * hextra) * col);
+			rects[kid].x = x;
+			rects[kid].y = y;
 
-			x += (row * child->rect.w);
-			y += (col * child->rect.h);
+			x += (row * rects[kid].w);
+			y += (col * rects[kid].h);
+		}
 
-			if (WIMA_ITEM_IS_LAYOUT(child) && !(child->layout.flags & WIMA_LAYOUT_FLAG_SEP))
-				status = wima_layout_layout(child);
+		// Then lay out the children that are layouts.
+		for (uint32_t i = 0; !status && i < count; ++i)
+		{
+			uint32_t kid = kids[i];
 
-			idx = child->nextSibling;
+			if ((kflags[kid] & (WIMA_LAYOUT_FLAG_LAYOUT | WIMA_LAYOUT_FLAG_SEP)) == WIMA_LAYOUT_FLAG_LAYOUT)
+				status = wima_layout_layout_node(store, kid);
 		}
 	}
 	else
 	{
-		child = wima_item_ptr(item->info.layout.window, item->info.layout.area, item->info.layout.region, idx);
+		uint32_t kid = kids[0];
 
-		child->rect.x = x;
-		child->rect.y = y;
-		child->rect.w = item->layout.w_min * item->rect.w;
-		child->rect.h = item->rect.h;
+		rects[kid].x = x;
+		rects[kid].y = y;
+		rects[kid].w = item->layout.w_min * rect.w;
+		rects[kid].h = rect.h;
 
-		x = child->rect.w;
+		x = rects[kid].w;
 
-		if (WIMA_ITEM_IS_LAYOUT(child) && !(child->layout.flags & WIMA_LAYOUT_FLAG_SEP))
+		if ((kflags[kid] & (WIMA_LAYOUT_FLAG_LAYOUT | WIMA_LAYOUT_FLAG_SEP)) == WIMA_LAYOUT_FLAG_LAYOUT)
 		{
-			status = wima_layout_layout(child);
+			status = wima_layout_layout_node(store, kid);
 			if (yerror(status)) return status;
 		}
 
-		idx = child->nextSibling;
-		wassert(idx != WIMA_LAYOUT_INVALID, WIMA_ASSERT_ITEM);
-		child = wima_item_ptr(item->info.layout.window, item->info.layout.area, item->info.layout.region, idx);
+		kid = kids[1];
 
-		child->rect.x = x;
-		child->rect.y = y;
-		child->rect.w = item->rect.w - x;
-		child->rect.h = item->rect.h;
+		rects[kid].x = x;
+		rects[kid].y = y;
+		rects[kid].w = rect.w - x;
+		rects[kid].h = rect.h;
 
-		if (WIMA_ITEM_IS_LAYOUT(child) && !(child->layout.flags & WIMA_LAYOUT_FLAG_SEP))
+		if ((kflags[kid] & (WIMA_LAYOUT_FLAG_LAYOUT | WIMA_LAYOUT_FLAG_SEP)) == WIMA_LAYOUT_FLAG_LAYOUT)
 		{
-			status = wima_layout_layout(child);
+			status = wima_layout_layout_node(store, kid);
 			if (yerror(status)) return status;
 		}
 	}
@@ -527,181 +990,222 @@ WimaStatus wima_layout_layout(WimaItem* item)
 	return status;
 }
 
-WimaStatus wima_layout_draw(WimaItem* item, WimaRenderContext* ctx)
+static WimaStatus wima_layout_layout_list(WimaItemStore* store, uint32_t idx)
 {
 	WimaStatus status = WIMA_STATUS_SUCCESS;
-	uint16_t idx = item->layout.firstKid;
 
-	WimaItem* child;
+	WimaItem* item = dvec_get(store->items, idx);
 
-	while (!status && idx != WIMA_WIDGET_INVALID)
-	{
-		child = wima_item_ptr(item->info.layout.window, item->info.layout.area, item->info.layout.region, idx);
+	uint32_t* kids = store->kids + item->list.firstKid;
+	uint32_t count = item->list.kidCount;
 
-		idx = child->nextSibling;
+	WimaRectf* rects = store->rects;
 
-		if (child->layout.flags & WIMA_LAYOUT_FLAG_SEP) continue;
+	float y = item->list.top;
+	float w = rects[idx].w;
 
-		if (WIMA_ITEM_IS_LAYOUT(child))
-		{
-			status = wima_layout_draw(child, ctx);
-		}
-		else
-		{
-			WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, child->widget.prop);
-			WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, child->widget.prop);
-
-			if (info->type <= WIMA_PROP_LAST_PREDEFINED)
-			{
-				status = wima_prop_predefinedTypes[info->type].funcs.draw(child->info.widget, ctx);
-			}
-			else
-			{
-				wassert(data->_ptr.type < dvec_len(wg.customProps), WIMA_ASSERT_PROP_CUSTOM);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		uint32_t kid = kids[i];
 
-				WimaCustProp* prop = dvec_get(wg.customProps, data->_ptr.type);
+		rects[kid].x = 0.0f;
+		rects[kid].y = y;
+		rects[kid].w = w;
 
-				status = prop->funcs.draw(child->info.widget, ctx);
-			}
-		}
+		y += rects[kid].h;
 	}
 
+	for (uint32_t i = 0; !status && i < count; ++i) status = wima_layout_layout_node(store, kids[i]);
+
 	return status;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-// Static functions.
-////////////////////////////////////////////////////////////////////////////////
-
-static void wima_layout_setChildren(WimaLayout parent, DynaVector items, uint32_t idx)
+static uint32_t wima_layout_list_row(WimaArList* list, double y)
 {
-	wassert(parent.layout < dvec_len(items), WIMA_ASSERT_LAYOUT);
+	if (y <= 0.0) return 0;
 
-	WimaItem* pparent = dvec_get(items, parent.layout);
+	if (!list->height) return (uint32_t) wima_fmin(floor(y / list->rowHeight), (double) list->rows);
 
-	wassert(WIMA_ITEM_IS_LAYOUT(pparent), WIMA_ASSERT_ITEM_LAYOUT);
-	wassert(!(pparent->layout.flags & WIMA_LAYOUT_FLAG_SPLIT) || pparent->layout.kidCount < 2,
-	        WIMA_ASSERT_LAYOUT_SPLIT_MAX);
+	double* offsets = dvec_get(list->offsets, 0);
 
-	++(pparent->layout.kidCount);
+	// Find the last row that starts at or before y.
+	uint32_t lo = 0;
+	uint32_t hi = list->rows;
 
-	if (pparent->layout.lastKid != WIMA_LAYOUT_INVALID)
+	while (lo < hi)
 	{
-		WimaItem* pkid = dvec_get(items, pparent->layout.lastKid);
+		uint32_t mid = lo + (hi - lo + 1) / 2;
 
-		pkid->nextSibling = idx;
-		pparent->layout.lastKid = idx;
-	}
-	else
-	{
-		pparent->layout.firstKid = idx;
-		pparent->layout.lastKid = idx;
+		if (offsets[mid] <= y)
+			lo = mid;
+		else
+			hi = mid - 1;
 	}
+
+	return lo;
 }
 
-static WimaSizef wima_layout_size_row(WimaItem* item)
+static double wima_layout_list_top(WimaArList* list, uint32_t row)
 {
-	return wima_layout_size_rowcol(item, wima_layout_row_adjust);
+	wassert(row <= list->rows, WIMA_ASSERT_LAYOUT);
+
+	if (!list->height) return ((double) row) * list->rowHeight;
+
+	return *((double*) dvec_get(list->offsets, row));
 }
 
-static WimaSizef wima_layout_size_col(WimaItem* item)
+static WimaStatus wima_layout_list_heights(WimaArList* list, uint32_t rows, float rowHeight,
+                                           WimaLayoutRowHeightFunc height, uint32_t version)
 {
-	return wima_layout_size_rowcol(item, wima_layout_col_adjust);
+	list->rowHeight = rowHeight;
+
+	if (!height)
+	{
+		if (list->offsets) dvec_free(list->offsets);
+
+		list->offsets = NULL;
+		list->height = NULL;
+		list->rows = rows;
+		list->total = ((double) rows) * rowHeight;
+
+		return WIMA_STATUS_SUCCESS;
+	}
+
+	// Asking for every height is the only part of a list that
+	// depends on its length, so it's only done when needed.
+	if (list->offsets && list->height == height && list->rows == rows && list->version == version)
+		return WIMA_STATUS_SUCCESS;
+
+	if (!list->offsets)
+	{
+		list->offsets = dvec_create(rows + 1, sizeof(double), NULL, NULL);
+		if (yerror(!list->offsets)) return WIMA_STATUS_MALLOC_ERR;
+	}
+
+	if (yerror(dvec_setLength(list->offsets, rows + 1)))
+	{
+		// Make sure that the heights are asked for again.
+		list->height = NULL;
+		return WIMA_STATUS_MALLOC_ERR;
+	}
+
+	double* offsets = dvec_get(list->offsets, 0);
+
+	offsets[0] = 0.0;
+
+	for (uint32_t i = 0; i < rows; ++i) offsets[i + 1] = offsets[i] + wima_fmaxf(height(i), 0.0f);
+
+	list->height = height;
+	list->rows = rows;
+	list->version = version;
+	list->total = offsets[rows];
+
+	return WIMA_STATUS_SUCCESS;
 }
 
-static WimaSizef wima_layout_size_rowcol(WimaItem* item, WimaLayoutAdjustFunc adjust)
+static WimaStatus wima_layout_list_evict(WimaArList* list, uint32_t first, uint32_t last)
 {
-	WimaSizef result;
-	WimaSizef size;
+	size_t len = dvec_len(list->keys);
 
-	result.w = 0.0f;
-	result.h = 0.0f;
+	if (!len) return WIMA_STATUS_SUCCESS;
 
-	uint16_t child = item->layout.firstKid;
+	WimaArListData* entries = dvec_get(list->keys, 0);
 
-	item->layout.x_expand_children = 0;
-	item->layout.y_expand_children = 0;
+	// The pool can't drop one key, so the kept data is moved to a
+	// new pool. If that fails, the old pool is left as it was.
+	DynaPool data = dpool_create(WIMA_POOL_LOAD, sizeof(uint64_t), NULL, NULL, NULL);
+	if (yerror(!data)) return WIMA_STATUS_MALLOC_ERR;
 
-	while (child != WIMA_LAYOUT_INVALID)
+	for (size_t i = 0; i < len; ++i)
 	{
-		WimaItem* chItem =
-		        wima_item_ptr(item->info.layout.window, item->info.layout.area, item->info.layout.region, child);
+		WimaArListData* entry = entries + i;
 
-		if (WIMA_ITEM_IS_LAYOUT(chItem))
-			size = wima_layout_size(chItem);
-		else
-			size = wima_widget_size(chItem);
+		if (entry->row < first || entry->row >= last) continue;
 
-		item->layout.x_expand_children += size.w < 0;
-		item->layout.y_expand_children += size.h < 0;
+		void* ptr = dpool_malloc(data, &entry->key, entry->size);
 
-		adjust(&result, &size);
+		if (yerror(!ptr))
+		{
+			dpool_free(data);
+			return WIMA_STATUS_MALLOC_ERR;
+		}
 
-		child = chItem->nextSibling;
+		memcpy(ptr, dpool_get(list->data, &entry->key), entry->size);
 	}
 
-	result.w = item->layout.x_expand_children ? -result.w : result.w;
-	result.h = item->layout.y_expand_children ? -result.h : result.h;
+	size_t kept = 0;
 
-	item->layout.w_min = result.w;
-	item->layout.h_min = result.h;
+	for (size_t i = 0; i < len; ++i)
+	{
+		WimaArListData* entry = entries + i;
 
-	return result;
-}
+		if (entry->row < first || entry->row >= last)
+			wima_widget_destroy(list->data, &entry->key);
+		else
+			entries[kept++] = *entry;
+	}
 
-static void wima_layout_row_adjust(WimaSizef* result, WimaSizef* size)
-{
-	result->w += fabsf(size->w);
-	result->h = wima_fmaxf(result->h, fabsf(size->h));
-}
+	dpool_free(list->data);
+	list->data = data;
 
-static void wima_layout_col_adjust(WimaSizef* result, WimaSizef* size)
-{
-	result->w = wima_fmaxf(result->w, fabsf(size->w));
-	result->h += fabsf(size->h);
+	// This can't fail because the vector is only shrinking.
+	dvec_setLength(list->keys, kept);
+
+	return WIMA_STATUS_SUCCESS;
 }
 
-static WimaSizef wima_layout_size_split(WimaItem* item)
+static WimaStatus wima_layout_draw_node(WimaItemStore* store, uint32_t idx, WimaRenderContext* ctx)
 {
-	WimaSizef result;
-	WimaSizef size;
+	WimaStatus status = WIMA_STATUS_SUCCESS;
 
-	WimaWindow window = item->info.layout.window;
-	WimaAreaNode node = item->info.layout.area;
-	WimaRegion region = item->info.layout.region;
-	float split = item->layout.w_min;
+	WimaItem* items = dvec_get(store->items, 0);
+	WimaItem* item = items + idx;
 
-	uint16_t child = item->layout.firstKid;
+	uint32_t* kids = store->kids + item->layout.firstKid;
+	uint32_t count = item->layout.kidCount;
 
-	wassert(child != WIMA_LAYOUT_INVALID, WIMA_ASSERT_ITEM);
+	bool list = (store->flags[idx] & WIMA_LAYOUT_FLAG_LIST) != 0;
 
-	WimaItem* chItem = wima_item_ptr(window, node, region, child);
+	for (uint32_t i = 0; !status && i < count; ++i)
+	{
+		uint32_t kid = kids[i];
 
-	wassert(chItem->nextSibling != WIMA_LAYOUT_INVALID, WIMA_ASSERT_ITEM);
+		if (store->flags[kid] & WIMA_LAYOUT_FLAG_SEP) continue;
 
-	if (WIMA_ITEM_IS_LAYOUT(chItem))
-		size = wima_layout_size(chItem);
-	else
-		size = wima_widget_size(chItem);
+		// Rows in the overscan are built, but not seen.
+		if (list && !WIMA_LAYOUT_LIST_SHOWS(store->rects[idx], store->rects[kid])) continue;
 
-	float val = split != 0.0f ? size.w / split : 0.0f;
+		WimaItem* child = items + kid;
 
-	result.w = val;
-	result.h = size.h;
+		if (WIMA_ITEM_IS_LAYOUT(child))
+		{
+			status = wima_layout_draw_node(store, kid, ctx);
+		}
+		else
+		{
+			WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, child->widget.prop);
+			WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, child->widget.prop);
 
-	WimaItem* chItem2 = wima_item_ptr(window, node, region, chItem->nextSibling);
+			uint64_t span = wima_trace_begin();
 
-	if (WIMA_ITEM_IS_LAYOUT(chItem2))
-		size = wima_layout_size(chItem2);
-	else
-		size = wima_widget_size(chItem2);
+			if (info->type <= WIMA_PROP_LAST_PREDEFINED)
+			{
+				status = wima_prop_predefinedTypes[info->type].funcs.draw(child->info.widget, ctx);
+			}
+			else
+			{
+				wassert(data->_ptr.type < dvec_len(wg.customProps), WIMA_ASSERT_PROP_CUSTOM);
 
-	val = split != 1.0f ? size.w / (1.0f - split) : 0.0f;
+				WimaCustProp* prop = dvec_get(wg.customProps, data->_ptr.type);
 
-	result.w = wima_fmaxf(result.w, val);
-	result.h = wima_fmaxf(result.h, size.h);
+				status = prop->funcs.draw(child->info.widget, ctx);
+			}
 
-	return result;
+			wima_trace_end(span, "widget: draw", child->widget.prop);
+		}
+	}
+
+	return status;
 }
 
 //! @endcond Doxygen suppress.
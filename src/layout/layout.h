@@ -100,6 +100,17 @@ typedef enum WimaLayoutStage
 //#define WIMA_LAYOUT_ROW_FLOW    (1 << 10)
 //#define WIMA_LAYOUT_COL_FLOW    (1 << 11)
 
+/**
+ * A flag indicating whether a layout is a virtual list.
+ */
+#define WIMA_LAYOUT_FLAG_LIST (1 << 12)
+
+/**
+ * A flag that is set on every layout, so that
+ * the flags alone tell layouts from widgets.
+ */
+#define WIMA_LAYOUT_FLAG_LAYOUT (1 << 14)
+
 /**
  * The bit number for the enable bit.
  */
@@ -115,7 +126,29 @@ typedef enum WimaLayoutStage
  * A mask for getting just the bits that
  * indicate layout type.
  */
-#define WIMA_LAYOUT_TYPE_MASK (WIMA_LAYOUT_FLAG_ROW | WIMA_LAYOUT_FLAG_COL | WIMA_LAYOUT_FLAG_SPLIT | WIMA_LAYOUT_FLAG_SEP)
+#define WIMA_LAYOUT_TYPE_MASK                                                                      \
+	(WIMA_LAYOUT_FLAG_ROW | WIMA_LAYOUT_FLAG_COL | WIMA_LAYOUT_FLAG_SPLIT | WIMA_LAYOUT_FLAG_SEP | \
+	 WIMA_LAYOUT_FLAG_LIST)
+
+/**
+ * @def WIMA_LAYOUT_LIST_OVERSCAN
+ * The number of rows above and below the view
+ * that a virtual list builds, so that rows are
+ * ready before they scroll into view.
+ */
+#define WIMA_LAYOUT_LIST_OVERSCAN (4)
+
+/**
+ * @def WIMA_LAYOUT_LIST_SHOWS
+ * Tests whether any of @a row is inside @a list.
+ * Rows that are not are neither drawn nor hit.
+ * @param list	The rectangle of the virtual list.
+ * @param row	The rectangle of the row, which
+ *				must be a child of @a list.
+ * @return		true if @a row can be seen,
+ *				false otherwise.
+ */
+#define WIMA_LAYOUT_LIST_SHOWS(list, row) ((row).y < (list).h && (row).y + (row).h > 0.0f)
 
 /**
  * Gets the pointer to a layout's data.
@@ -136,31 +169,33 @@ WimaItem* wima_layout_ptr(WimaLayout wlh) yinline yretnonnull;
 WimaLayout wima_layout_new(WimaLayout parent, uint16_t flags, float split);
 
 /**
- * Calculates the size of the layout represented by @a item and
- * stores it in the field @a min of @a item.
- * @param item	The layout whose size will be calculated.
- * @return		The size of the layout that @a item represents.
+ * Calculates the size of @a wlh and stores it in
+ * the min sizes of its item store.
+ * @param wlh	The layout whose size will be calculated.
+ * @return		The size of @a wlh.
+ * @pre			@a wlh must be a root that was
+ *				finished with @a wima_item_finish().
  */
-WimaSizef wima_layout_size(WimaItem* item) yallnonnull;
+WimaSizef wima_layout_size(WimaLayout wlh);
 
 /**
- * Lays out the layout that @a item points to.
- * @param item	The layout to lay out.
+ * Lays out @a wlh, which must have been sized
+ * with @a wima_layout_size() and given a rectangle.
+ * @param wlh	The layout to lay out.
  * @return		WIMA_STATUS_SUCCESS on succes,
  *				an error code otherwise.
  */
-WimaStatus wima_layout_layout(WimaItem* item) yallnonnull;
+WimaStatus wima_layout_layout(WimaLayout wlh);
 
 /**
- * Draws all of the widget posterity of @a item.
- * @param item	The item whose widget posterity will be drawn.
+ * Draws all of the widget posterity of @a wlh.
+ * @param wlh	The layout whose widget posterity will be drawn.
  * @param ctx	The render context to render with.
  * @return		WIMA_STATUS_SUCCESS on success, an error code
  *				otherwise.
- * @pre			@a item must not be NULL.
  * @pre			@a ctx must not be NULL.
  */
-WimaStatus wima_layout_draw(WimaItem* item, WimaRenderContext* ctx) yallnonnull;
+WimaStatus wima_layout_draw(WimaLayout wlh, WimaRenderContext* ctx) yallnonnull;
 
 /**
  * @}
@@ -91,7 +91,12 @@ void* wima_widget_data(WimaWidget wdgt)
 	if (ylikely(wdgt.region != WIMA_REGION_INVALID_IDX))
 	{
 		WimaAr* area = wima_area_ptr(wdgt.window, wdgt.area);
-		pool = area->area.widgetData;
+
+		// Widgets in list rows keep their data in the list.
+		if (item->widget.list != WIMA_ITEM_LIST_INVALID)
+			pool = wima_area_list(area, wdgt.region, item->widget.list)->data;
+		else
+			pool = area->area.widgetData;
 	}
 	else
 	{
@@ -105,17 +110,44 @@ void* wima_widget_data(WimaWidget wdgt)
 bool wima_widget_inOverlay(WimaWidget wdgt)
 {
 	wassert(wima_window_valid(wdgt.window), WIMA_ASSERT_WIN);
-	wassert(wdgt.widget < dvec_len(((WimaWin*) dvec_get(wg.windows, wdgt.window))->overlayItems), WIMA_ASSERT_LAYOUT);
+	wassert(wdgt.widget < wima_item_len(((WimaWin*) dvec_get(wg.windows, wdgt.window))->overlayItems),
+	        WIMA_ASSERT_LAYOUT);
 	return wdgt.region == WIMA_REGION_INVALID_IDX && wdgt.area != WIMA_AREA_INVALID;
 }
 
 bool wima_widget_inHeader(WimaWidget wdgt)
 {
 	wassert(wima_window_valid(wdgt.window), WIMA_ASSERT_WIN);
-	wassert(wdgt.widget < dvec_len(((WimaWin*) dvec_get(wg.windows, wdgt.window))->overlayItems), WIMA_ASSERT_LAYOUT);
+	wassert(wdgt.widget < wima_item_len(((WimaWin*) dvec_get(wg.windows, wdgt.window))->overlayItems),
+	        WIMA_ASSERT_LAYOUT);
 	return wdgt.region == WIMA_REGION_INVALID_IDX && wdgt.area == WIMA_AREA_INVALID;
 }
 
+void wima_widget_setRawEvents(WimaWidget wdgt, bool raw)
+{
+	wima_assert_init;
+
+	WimaItem* pwdgt = wima_widget_ptr(wdgt);
+
+	wassert(WIMA_ITEM_IS_WIDGET(pwdgt), WIMA_ASSERT_ITEM_WIDGET);
+
+	if (raw)
+		pwdgt->widget.flags |= WIMA_ITEM_RAW_EVENTS;
+	else
+		pwdgt->widget.flags &= ~(WIMA_ITEM_RAW_EVENTS);
+}
+
+bool wima_widget_rawEvents(WimaWidget wdgt)
+{
+	wima_assert_init;
+
+	WimaItem* pwdgt = wima_widget_ptr(wdgt);
+
+	wassert(WIMA_ITEM_IS_WIDGET(pwdgt), WIMA_ASSERT_ITEM_WIDGET);
+
+	return pwdgt->widget.flags & WIMA_ITEM_RAW_EVENTS;
+}
+
 void wima_widget_setEnabled(WimaWidget wdgt, bool enable)
 {
 	wima_assert_init;
@@ -149,8 +181,10 @@ void wima_widget_setSize(WimaWidget wdgt, WimaSize size)
 
 	wassert(WIMA_ITEM_IS_WIDGET(pwdgt), WIMA_ASSERT_ITEM_WIDGET);
 
-	pwdgt->rect.w = size.w;
-	pwdgt->rect.h = size.h;
+	WimaRectf* rect = wima_item_store(wdgt.window, wdgt.area, wdgt.region)->rects + wdgt.widget;
+
+	rect->w = size.w;
+	rect->h = size.h;
 
 	if (!size.w)
 		pwdgt->widget.flags &= ~WIMA_ITEM_HFIXED;
@@ -171,7 +205,7 @@ int wima_widget_width(WimaWidget wdgt)
 
 	wassert(WIMA_ITEM_IS_WIDGET(pwdgt), WIMA_ASSERT_ITEM_WIDGET);
 
-	return pwdgt->rect.w;
+	return wima_item_store(wdgt.window, wdgt.area, wdgt.region)->rects[wdgt.widget].w;
 }
 
 int wima_widget_height(WimaWidget wdgt)
@@ -182,7 +216,7 @@ int wima_widget_height(WimaWidget wdgt)
 
 	wassert(WIMA_ITEM_IS_WIDGET(pwdgt), WIMA_ASSERT_ITEM_WIDGET);
 
-	return pwdgt->rect.h;
+	return wima_item_store(wdgt.window, wdgt.area, wdgt.region)->rects[wdgt.widget].h;
 }
 
 void wima_widget_setLayout(WimaWidget wdgt, uint32_t flags)
@@ -266,7 +300,7 @@ WimaRectf wima_widget_rect(WimaWidget wdgt)
 
 	wassert(WIMA_ITEM_IS_WIDGET(pwdgt), WIMA_ASSERT_ITEM_WIDGET);
 
-	return pwdgt->rect;
+	return wima_item_store(wdgt.window, wdgt.area, wdgt.region)->rects[wdgt.widget];
 }
 
 uint32_t wima_widget_events(WimaWidget wdgt)
@@ -410,8 +444,10 @@ void wima_widget_destroy(DynaPool pool, void* key)
 	}
 }
 
-WimaSizef wima_widget_size(WimaItem* item)
+WimaSizef wima_widget_size(WimaItemStore* store, uint32_t idx)
 {
+	WimaItem* item = dvec_get(store->items, idx);
+
 	wassert(wima_prop_valid(item->widget.prop, WIMA_PROP_NO_TYPE), WIMA_ASSERT_PROP);
 
 	WimaProperty prop = item->widget.prop;
@@ -434,9 +470,9 @@ WimaSizef wima_widget_size(WimaItem* item)
 		sizeFunc = cprop->funcs.size;
 	}
 
-	item->minSize = sizeFunc(item->info.widget);
+	store->minSizes[idx] = sizeFunc(item->info.widget);
 
-	return item->minSize;
+	return store->minSizes[idx];
 }
 
 void wima_widget_key(WimaWidget wdgt, WimaKeyEvent event)
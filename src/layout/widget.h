@@ -91,8 +91,9 @@ extern "C" {
 // End limits.
 
 //! @cond Doxygen suppress
-// Forward declaration.
+// Forward declarations.
 typedef struct WimaItem WimaItem;
+typedef struct WimaItemStore WimaItemStore;
 //! @endcond Doxygen suppress
 
 /**
@@ -122,12 +123,13 @@ WimaItem* wima_widget_ptr(WimaWidget wdgt) yretnonnull yinline;
 void wima_widget_destroy(DynaPool pool, void* key) yallnonnull;
 
 /**
- * Returns the size of the widget that @a item points to and
- * stores it in the field @a min of @a item.
- * @param item	The widget to calculate the size of.
- * @return		The size of the widget at @a item.
+ * Returns the size of the widget at @a idx and
+ * stores it in the min sizes of @a store.
+ * @param store	The item store that the widget is in.
+ * @param idx	The index of the widget.
+ * @return		The size of the widget.
  */
-WimaSizef wima_widget_size(WimaItem* item) yallnonnull;
+WimaSizef wima_widget_size(WimaItemStore* store, uint32_t idx) yallnonnull;
 
 /**
  * Handles a key event on @a wdgt.
@@ -141,3 +141,35 @@ uint8_t wima_uint8_bits(register uint8_t x)
 
 	return x;
 }
+
+bool wima_rect_empty(WimaRect r)
+{
+	return r.w <= 0 || r.h <= 0;
+}
+
+WimaRect wima_rect_union(WimaRect a, WimaRect b)
+{
+	if (wima_rect_empty(a)) return b;
+	if (wima_rect_empty(b)) return a;
+
+	WimaRect r;
+
+	r.x = a.x < b.x ? a.x : b.x;
+	r.y = a.y < b.y ? a.y : b.y;
+
+	int ax = a.x + a.w;
+	int bx = b.x + b.w;
+	int ay = a.y + a.h;
+	int by = b.y + b.h;
+
+	r.w = (ax > bx ? ax : bx) - r.x;
+	r.h = (ay > by ? ay : by) - r.y;
+
+	return r;
+}
+
+bool wima_rect_intersects(WimaRect a, WimaRect b)
+{
+	return !wima_rect_empty(a) && !wima_rect_empty(b) && a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h &&
+	       b.y < a.y + a.h;
+}
@@ -44,8 +44,11 @@ extern "C" {
 
 //! @cond INTERNAL
 
+#include <wima/wima.h>
+
 #include <yc/opt.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 /**
@@ -73,6 +76,30 @@ uint8_t wima_uint8_log2(register uint8_t x) yconst yinline;
  */
 uint8_t wima_uint8_bits(register uint8_t x) yconst yinline;
 
+/**
+ * Returns true if @a r has no area, false otherwise.
+ * @param r	The rectangle to test.
+ * @return	true if @a r is empty, false otherwise.
+ */
+bool wima_rect_empty(WimaRect r) yconst yinline;
+
+/**
+ * Returns the smallest rectangle that contains both
+ * @a a and @a b. Empty rectangles are ignored.
+ * @param a	The first rectangle.
+ * @param b	The second rectangle.
+ * @return	The union of @a a and @a b.
+ */
+WimaRect wima_rect_union(WimaRect a, WimaRect b) yconst yinline;
+
+/**
+ * Returns true if @a a and @a b overlap, false otherwise.
+ * @param a	The first rectangle.
+ * @param b	The second rectangle.
+ * @return	true if @a a and @a b overlap, false otherwise.
+ */
+bool wima_rect_intersects(WimaRect a, WimaRect b) yconst yinline;
+
 /**
  * @}
  */
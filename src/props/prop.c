@@ -43,7 +43,9 @@
 
 #include "../wima.h"
 
+#include "../areas/area.h"
 #include "../events/event.h"
+#include "../windows/window.h"
 
 #include <dyna/hash.h>
 #include <dyna/nvector.h>
@@ -269,6 +271,38 @@ static WimaStatus wima_prop_collection_checkPush(WimaPropData* data, WimaPropert
 static WimaProperty wima_prop_register(const char* name, const char* label, const char* desc, WimaIcon icon,
                                        WimaPropType type, const WimaPropData* data);
 
+/**
+ * Finds the prop with @a name in the hash index.
+ * @param name	The name to find.
+ * @param hash	The hash of @a name.
+ * @return		The prop, or WIMA_PROP_INVALID if none.
+ */
+static WimaProperty wima_prop_index_find(const char* name, uint32_t hash);
+
+/**
+ * Makes sure that the hash index has room for one more
+ * prop, growing and rehashing it if necessary.
+ * @return	WIMA_STATUS_SUCCESS on success, an
+ *			error code otherwise.
+ */
+static WimaStatus wima_prop_index_reserve(void);
+
+/**
+ * Puts @a wph in the hash index. There must be
+ * room; see @a wima_prop_index_reserve().
+ * @param wph	The prop to insert.
+ * @param hash	The hash of the prop's name.
+ */
+static void wima_prop_index_insert(WimaProperty wph, uint32_t hash);
+
+/**
+ * Removes @a wph from the hash index. This uses backward
+ * shift deletion, so no tombstones are left behind.
+ * @param wph	The prop to remove.
+ * @param hash	The hash of the prop's name.
+ */
+static void wima_prop_index_remove(WimaProperty wph, uint32_t hash);
+
 #ifdef __YASSERT__
 /**
  * Checks to see if a child's type is valid for the parent.
@@ -279,6 +313,75 @@ static WimaProperty wima_prop_register(const char* name, const char* label, cons
 static bool wima_prop_collection_childTypeValid(WimaProperty parent, WimaProperty child);
 #endif
 
+/**
+ * Checks whether @a wdgt still shows @a wph in the
+ * tree of areas that its window is showing. When the
+ * widget's region was laid out again, its index may
+ * now belong to another item, or to nothing at all.
+ * @param wph	The property.
+ * @param wdgt	The widget to check.
+ * @return		true if @a wdgt shows @a wph,
+ *				false otherwise.
+ */
+static bool wima_prop_shown(WimaProperty wph, WimaWidget wdgt);
+
+/**
+ * Records that @a wph was read. If a region is
+ * being generated, @a wph is linked to it, so
+ * that it is generated again when @a wph changes.
+ * @param wph	The property that was read.
+ */
+static void wima_prop_depend(WimaProperty wph);
+
+/**
+ * Marks a region that read a prop while it was
+ * generated as stale, if it still exists, and
+ * makes its window lay out again.
+ * @param reg	The region, as a widget with
+ *				an invalid index.
+ */
+static void wima_prop_stale(WimaWidget reg);
+
+/**
+ * Packs a link into a key for the hashed set
+ * of links in @a WimaPropInfo.
+ * @param wdgt	The link to pack.
+ * @return		The key.
+ */
+static uint64_t wima_prop_links_key(WimaWidget wdgt) yconst;
+
+/**
+ * Hashes a key from @a wima_prop_links_key().
+ * @param key	The key to hash.
+ * @return		The hash.
+ */
+static uint32_t wima_prop_links_hash(uint64_t key) yconst;
+
+/**
+ * Makes sure that @a info has room to link one
+ * more widget, growing the set if necessary.
+ * @param info	The prop info.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+static WimaStatus wima_prop_links_reserve(WimaPropInfo* info);
+
+/**
+ * Inserts @a wdgt into the links of @a info.
+ * @param info	The prop info.
+ * @param wdgt	The link to insert.
+ * @pre			There must be room for @a wdgt.
+ * @pre			@a wdgt must not be in the set.
+ */
+static void wima_prop_links_insert(WimaPropInfo* info, WimaWidget wdgt);
+
+/**
+ * Removes the link in slot @a i of @a info.
+ * @param info	The prop info.
+ * @param i		The slot to empty.
+ */
+static void wima_prop_links_remove(WimaPropInfo* info, uint32_t i);
+
 /**
  * @}
  */
@@ -357,23 +460,24 @@ WimaIcon wima_prop_icon(WimaProperty wph)
 	return prop->icon;
 }
 
-WimaProperty wima_prop_find(const char* name)
+uint32_t wima_prop_version(WimaProperty wph)
 {
 	wima_assert_init;
 
-	size_t slen = strlen(name);
+	wassert(wima_prop_valid(wph, WIMA_PROP_NO_TYPE), WIMA_ASSERT_PROP);
 
-	uint32_t hash = dyna_hash32(name, slen, WIMA_PROP_SEED);
+	WimaPropInfo* prop = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, wph);
 
-	size_t len = dnvec_len(wg.props);
-	WimaPropInfo* props = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, 0);
+	return prop->version;
+}
 
-	for (size_t i = 0; i < len; ++i)
-	{
-		if (props[i].idx == i && hash == props[i].hash && !strcmp(name, props[i].name)) return (WimaProperty) i;
-	}
+WimaProperty wima_prop_find(const char* name)
+{
+	wima_assert_init;
 
-	return WIMA_PROP_INVALID;
+	uint32_t hash = dyna_hash32(name, strlen(name), WIMA_PROP_SEED);
+
+	return wima_prop_index_find(name, hash);
 }
 
 void wima_prop_unregister(WimaProperty wph)
@@ -587,11 +691,14 @@ void wima_prop_bool_update(WimaProperty wph, bool val)
 	wassert(wima_prop_valid(wph, WIMA_PROP_BOOL), WIMA_ASSERT_PROP);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	data->_bool = val;
+
+	wima_prop_touch(wph);
 }
 
 bool wima_prop_bool(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_BOOL), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_bool;
 }
@@ -620,11 +727,14 @@ void wima_prop_int_update(WimaProperty wph, int val)
 	wassert(wima_prop_valid(wph, WIMA_PROP_INT), WIMA_ASSERT_PROP);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	data->_int.val = wima_clamp(val, data->_int.min, data->_int.max);
+
+	wima_prop_touch(wph);
 }
 
 int wima_prop_int(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_INT), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_int.val;
 }
@@ -653,11 +763,14 @@ void wima_prop_float_update(WimaProperty wph, float val)
 	wassert(wima_prop_valid(wph, WIMA_PROP_FLOAT), WIMA_ASSERT_PROP);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	data->_float.val = wima_clampf(val, data->_float.min, data->_float.max);
+
+	wima_prop_touch(wph);
 }
 
 float wima_prop_float(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_FLOAT), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_float.val;
 }
@@ -688,6 +801,7 @@ WimaProperty wima_prop_string_register(const char* name, const char* label, cons
 DynaString wima_prop_string(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_STRING), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_str;
 }
@@ -713,11 +827,14 @@ void wima_prop_color_update(WimaProperty wph, WimaColor color)
 	wassert(wima_prop_valid(wph, WIMA_PROP_COLOR), WIMA_ASSERT_PROP);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	data->_color = color;
+
+	wima_prop_touch(wph);
 }
 
 WimaColor wima_prop_color(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_COLOR), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_color;
 }
@@ -749,6 +866,7 @@ WimaProperty wima_prop_path_register(const char* name, const char* label, const
 DynaString wima_prop_path_path(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_PATH), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_str;
 }
@@ -775,6 +893,7 @@ WimaProperty wima_prop_operator_register(const char* name, const char* label, co
 void* wima_prop_operator_ptr(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_OPERATOR), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_op.ptr;
 }
@@ -784,6 +903,8 @@ void wima_prop_operator_updatePtr(WimaProperty wph, void* ptr)
 	wassert(wima_prop_valid(wph, WIMA_PROP_OPERATOR), WIMA_ASSERT_PROP);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	data->_op.ptr = ptr;
+
+	wima_prop_touch(wph);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -810,11 +931,14 @@ void wima_prop_ptr_update(WimaProperty wph, void* ptr)
 	wassert(wima_prop_valid(wph, WIMA_PROP_PTR), WIMA_ASSERT_PROP);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	data->_ptr.ptr = ptr;
+
+	wima_prop_touch(wph);
 }
 
 void* wima_prop_ptr(WimaProperty wph)
 {
 	wassert(wima_prop_valid(wph, WIMA_PROP_PTR), WIMA_ASSERT_PROP);
+	wima_prop_depend(wph);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 	return data->_ptr.ptr;
 }
@@ -873,13 +997,93 @@ bool wima_prop_free(WimaProperty wph)
 	if (info->idx == WIMA_PROP_INVALID) return true;
 	if (info->refs > 0) return false;
 
+	wima_prop_index_remove(wph, info->hash);
+
 	void* ptrs[] = { info, dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph) };
 
 	wima_prop_destroy(ptrs);
 
+	// If this fails, the slot is just not reused.
+	dvec_push(wg.propFree, &wph);
+
 	return true;
 }
 
+void wima_prop_touch(WimaProperty wph)
+{
+	WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, wph);
+
+	++(info->version);
+
+	if (info->theme) ++(wg.themeVersion);
+
+	uint32_t i = 0;
+
+	while (i < info->linksCap)
+	{
+		WimaWidget wdgt = info->links[i];
+
+		if (wdgt.window == WIMA_WINDOW_INVALID)
+		{
+			++i;
+		}
+		else if (wdgt.widget == WIMA_WIDGET_INVALID)
+		{
+			// A region that read the prop. It links
+			// it again if it still reads it when it
+			// is generated, so the link is dropped.
+			wima_prop_stale(wdgt);
+			wima_prop_links_remove(info, i);
+		}
+		else if (wima_prop_shown(wph, wdgt))
+		{
+			wima_window_damageWidget(dvec_get(wg.windows, wdgt.window), wdgt);
+			++i;
+		}
+		else
+		{
+			// Removing shifts a later link into slot i,
+			// so it is checked again. Links that wrap
+			// around were checked already.
+			wima_prop_links_remove(info, i);
+		}
+	}
+}
+
+void wima_prop_setTheme(WimaProperty wph)
+{
+	wassert(wima_prop_valid(wph, WIMA_PROP_NO_TYPE), WIMA_ASSERT_PROP);
+
+	WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, wph);
+
+	info->theme = true;
+}
+
+WimaStatus wima_prop_link(WimaProperty wph, WimaWidget wdgt)
+{
+	WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, wph);
+
+	uint64_t key = wima_prop_links_key(wdgt);
+
+	if (info->linksCap)
+	{
+		uint32_t mask = info->linksCap - 1;
+
+		for (uint32_t i = wima_prop_links_hash(key) & mask; info->links[i].window != WIMA_WINDOW_INVALID;
+		     i = (i + 1) & mask)
+		{
+			if (wima_prop_links_key(info->links[i]) == key) return WIMA_STATUS_SUCCESS;
+		}
+	}
+
+	WimaStatus status = wima_prop_links_reserve(info);
+	if (yerror(status)) return status;
+
+	wima_prop_links_insert(info, wdgt);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
 void wima_prop_destroy(void** ptrs)
 {
 	wima_assert_init;
@@ -928,6 +1132,14 @@ void wima_prop_destroy(void** ptrs)
 		}
 	}
 
+	if (prop->links)
+	{
+		free(prop->links);
+		prop->links = NULL;
+		prop->linksCap = 0;
+		prop->linksLen = 0;
+	}
+
 	// Only free the name because the label
 	// and desc are jointly allocated.
 	free(prop->name);
@@ -976,6 +1188,7 @@ static WimaProperty wima_prop_collection_register(const char* name, const char*
 static uint32_t wima_prop_collection_len(WimaProperty list, WimaPropType type)
 {
 	wassert(wima_prop_valid(list, type), WIMA_ASSERT_PROP);
+	wima_prop_depend(list);
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, list);
 	return dvec_len(data->_collection.list);
 }
@@ -999,6 +1212,8 @@ static WimaStatus wima_prop_collection_push(WimaProperty list, WimaProperty chil
 	WimaPropInfo* childInfo = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, child);
 	++(childInfo->refs);
 
+	wima_prop_touch(list);
+
 	return WIMA_STATUS_SUCCESS;
 }
 
@@ -1023,6 +1238,8 @@ static WimaStatus wima_prop_collection_pushAt(WimaProperty list, uint32_t idx, W
 	WimaPropInfo* childInfo = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, child);
 	++(childInfo->refs);
 
+	wima_prop_touch(list);
+
 	return WIMA_STATUS_SUCCESS;
 }
 
@@ -1042,6 +1259,8 @@ static WimaStatus wima_prop_collection_pop(WimaProperty list, WimaPropType type)
 	WimaPropInfo* childInfo = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, child);
 	--(childInfo->refs);
 
+	wima_prop_touch(list);
+
 	return WIMA_STATUS_SUCCESS;
 }
 
@@ -1061,12 +1280,15 @@ static WimaStatus wima_prop_collection_popAt(WimaProperty list, uint32_t idx, Wi
 	WimaPropInfo* childInfo = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, child);
 	--(childInfo->refs);
 
+	wima_prop_touch(list);
+
 	return WIMA_STATUS_SUCCESS;
 }
 
 static WimaProperty wima_prop_collection_item(WimaProperty list, uint32_t idx, WimaPropType type)
 {
 	wassert(wima_prop_valid(list, type), WIMA_ASSERT_PROP);
+	wima_prop_depend(list);
 
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, list);
 
@@ -1106,31 +1328,27 @@ static WimaProperty wima_prop_register(const char* name, const char* label, cons
 	size_t slen = strlen(name);
 	uint32_t hash = dyna_hash32(name, slen, WIMA_PROP_SEED);
 
-	size_t idx = dnvec_len(wg.props);
+	WimaProperty found = wima_prop_index_find(name, hash);
 
-	if (idx != 0)
+	if (found != WIMA_PROP_INVALID)
 	{
-		WimaPropInfo* props = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, 0);
+		wassert(type == ((WimaPropInfo*) dnvec_get(wg.props, WIMA_PROP_INFO_IDX, found))->type,
+		        WIMA_ASSERT_PROP_TYPE);
+		return found;
+	}
 
-		size_t earlyIdx = 0;
-		bool early = false;
+	// Make room first so that inserting can't fail
+	// after the prop has already been stored.
+	if (yerror(wima_prop_index_reserve())) return WIMA_PROP_INVALID;
 
-		for (size_t i = 0; !early && i < idx; ++i)
-		{
-			if (props[i].idx == WIMA_PROP_INVALID)
-			{
-				early = true;
-				earlyIdx = i;
-			}
-			else if (hash == props[i].hash && !strcmp(name, dstr_str(props[i].name)))
-			{
-				wassert(type == props[i].type, WIMA_ASSERT_PROP_TYPE);
-				return i;
-			}
-		}
+	size_t freeLen = dvec_len(wg.propFree);
 
-		idx = early ? earlyIdx : idx;
-	}
+	WimaProperty idx;
+
+	if (freeLen)
+		idx = *((WimaProperty*) dvec_get(wg.propFree, freeLen - 1));
+	else
+		idx = (WimaProperty) dnvec_len(wg.props);
 
 	WimaPropInfo prop;
 
@@ -1176,17 +1394,131 @@ static WimaProperty wima_prop_register(const char* name, const char* label, cons
 	prop.hash = hash;
 	prop.refs = 0;
 	prop.icon = icon;
+	prop.version = 0;
+	prop.theme = false;
+	prop.links = NULL;
+	prop.linksCap = 0;
+	prop.linksLen = 0;
 
-	DynaStatus status = dnvec_vpush(wg.props, &prop, data);
-	if (yerror(status))
+	if (freeLen)
 	{
-		free(prop.name);
-		return WIMA_PROP_INVALID;
+		// Reuse the slot of a freed prop.
+		*((WimaPropInfo*) dnvec_get(wg.props, WIMA_PROP_INFO_IDX, idx)) = prop;
+		*((WimaPropData*) dnvec_get(wg.props, WIMA_PROP_DATA_IDX, idx)) = *data;
+
+		dvec_pop(wg.propFree);
+	}
+	else
+	{
+		DynaStatus status = dnvec_vpush(wg.props, &prop, data);
+		if (yerror(status))
+		{
+			free(prop.name);
+			return WIMA_PROP_INVALID;
+		}
 	}
 
+	wima_prop_index_insert(idx, hash);
+
 	return idx;
 }
 
+static WimaProperty wima_prop_index_find(const char* name, uint32_t hash)
+{
+	if (!wg.propIndexCap) return WIMA_PROP_INVALID;
+
+	uint32_t mask = wg.propIndexCap - 1;
+
+	for (uint32_t i = hash & mask; wg.propIndex[i] != WIMA_PROP_INVALID; i = (i + 1) & mask)
+	{
+		WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, wg.propIndex[i]);
+
+		if (info->hash == hash && !strcmp(name, info->name)) return wg.propIndex[i];
+	}
+
+	return WIMA_PROP_INVALID;
+}
+
+static WimaStatus wima_prop_index_reserve()
+{
+	// Keep the load factor at or below 3/4.
+	if ((wg.propIndexLen + 1) * 4 <= wg.propIndexCap * 3) return WIMA_STATUS_SUCCESS;
+
+	uint32_t cap = wg.propIndexCap ? wg.propIndexCap * 2 : WIMA_PROP_INDEX_MIN;
+
+	WimaProperty* index = malloc(cap * sizeof(WimaProperty));
+	if (yerror(!index)) return WIMA_STATUS_MALLOC_ERR;
+
+	// WIMA_PROP_INVALID is all ones.
+	memset(index, 0xff, cap * sizeof(WimaProperty));
+
+	WimaProperty* old = wg.propIndex;
+	uint32_t oldCap = wg.propIndexCap;
+
+	wg.propIndex = index;
+	wg.propIndexCap = cap;
+	wg.propIndexLen = 0;
+
+	for (uint32_t i = 0; i < oldCap; ++i)
+	{
+		if (old[i] == WIMA_PROP_INVALID) continue;
+
+		WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, old[i]);
+		wima_prop_index_insert(old[i], info->hash);
+	}
+
+	free(old);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+static void wima_prop_index_insert(WimaProperty wph, uint32_t hash)
+{
+	wassert(wg.propIndexLen < wg.propIndexCap, WIMA_ASSERT_PROP);
+
+	uint32_t mask = wg.propIndexCap - 1;
+	uint32_t i = hash & mask;
+
+	while (wg.propIndex[i] != WIMA_PROP_INVALID) i = (i + 1) & mask;
+
+	wg.propIndex[i] = wph;
+	++(wg.propIndexLen);
+}
+
+static void wima_prop_index_remove(WimaProperty wph, uint32_t hash)
+{
+	if (!wg.propIndexCap) return;
+
+	uint32_t mask = wg.propIndexCap - 1;
+	uint32_t i = hash & mask;
+
+	while (wg.propIndex[i] != wph)
+	{
+		if (wg.propIndex[i] == WIMA_PROP_INVALID) return;
+		i = (i + 1) & mask;
+	}
+
+	// Shift later entries of the same probe run back into the
+	// hole as long as that does not move them before their home.
+	for (uint32_t j = (i + 1) & mask; wg.propIndex[j] != WIMA_PROP_INVALID; j = (j + 1) & mask)
+	{
+		WimaPropInfo* info = dnvec_get(wg.props, WIMA_PROP_INFO_IDX, wg.propIndex[j]);
+		uint32_t home = info->hash & mask;
+
+		// Whether home is cyclically in (i, j].
+		bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+
+		if (!stays)
+		{
+			wg.propIndex[i] = wg.propIndex[j];
+			i = j;
+		}
+	}
+
+	wg.propIndex[i] = WIMA_PROP_INVALID;
+	--(wg.propIndexLen);
+}
+
 #ifdef __YASSERT__
 static bool wima_prop_collection_childTypeValid(WimaProperty parent, WimaProperty child)
 {
@@ -1204,4 +1536,150 @@ static bool wima_prop_collection_childTypeValid(WimaProperty parent, WimaPropert
 }
 #endif
 
+static bool wima_prop_shown(WimaProperty wph, WimaWidget wdgt)
+{
+	if (!wima_window_valid(wdgt.window)) return false;
+
+	WimaWin* win = dvec_get(wg.windows, wdgt.window);
+
+	WimaItemStore* items;
+
+	if (wdgt.region != WIMA_REGION_INVALID_IDX)
+	{
+		if (!win->treeStackLen) return false;
+
+		WimaArTree* areas = WIMA_WIN_AREAS(win);
+
+		if (!wima_area_tree_exists(areas, wdgt.area)) return false;
+
+		WimaAr* area = wima_area_tree_node(areas, wdgt.area);
+
+		if (WIMA_AREA_IS_PARENT(area)) return false;
+
+		items = area->area.items;
+	}
+	else
+	{
+		items = win->overlayItems;
+	}
+
+	if (!items || wdgt.widget >= wima_item_len(items)) return false;
+
+	WimaItem* item = dvec_get(items->items, wdgt.widget);
+
+	return !WIMA_ITEM_IS_LAYOUT(item) && item->widget.prop == wph;
+}
+
+static void wima_prop_depend(WimaProperty wph)
+{
+	if (wg.layoutRegion.region == WIMA_REGION_INVALID_IDX) return;
+
+	// If this fails, the region is just
+	// generated again on the next layout.
+	if (yerror(wima_prop_link(wph, wg.layoutRegion)))
+	{
+		WimaAr* area = wima_area_ptr(wg.layoutRegion.window, wg.layoutRegion.area);
+		area->area.regions[wg.layoutRegion.region].stale = true;
+	}
+}
+
+static void wima_prop_stale(WimaWidget reg)
+{
+	if (!wima_window_valid(reg.window)) return;
+
+	WimaWin* win = dvec_get(wg.windows, reg.window);
+
+	if (!win->treeStackLen) return;
+
+	WimaArTree* areas = WIMA_WIN_AREAS(win);
+
+	if (!wima_area_tree_exists(areas, reg.area)) return;
+
+	WimaAr* area = wima_area_tree_node(areas, reg.area);
+
+	if (WIMA_AREA_IS_PARENT(area) || reg.region >= area->area.numRegions) return;
+
+	area->area.regions[reg.region].stale = true;
+
+	wima_window_damageArea(win, reg.area, true);
+}
+
+static uint64_t wima_prop_links_key(WimaWidget wdgt)
+{
+	return ((uint64_t) wdgt.widget << 32) | ((uint64_t) wdgt.area << 16) | ((uint64_t) wdgt.region << 8) | wdgt.window;
+}
+
+static uint32_t wima_prop_links_hash(uint64_t key)
+{
+	// Fibonacci hashing. The high bits are the best mixed.
+	return (uint32_t) ((key * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+static WimaStatus wima_prop_links_reserve(WimaPropInfo* info)
+{
+	// Keep the load factor at or below 3/4.
+	if ((info->linksLen + 1) * 4 <= info->linksCap * 3) return WIMA_STATUS_SUCCESS;
+
+	uint32_t cap = info->linksCap ? info->linksCap * 2 : WIMA_PROP_LINKS_MIN;
+
+	WimaWidget* links = malloc(cap * sizeof(WimaWidget));
+	if (yerror(!links)) return WIMA_STATUS_MALLOC_ERR;
+
+	// WIMA_WINDOW_INVALID is all ones.
+	memset(links, 0xff, cap * sizeof(WimaWidget));
+
+	WimaWidget* old = info->links;
+	uint32_t oldCap = info->linksCap;
+
+	info->links = links;
+	info->linksCap = cap;
+	info->linksLen = 0;
+
+	for (uint32_t i = 0; i < oldCap; ++i)
+	{
+		if (old[i].window != WIMA_WINDOW_INVALID) wima_prop_links_insert(info, old[i]);
+	}
+
+	free(old);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+static void wima_prop_links_insert(WimaPropInfo* info, WimaWidget wdgt)
+{
+	wassert(info->linksLen < info->linksCap, WIMA_ASSERT_PROP);
+
+	uint32_t mask = info->linksCap - 1;
+	uint32_t i = wima_prop_links_hash(wima_prop_links_key(wdgt)) & mask;
+
+	while (info->links[i].window != WIMA_WINDOW_INVALID) i = (i + 1) & mask;
+
+	info->links[i] = wdgt;
+	++(info->linksLen);
+}
+
+static void wima_prop_links_remove(WimaPropInfo* info, uint32_t i)
+{
+	uint32_t mask = info->linksCap - 1;
+
+	// Shift later entries of the same probe run back into the
+	// hole as long as that does not move them before their home.
+	for (uint32_t j = (i + 1) & mask; info->links[j].window != WIMA_WINDOW_INVALID; j = (j + 1) & mask)
+	{
+		uint32_t home = wima_prop_links_hash(wima_prop_links_key(info->links[j])) & mask;
+
+		// Whether home is cyclically in (i, j].
+		bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+
+		if (!stays)
+		{
+			info->links[i] = info->links[j];
+			i = j;
+		}
+	}
+
+	info->links[i].window = WIMA_WINDOW_INVALID;
+	--(info->linksLen);
+}
+
 //! @endcond Doxygen suppress.
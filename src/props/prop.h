@@ -90,6 +90,20 @@ typedef struct WimaCustProp
  */
 #define WIMA_PROP_SEED (0xdeadbeef)
 
+/**
+ * @def WIMA_PROP_INDEX_MIN
+ * The initial capacity of the hash index from
+ * prop names to props. It must be a power of 2.
+ */
+#define WIMA_PROP_INDEX_MIN (256)
+
+/**
+ * @def WIMA_PROP_LINKS_MIN
+ * The initial capacity of the set of widgets
+ * linked to a prop. It must be a power of 2.
+ */
+#define WIMA_PROP_LINKS_MIN (8)
+
 /**
  * @def WIMA_PROP_INFO_IDX
  * The index of the array in the DynaNVector
@@ -209,6 +223,28 @@ typedef struct WimaPropInfo
 	/// The prop's icon.
 	WimaIcon icon;
 
+	/// Incremented every time the prop changes.
+	uint32_t version;
+
+	/// Whether the prop is part of the theme. Changing
+	/// a theme prop invalidates cached drawings.
+	bool theme;
+
+	/// The widgets that have been laid out to show
+	/// this prop, and the regions (with an invalid
+	/// widget index) that read it while being
+	/// generated, or NULL if none. This is a hashed
+	/// set with linear probing; empty slots have an
+	/// invalid window. Entries are checked, and
+	/// removed if stale, when the prop changes.
+	WimaWidget* links;
+
+	/// The capacity of @a links (a power of 2).
+	uint32_t linksCap;
+
+	/// The number of entries in @a links.
+	uint32_t linksLen;
+
 	/// The name of the property. This
 	/// needs to be a unique identifier.
 	char* name;
@@ -274,6 +310,36 @@ DynaStatus wima_prop_copy(void** dests, void** srcs) ynoreturn;
  */
 bool wima_prop_free(WimaProperty wph);
 
+/**
+ * Records that @a wph changed. This increments its
+ * version, damages the areas of all widgets that
+ * show it, in all windows, and marks the regions
+ * that read it while being generated as stale.
+ * @param wph	The property that changed.
+ */
+void wima_prop_touch(WimaProperty wph);
+
+/**
+ * Marks @a wph as part of the theme, so that
+ * changing it, through any function, makes
+ * drawings cached with the old theme stale.
+ * @param wph	The property to mark.
+ */
+void wima_prop_setTheme(WimaProperty wph);
+
+/**
+ * Records that @a wdgt shows @a wph, so that @a wdgt
+ * will be redrawn when @a wph changes. If @a wdgt has
+ * an invalid index, it is a region that read @a wph,
+ * and it will be generated again instead. It does
+ * nothing if @a wdgt is already recorded.
+ * @param wph	The property that @a wdgt shows.
+ * @param wdgt	The widget.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+WimaStatus wima_prop_link(WimaProperty wph, WimaWidget wdgt);
+
 /**
  * Destroys a property. This is a Dyna NDestructFunc.
  * @param ptrs	The array of elements to destroy.
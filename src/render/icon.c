@@ -38,7 +38,11 @@
 #include <yc/error.h>
 #include <yc/opt.h>
 
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #define NANOSVG_ALL_COLOR_KEYWORDS
 #define NANOSVG_IMPLEMENTATION
@@ -46,6 +50,16 @@
 #undef NANOSVG_IMPLEMENTATION
 #undef NANOSVG_ALL_COLOR_KEYWORDS
 
+#define NANOSVGRAST_IMPLEMENTATION
+#include <nanosvgrast.h>
+#undef NANOSVGRAST_IMPLEMENTATION
+
+//! @cond Doxygen suppress.
+#define NANOVG_GL3
+#include <nanovg.h>
+#include <nanovg_gl.h>
+//! @endcond Doxygen suppress.
+
 #include <wima/math.h>
 #include <wima/render.h>
 
@@ -74,6 +88,47 @@
  */
 static const char* const unitNames[] = { "px", "pt", "pc", "mm", "cm", "in" };
 
+/**
+ * Returns the key of @a icon at @a bucket
+ * in the hash index of the icon atlas.
+ * @param icon		The icon.
+ * @param bucket	The scale bucket.
+ * @return			The key.
+ */
+static uint32_t wima_icon_atlas_key(WimaIcon icon, uint16_t bucket) yconst;
+
+/**
+ * Hashes @a key for the hash index of the icon atlas.
+ * @param key	The key to hash.
+ * @return		The hash.
+ */
+static uint32_t wima_icon_atlas_hash(uint32_t key) yconst;
+
+/**
+ * Finds the slot for @a key in the hash index of @a atlas.
+ * @param atlas	The atlas to search.
+ * @param key	The key to find.
+ * @return		The slot, or NULL if none.
+ */
+static WimaIconSlot* wima_icon_atlas_find(WimaIconAtlas* atlas, uint32_t key) yallnonnull;
+
+/**
+ * Makes sure that the hash index of @a atlas has room
+ * for one more slot, growing and rehashing it if necessary.
+ * @param atlas	The atlas whose index to reserve in.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+static WimaStatus wima_icon_atlas_reserve(WimaIconAtlas* atlas) yallnonnull;
+
+/**
+ * Puts the slot at @a idx in the hash index of @a atlas.
+ * There must be room; see @a wima_icon_atlas_reserve().
+ * @param atlas	The atlas whose index to insert in.
+ * @param idx	The index of the slot in the atlas.
+ */
+static void wima_icon_atlas_insert(WimaIconAtlas* atlas, uint32_t idx) yallnonnull;
+
 /**
  * @}
  */
@@ -107,6 +162,8 @@ WimaIcon wima_icon_load(const char* path, WimaIconUnit unit, float dpi)
 
 	marker.start = prev.end;
 
+	uint64_t span = wima_trace_begin();
+
 	WimaIcn img = nsvgParseFromFile(path, unitNames[unit], dpi);
 
 	if (yerror(!img))
@@ -173,6 +230,8 @@ WimaIcon wima_icon_load(const char* path, WimaIconUnit unit, float dpi)
 	status = dnvec_vpush(wg.icons, &img, &marker);
 	if (yerror(status != DYNA_STATUS_SUCCESS)) goto err;
 
+	wima_trace_end(span, "icon: load", len);
+
 	return (WimaIcon) len;
 
 err:
@@ -200,4 +259,248 @@ void wima_icon_destroy(void** ptrs)
 	nsvgDelete(*((WimaIcn*) ptrs[WIMA_ICON_HANDLE_IDX]));
 }
 
+bool wima_icon_atlas_slot(WimaRenderContext* ctx, WimaIcon icon, float scale, WimaIconSlot* slot)
+{
+	wima_assert_init;
+
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+	wassert(icon < dnvec_len(wg.icons), WIMA_ASSERT_ICON);
+
+	WimaIconAtlas* atlas = &wg.render.icons;
+
+	// Icons are rasterized in device pixels, so the bucket
+	// has to include the pixel ratio. The size is derived
+	// from the bucket, not the scale, so that every scale
+	// that lands in the bucket uses the same pixels. This
+	// also means that windows with different pixel ratios
+	// can share the atlas without getting in each other's way.
+	uint16_t bucket = (uint16_t) lroundf(scale * ctx->pixelRatio * WIMA_ICON_ATLAS_BUCKETS);
+	if (!bucket) return false;
+
+	float size = ceilf(((float) WIMA_ICON_SHEET_RES) * bucket / WIMA_ICON_ATLAS_BUCKETS);
+	uint16_t span = (uint16_t) size + WIMA_ICON_ATLAS_PAD * 2;
+
+	if (span > WIMA_ICON_ATLAS_SIZE) return false;
+
+	if (!atlas->pixels)
+	{
+		size_t bytes = WIMA_ICON_ATLAS_SIZE * WIMA_ICON_ATLAS_SIZE * 4;
+
+		atlas->pixels = calloc(1, bytes);
+		if (yerror(!atlas->pixels)) goto create_err;
+
+		atlas->slots = dvec_create(0, sizeof(WimaIconSlot), NULL, NULL);
+		if (yerror(!atlas->slots)) goto create_err;
+
+		atlas->rast = nsvgCreateRasterizer();
+		if (yerror(!atlas->rast)) goto create_err;
+	}
+
+	// The first context to draw an icon creates the texture
+	// for everyone. NanoVG must not delete it, since other
+	// contexts use it; it is deleted with the last context.
+	if (!atlas->texture)
+	{
+		int flags = NVG_IMAGE_NODELETE;
+
+		ctx->icons = nvgCreateImageRGBA(ctx->nvg, WIMA_ICON_ATLAS_SIZE, WIMA_ICON_ATLAS_SIZE, flags, atlas->pixels);
+		if (yerror(!ctx->icons)) goto err;
+
+		atlas->texture = nvglImageHandleGL3(ctx->nvg, ctx->icons);
+		atlas->dirty = false;
+	}
+	else if (!ctx->icons)
+	{
+		ctx->icons = nvglCreateImageFromHandleGL3(ctx->nvg, atlas->texture, WIMA_ICON_ATLAS_SIZE,
+		                                          WIMA_ICON_ATLAS_SIZE, NVG_IMAGE_NODELETE);
+		if (yerror(!ctx->icons)) goto err;
+	}
+
+	WimaIconSlot* found = wima_icon_atlas_find(atlas, wima_icon_atlas_key(icon, bucket));
+
+	if (found)
+	{
+		*slot = *found;
+		return true;
+	}
+
+	// Simple shelf packing. Icons are mostly the same
+	// size, so this wastes very little of the atlas.
+	if (atlas->x + span > WIMA_ICON_ATLAS_SIZE)
+	{
+		atlas->x = 0;
+		atlas->y += atlas->shelf;
+		atlas->shelf = 0;
+	}
+
+	// If the atlas is full, the caller
+	// falls back to drawing the paths.
+	if (atlas->y + span > WIMA_ICON_ATLAS_SIZE) return false;
+
+	WimaIcn img = *((WimaIcn*) dnvec_get(wg.icons, WIMA_ICON_HANDLE_IDX, icon));
+
+	slot->icon = icon;
+	slot->bucket = bucket;
+	slot->x = atlas->x + WIMA_ICON_ATLAS_PAD;
+	slot->y = atlas->y + WIMA_ICON_ATLAS_PAD;
+	slot->size = (uint16_t) size;
+
+	// Make room first so that inserting can't fail
+	// after the slot has already been pushed.
+	if (yerror(wima_icon_atlas_reserve(atlas))) goto err;
+
+	if (yerror(dvec_push(atlas->slots, slot))) goto err;
+
+	wima_icon_atlas_insert(atlas, (uint32_t) (dvec_len(atlas->slots) - 1));
+
+	int stride = WIMA_ICON_ATLAS_SIZE * 4;
+	unsigned char* dst = atlas->pixels + slot->y * stride + slot->x * 4;
+
+	float rscale = size / wima_fmaxf(img->width, img->height);
+
+	nsvgRasterize(atlas->rast, img, 0.0f, 0.0f, rscale, dst, slot->size, slot->size, stride);
+
+	atlas->x += span;
+	atlas->shelf = span > atlas->shelf ? span : atlas->shelf;
+	atlas->dirty = true;
+
+	return true;
+
+create_err:
+
+	wima_icon_atlas_free();
+
+err:
+
+	wima_error(WIMA_STATUS_MALLOC_ERR);
+
+	return false;
+}
+
+void wima_icon_atlas_upload(WimaRenderContext* ctx)
+{
+	wima_assert_init;
+
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	WimaIconAtlas* atlas = &wg.render.icons;
+
+	if (!atlas->dirty || !ctx->icons) return;
+
+	// The texture is shared, so this
+	// updates it for every context.
+	nvgUpdateImage(ctx->nvg, ctx->icons, atlas->pixels);
+
+	atlas->dirty = false;
+}
+
+void wima_icon_atlas_release()
+{
+	wima_assert_init;
+
+	WimaIconAtlas* atlas = &wg.render.icons;
+
+	if (!atlas->texture) return;
+
+	GLuint texture = atlas->texture;
+	glDeleteTextures(1, &texture);
+
+	atlas->texture = 0;
+
+	// The pixels are kept, so nothing is lost; they
+	// are uploaded when the texture is created again.
+	atlas->dirty = false;
+}
+
+void wima_icon_atlas_free()
+{
+	wima_assert_init;
+
+	WimaIconAtlas* atlas = &wg.render.icons;
+
+	if (atlas->rast) nsvgDeleteRasterizer(atlas->rast);
+	if (atlas->slots) dvec_free(atlas->slots);
+
+	free(atlas->index);
+	free(atlas->pixels);
+
+	// The texture is not touched here. If there is one, it
+	// is still in use and will be deleted with the last context.
+	unsigned int texture = atlas->texture;
+
+	memset(atlas, 0, sizeof(WimaIconAtlas));
+
+	atlas->texture = texture;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t wima_icon_atlas_key(WimaIcon icon, uint16_t bucket)
+{
+	return (((uint32_t) icon) << 16) | bucket;
+}
+
+static uint32_t wima_icon_atlas_hash(uint32_t key)
+{
+	// Fibonacci hashing. The high bits are the best mixed.
+	return (uint32_t) ((key * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+static WimaIconSlot* wima_icon_atlas_find(WimaIconAtlas* atlas, uint32_t key)
+{
+	if (!atlas->indexCap) return NULL;
+
+	uint32_t mask = atlas->indexCap - 1;
+
+	for (uint32_t i = wima_icon_atlas_hash(key) & mask; atlas->index[i] != UINT32_MAX; i = (i + 1) & mask)
+	{
+		WimaIconSlot* slot = dvec_get(atlas->slots, atlas->index[i]);
+
+		if (wima_icon_atlas_key(slot->icon, slot->bucket) == key) return slot;
+	}
+
+	return NULL;
+}
+
+static WimaStatus wima_icon_atlas_reserve(WimaIconAtlas* atlas)
+{
+	// Slots are never removed, so the index
+	// holds every slot in the atlas.
+	uint32_t len = (uint32_t) dvec_len(atlas->slots);
+
+	// Keep the load factor at or below 3/4.
+	if ((len + 1) * 4 <= atlas->indexCap * 3) return WIMA_STATUS_SUCCESS;
+
+	uint32_t cap = atlas->indexCap ? atlas->indexCap * 2 : WIMA_ICON_ATLAS_INDEX_MIN;
+
+	uint32_t* index = malloc(cap * sizeof(uint32_t));
+	if (yerror(!index)) return WIMA_STATUS_MALLOC_ERR;
+
+	// UINT32_MAX is all ones.
+	memset(index, 0xff, cap * sizeof(uint32_t));
+
+	free(atlas->index);
+
+	atlas->index = index;
+	atlas->indexCap = cap;
+
+	for (uint32_t i = 0; i < len; ++i) wima_icon_atlas_insert(atlas, i);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+static void wima_icon_atlas_insert(WimaIconAtlas* atlas, uint32_t idx)
+{
+	WimaIconSlot* slot = dvec_get(atlas->slots, idx);
+
+	uint32_t mask = atlas->indexCap - 1;
+	uint32_t i = wima_icon_atlas_hash(wima_icon_atlas_key(slot->icon, slot->bucket)) & mask;
+
+	while (atlas->index[i] != UINT32_MAX) i = (i + 1) & mask;
+
+	atlas->index[i] = idx;
+}
+
 //! @endcond Doxygen suppress.
@@ -34,14 +34,63 @@
  *	******** END FILE DESCRIPTION ********
  */
 
+#include <wima/job.h>
 #include <wima/render.h>
 
+#include "render.h"
+
 #include "../wima.h"
 
 #include "../windows/window.h"
 
+#include <dyna/vector.h>
+#include <yc/assert.h>
 #include <yc/error.h>
 
+//! @cond Doxygen suppress.
+#define NANOVG_GL3
+#include <nanovg.h>
+#include <nanovg_gl.h>
+//! @endcond Doxygen suppress.
+
+#include <stb_image.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions needed by the public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file render/image.c
+ */
+
+/**
+ * @defgroup image_internal image_internal
+ * @{
+ */
+
+/**
+ * Decodes an image on the thread pool and
+ * hands it to the main thread.
+ * @param data	The WimaImageDecode.
+ */
+static void wima_image_decode(void* data);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+////////////////////////////////////////////////////////////////////////////////
+// Public functions.
+////////////////////////////////////////////////////////////////////////////////
+
 WimaImage wima_image_load(const char* const path, WimaImageFlags flags)
 {
 	wassert(path, WIMA_ASSERT_PATH_NULL);
@@ -49,45 +98,295 @@ WimaImage wima_image_load(const char* const path, WimaImageFlags flags)
 	size_t len = dvec_len(wg.imagePaths);
 
 	wassert(len == dvec_len(wg.imageFlags), WIMA_ASSERT_IMG_MISMATCH);
+	wassert(len == dvec_len(wg.imageData), WIMA_ASSERT_IMG_MISMATCH);
 	wassert(len < WIMA_IMAGE_MAX, WIMA_ASSERT_IMG_MAX);
 
+	uint64_t span = wima_trace_begin();
+
+	size_t pathLen = strlen(path);
+
+	WimaImageDecode* decode = malloc(sizeof(WimaImageDecode) + pathLen + 1);
+	if (yerror(!decode)) goto decode_err;
+
+	decode->image = (WimaImage) len;
+	memcpy(decode->path, path, pathLen + 1);
+
+	WimaImg img;
+
+	img.pixels = NULL;
+	img.width = 0;
+	img.height = 0;
+
 	DynaStatus status = dvec_pushString(wg.imagePaths, path);
 	if (yerror(status != DYNA_STATUS_SUCCESS)) goto path_err;
 
 	status = dvec_push(wg.imageFlags, &flags);
-	if (yerror(status != DYNA_STATUS_SUCCESS)) goto err;
+	if (yerror(status != DYNA_STATUS_SUCCESS)) goto flags_err;
+
+	status = dvec_push(wg.imageData, &img);
+	if (yerror(status != DYNA_STATUS_SUCCESS)) goto data_err;
 
 	size_t winLen = dvec_len(wg.windows);
+	size_t i;
 
-	for (size_t i = 0; i < winLen; ++i)
+	// Until the image is decoded and uploaded,
+	// windows draw the placeholder instead.
+	int none = 0;
+
+	for (i = 0; i < winLen; ++i)
 	{
 		if (!wima_window_valid(i)) continue;
 
 		WimaWin* win = dvec_get(wg.windows, i);
 
-		WimaStatus status = wima_window_addImage(win, path, flags);
+		status = dvec_push(win->render.images, &none);
+		if (yerror(status != DYNA_STATUS_SUCCESS)) goto win_err;
+	}
 
-		if (yerror(status))
-		{
-			for (size_t j = 0; j < i; ++j)
-			{
-				if (!wima_window_valid(j)) continue;
-				wima_window_removeImage(dvec_get(wg.windows, j));
-			}
+	WimaStatus wstatus = wima_job_run(wima_image_decode, decode);
+	if (yerror(wstatus)) goto win_err;
 
-			wima_error(status);
-		}
-	}
+	wima_trace_end(span, "image: load", len);
 
 	return (WimaImage) len;
 
-err:
+win_err:
+
+	for (size_t j = 0; j < i; ++j)
+	{
+		if (!wima_window_valid(j)) continue;
+
+		WimaWin* win = dvec_get(wg.windows, j);
+		dvec_pop(win->render.images);
+	}
+
+	dvec_pop(wg.imageData);
+
+data_err:
+
+	dvec_pop(wg.imageFlags);
+
+flags_err:
 
 	dvec_pop(wg.imagePaths);
 
 path_err:
 
+	free(decode);
+
+decode_err:
+
 	wima_error(WIMA_STATUS_MALLOC_ERR);
 
 	return WIMA_IMAGE_INVALID;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaStatus wima_image_context_init(WimaRenderContext* ctx)
+{
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	static const uint8_t gray[4] = { 0x80, 0x80, 0x80, 0xFF };
+
+	int flags = NVG_IMAGE_REPEATX | NVG_IMAGE_REPEATY | NVG_IMAGE_NEAREST;
+
+	ctx->placeholder = nvgCreateImageRGBA(ctx->nvg, 1, 1, flags, gray);
+	if (yerror(!ctx->placeholder)) return WIMA_STATUS_OPENGL_ERR;
+
+	dvec_setLength(ctx->images, 0);
+
+	size_t len = dvec_len(wg.imageData);
+	int none = 0;
+
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (yerror(dvec_push(ctx->images, &none))) return WIMA_STATUS_MALLOC_ERR;
+	}
+
+	// Make sure that images that are
+	// already decoded are uploaded.
+	ctx->imageVersion = wg.imageVersion - 1;
+
+	wima_image_context_upload(ctx);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+bool wima_image_context_upload(WimaRenderContext* ctx)
+{
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	if (ctx->imageVersion == wg.imageVersion) return false;
+
+	ctx->imageVersion = wg.imageVersion;
+
+	size_t len = dvec_len(ctx->images);
+
+	if (!len) return false;
+
+	wassert(len == dvec_len(wg.imageData), WIMA_ASSERT_IMG_MISMATCH);
+
+	int* ids = dvec_get(ctx->images, 0);
+	WimaImg* imgs = dvec_get(wg.imageData, 0);
+	WimaImageFlags* flags = dvec_get(wg.imageFlags, 0);
+
+	bool uploaded = false;
+
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (ids[i] || !imgs[i].pixels) continue;
+
+		// NanoVG must not delete shared textures. They
+		// are deleted when the last context goes away.
+		int iflags = flags[i] | NVG_IMAGE_NODELETE;
+
+		// The first context uploads the image. The
+		// rest just wrap the texture it created.
+		if (!imgs[i].texture)
+		{
+			ids[i] = nvgCreateImageRGBA(ctx->nvg, imgs[i].width, imgs[i].height, iflags, imgs[i].pixels);
+			if (ids[i]) imgs[i].texture = nvglImageHandleGL3(ctx->nvg, ids[i]);
+		}
+		else
+		{
+			ids[i] = nvglCreateImageFromHandleGL3(ctx->nvg, imgs[i].texture, imgs[i].width, imgs[i].height, iflags);
+		}
+
+		// On failure, the placeholder is drawn and
+		// this is tried again when versions change.
+		uploaded = uploaded || ids[i] != 0;
+	}
+
+	return uploaded;
+}
+
+int wima_image_context_get(WimaRenderContext* ctx, WimaImage img)
+{
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+	wassert(img < dvec_len(ctx->images), WIMA_ASSERT_IMG);
+
+	int id = *((int*) dvec_get(ctx->images, img));
+
+	return id ? id : ctx->placeholder;
+}
+
+void wima_image_update()
+{
+	wima_assert_init;
+
+	// Take the whole stack at once. Order does not matter.
+	WimaImageDecode* node = atomic_exchange_explicit(&wg.imagesDecoded, NULL, memory_order_acquire);
+
+	if (!node) return;
+
+	while (node)
+	{
+		WimaImageDecode* next = node->next;
+
+		// Failed images keep drawing the placeholder.
+		if (yerror(!node->pixels))
+		{
+			wima_error(WIMA_STATUS_IMAGE_LOAD_ERR);
+		}
+		else
+		{
+			WimaImg* img = dvec_get(wg.imageData, node->image);
+
+			img->pixels = node->pixels;
+			img->width = node->width;
+			img->height = node->height;
+		}
+
+		free(node);
+
+		node = next;
+	}
+
+	++(wg.imageVersion);
+
+	size_t len = dvec_len(wg.windows);
+
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (wima_window_valid(i)) wima_window_setDirty(dvec_get(wg.windows, i), false);
+	}
+}
+
+void wima_image_free()
+{
+	WimaImageDecode* node = atomic_exchange_explicit(&wg.imagesDecoded, NULL, memory_order_acquire);
+
+	while (node)
+	{
+		WimaImageDecode* next = node->next;
+
+		if (node->pixels) stbi_image_free(node->pixels);
+		free(node);
+
+		node = next;
+	}
+
+	if (!wg.imageData) return;
+
+	size_t len = dvec_len(wg.imageData);
+
+	for (size_t i = 0; i < len; ++i)
+	{
+		WimaImg* img = dvec_get(wg.imageData, i);
+		if (img->pixels) stbi_image_free(img->pixels);
+	}
+
+	dvec_free(wg.imageData);
+	wg.imageData = NULL;
+}
+
+void wima_image_release()
+{
+	if (!wg.imageData) return;
+
+	size_t len = dvec_len(wg.imageData);
+
+	for (size_t i = 0; i < len; ++i)
+	{
+		WimaImg* img = dvec_get(wg.imageData, i);
+
+		if (!img->texture) continue;
+
+		GLuint texture = img->texture;
+		glDeleteTextures(1, &texture);
+
+		img->texture = 0;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void wima_image_decode(void* data)
+{
+	WimaImageDecode* decode = (WimaImageDecode*) data;
+
+	uint64_t span = wima_trace_begin();
+
+	int components;
+
+	decode->pixels = stbi_load(decode->path, &decode->width, &decode->height, &components, 4);
+
+	wima_trace_end(span, "image: decode", decode->image);
+
+	decode->next = atomic_load_explicit(&wg.imagesDecoded, memory_order_relaxed);
+
+	// On failure, this reloads the current top into next.
+	while (!atomic_compare_exchange_weak_explicit(&wg.imagesDecoded, &decode->next, decode, memory_order_release,
+	                                              memory_order_relaxed))
+	{
+		continue;
+	}
+
+	// Wake up the event loop so that it uploads the image.
+	glfwPostEmptyEvent();
+}
@@ -96,13 +96,16 @@ WimaPaint wima_paint_radialGradient(WimaRenderContext* ctx, WimaVecf c, float in
 	return p.wima;
 }
 
-WimaPaint wima_paint_imagePattern(WimaRenderContext* ctx, WimaVecf o, WimaSizef e, float angle, int image, float alpha)
+WimaPaint wima_paint_imagePattern(WimaRenderContext* ctx, WimaVecf o, WimaSizef e, float angle, WimaImage image,
+                                  float alpha)
 {
 	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
 
 	WimaPnt p;
 
-	p.nvg = nvgImagePattern(ctx->nvg, o.x, o.y, e.w, e.h, angle, image, alpha);
+	int id = wima_image_context_get(ctx, image);
+
+	p.nvg = nvgImagePattern(ctx->nvg, o.x, o.y, e.w, e.h, angle, id, alpha);
 
 	return p.wima;
 }
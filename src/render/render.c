@@ -42,10 +42,47 @@
 
 #include "../windows/window.h"
 
+#include <dyna/string.h>
 #include <yc/assert.h>
+#include <yc/error.h>
 
 #include <nanovg.h>
 
+#include <stdio.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions needed by the public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file render/render.c
+ */
+
+/**
+ * @defgroup render_internal render_internal
+ * @{
+ */
+
+/**
+ * Reads the font file into the shared resources.
+ * @return	WIMA_STATUS_SUCCESS on success, an
+ *			error code otherwise.
+ */
+static WimaStatus wima_render_share_loadFont(void);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+////////////////////////////////////////////////////////////////////////////////
+// Public functions.
+////////////////////////////////////////////////////////////////////////////////
+
 void wima_render_save(WimaRenderContext* ctx)
 {
 	wima_assert_init;
@@ -157,3 +194,106 @@ void wima_render_resetScissor(WimaRenderContext* ctx)
 	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
 	nvgResetScissor(ctx->nvg);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaStatus wima_render_share_init(WimaRenderContext* ctx)
+{
+	wima_assert_init;
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	WimaRenderShare* share = &wg.render;
+
+	// This is counted first because the NanoVG
+	// context exists, even if this fails.
+	++(share->contexts);
+
+	if (!share->font)
+	{
+		WimaStatus status = wima_render_share_loadFont();
+		if (yerror(status)) return status;
+	}
+
+	// NanoVG does not take ownership of the data, so the
+	// file is not read and copied again for every window.
+	ctx->font = nvgCreateFontMem(ctx->nvg, "default", share->font, share->fontSize, 0);
+	if (yerror(ctx->font == -1)) return WIMA_STATUS_MALLOC_ERR;
+
+	return wima_image_context_init(ctx);
+}
+
+void wima_render_share_release(WimaRenderContext* ctx)
+{
+	wima_assert_init;
+	wassert(ctx, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	WimaRenderShare* share = &wg.render;
+
+	wassert(share->contexts, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	--(share->contexts);
+
+	if (share->contexts) return;
+
+	// This is the last context, so the shared textures have
+	// to be deleted now, while there is still one to do it.
+	wima_icon_atlas_release();
+	wima_image_release();
+}
+
+void wima_render_share_free()
+{
+	wima_icon_atlas_free();
+
+	free(wg.render.font);
+
+	wg.render.font = NULL;
+	wg.render.fontSize = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static WimaStatus wima_render_share_loadFont()
+{
+	WimaStatus status = WIMA_STATUS_PLATFORM_ERR;
+
+	FILE* f = fopen(dstr_str(wg.fontPath), "rb");
+	if (yerror(!f)) return WIMA_STATUS_PLATFORM_ERR;
+
+	if (yerror(fseek(f, 0, SEEK_END))) goto err;
+
+	long size = ftell(f);
+	if (yerror(size <= 0)) goto err;
+
+	if (yerror(fseek(f, 0, SEEK_SET))) goto err;
+
+	uint8_t* data = malloc((size_t) size);
+	if (yerror(!data))
+	{
+		status = WIMA_STATUS_MALLOC_ERR;
+		goto err;
+	}
+
+	if (yerror(fread(data, 1, (size_t) size, f) != (size_t) size))
+	{
+		free(data);
+		goto err;
+	}
+
+	fclose(f);
+
+	wg.render.font = data;
+	wg.render.fontSize = (int) size;
+
+	return WIMA_STATUS_SUCCESS;
+
+err:
+
+	fclose(f);
+
+	return status;
+}
@@ -49,6 +49,7 @@ extern "C" {
 
 #include <GLFW/glfw3.h>
 #include <dyna/nvector.h>
+#include <dyna/vector.h>
 
 #include <nanosvg.h>
 #include <nanovg.h>
@@ -67,6 +68,50 @@ extern "C" {
  * @{
  */
 
+/**
+ * A texture atlas of rasterized icons. There is only
+ * one, and its texture is shared by all GL contexts.
+ * NanoVG images cannot be shared, so every render
+ * context wraps the texture in its own image.
+ */
+typedef struct WimaIconAtlas
+{
+	/// The GL texture, or 0 if not created yet.
+	unsigned int texture;
+
+	/// Whether @a pixels has changes that have
+	/// not been uploaded to @a texture yet.
+	bool dirty;
+
+	/// A CPU copy of the atlas. NanoVG can only
+	/// update whole images, so this is needed.
+	uint8_t* pixels;
+
+	/// The slots (@a WimaIconSlot) in the atlas.
+	DynaVector slots;
+
+	/// An open-addressing hash index from icon and
+	/// scale bucket to the index of the slot in
+	/// @a slots. Empty entries are UINT32_MAX.
+	uint32_t* index;
+
+	/// The capacity of @a index (a power of 2).
+	uint32_t indexCap;
+
+	/// The NanoSVG rasterizer.
+	struct NSVGrasterizer* rast;
+
+	/// The x coordinate of the next slot.
+	uint16_t x;
+
+	/// The y coordinate of the current shelf.
+	uint16_t y;
+
+	/// The height of the current shelf.
+	uint16_t shelf;
+
+} WimaIconAtlas;
+
 /**
  * Render state (context). Because NanoVG does all of the
  * rendering, this just has the information for NanoVG.
@@ -79,12 +124,78 @@ typedef struct WimaRenderContext
 	/// The font handle for NanoVG.
 	int font;
 
+	/// The pixel ratio of the frame being drawn.
+	float pixelRatio;
+
+	/// The NanoVG image that wraps the texture of
+	/// the shared icon atlas, or 0 if not created yet.
+	int icons;
+
+	/// The NanoVG images for each @a WimaImage. Images
+	/// that have not been uploaded yet are 0.
+	DynaVector images;
+
+	/// The image drawn in place of images
+	/// that have not been uploaded yet.
+	int placeholder;
+
+	/// The value of @a WimaG's imageVersion
+	/// when images were last uploaded.
+	uint32_t imageVersion;
+
 	/// The number of times the render
 	/// stack has been pushed onto.
 	uint8_t stackCount;
 
 } WimaRenderContext;
 
+/**
+ * GL resources that are shared by all windows. Every
+ * window's GL context is in one share group, so
+ * textures only need to be created once.
+ */
+typedef struct WimaRenderShare
+{
+	/// The contents of the font file. This is read
+	/// once and given to every NanoVG context.
+	uint8_t* font;
+
+	/// The size of @a font.
+	int fontSize;
+
+	/// The number of render contexts that are alive.
+	/// When the last one dies, so do the shared textures.
+	uint32_t contexts;
+
+	/// The icon atlas.
+	WimaIconAtlas icons;
+
+} WimaRenderShare;
+
+/**
+ * Sets up @a ctx, which must have a NanoVG context
+ * that is current, with the shared resources.
+ * @param ctx	The render context to set up.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ * @pre			@a ctx must not be NULL.
+ */
+WimaStatus wima_render_share_init(WimaRenderContext* ctx) yallnonnull;
+
+/**
+ * Lets go of the shared resources for @a ctx, which
+ * is about to be destroyed. If it is the last context,
+ * the shared textures are deleted.
+ * @param ctx	The render context that is going away.
+ * @pre			@a ctx must not be NULL.
+ */
+void wima_render_share_release(WimaRenderContext* ctx) yallnonnull;
+
+/**
+ * Frees the shared resources that are not GL objects.
+ */
+void wima_render_share_free(void);
+
 /**
  * @}
  */
@@ -329,6 +440,206 @@ DynaStatus wima_icon_copy(void** dests, void** srcs) ynoreturn;
  */
 void wima_icon_destroy(void** ptrs);
 
+/**
+ * @def WIMA_ICON_ATLAS_SIZE
+ * The width and height, in pixels, of icon atlases.
+ */
+#define WIMA_ICON_ATLAS_SIZE 1024
+
+/**
+ * @def WIMA_ICON_ATLAS_PAD
+ * The padding, in pixels, around icons in the atlas.
+ * This keeps texture filtering from bleeding icons.
+ */
+#define WIMA_ICON_ATLAS_PAD 1
+
+/**
+ * @def WIMA_ICON_ATLAS_BUCKETS
+ * The number of scale buckets per unit of scale. Icons
+ * are rasterized once per bucket, so scales that round
+ * to the same bucket share a slot.
+ */
+#define WIMA_ICON_ATLAS_BUCKETS 4
+
+/**
+ * @def WIMA_ICON_ATLAS_INDEX_MIN
+ * The initial capacity of the hash index from icon
+ * and bucket to atlas slot. It must be a power of 2.
+ */
+#define WIMA_ICON_ATLAS_INDEX_MIN (64)
+
+/**
+ * A rasterized icon in an icon atlas.
+ */
+typedef struct WimaIconSlot
+{
+	/// The icon.
+	WimaIcon icon;
+
+	/// The scale bucket it was rasterized for.
+	uint16_t bucket;
+
+	/// The x coordinate in the atlas.
+	uint16_t x;
+
+	/// The y coordinate in the atlas.
+	uint16_t y;
+
+	/// The width and height in the atlas.
+	uint16_t size;
+
+} WimaIconSlot;
+
+/**
+ * Finds the slot for @a icon at @a scale in the atlas
+ * of @a ctx, rasterizing the icon if necessary.
+ * @param ctx	The render context whose atlas to use.
+ * @param icon	The icon to find.
+ * @param scale	The scale (not counting the pixel ratio)
+ *				that the icon will be drawn at.
+ * @param slot	A pointer to return the slot in.
+ * @return		true if the slot was found, false if the
+ *				icon could not be put in the atlas.
+ * @pre			@a ctx must not be NULL.
+ * @pre			@a slot must not be NULL.
+ */
+bool wima_icon_atlas_slot(WimaRenderContext* ctx, WimaIcon icon, float scale, WimaIconSlot* slot) yallnonnull;
+
+/**
+ * Uploads any newly rasterized icons in the atlas. This
+ * must be called before the frame of @a ctx ends.
+ * @param ctx	The render context that is drawing.
+ * @pre			@a ctx must not be NULL.
+ */
+void wima_icon_atlas_upload(WimaRenderContext* ctx) yallnonnull;
+
+/**
+ * Deletes the texture of the icon atlas. This is called
+ * when the last GL context that shares it is destroyed.
+ */
+void wima_icon_atlas_release(void);
+
+/**
+ * Frees the icon atlas.
+ */
+void wima_icon_atlas_free(void);
+
+/**
+ * @}
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Images.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @defgroup image_internal image_internal
+ * Internal functions and data structures for images.
+ * @{
+ */
+
+/**
+ * A loaded image. Images are decoded once, on the
+ * thread pool, and the pixels are then uploaded
+ * to every render context on the main thread.
+ */
+typedef struct WimaImg
+{
+	/// The decoded RGBA pixels, or NULL if the image
+	/// has not been decoded (or failed to decode).
+	/// These are kept in case every window is closed
+	/// and the texture has to be created again.
+	uint8_t* pixels;
+
+	/// The GL texture, shared by all GL
+	/// contexts, or 0 if not uploaded yet.
+	unsigned int texture;
+
+	/// The width of the image.
+	int width;
+
+	/// The height of the image.
+	int height;
+
+} WimaImg;
+
+/**
+ * An image that has been decoded on the thread pool.
+ * These form a lock-free stack that the main thread
+ * takes in @a wima_image_update().
+ */
+typedef struct WimaImageDecode
+{
+	/// The next node in the stack.
+	struct WimaImageDecode* next;
+
+	/// The decoded pixels, or NULL on failure.
+	uint8_t* pixels;
+
+	/// The width of the image.
+	int width;
+
+	/// The height of the image.
+	int height;
+
+	/// The image that was decoded.
+	WimaImage image;
+
+	/// The path of the image file.
+	char path[];
+
+} WimaImageDecode;
+
+/**
+ * Sets up the images of @a ctx, which must have a NanoVG
+ * context that is current. Every image gets a slot, and
+ * the ones that are decoded already are uploaded.
+ * @param ctx	The render context to set up.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ * @pre			@a ctx must not be NULL.
+ */
+WimaStatus wima_image_context_init(WimaRenderContext* ctx) yallnonnull;
+
+/**
+ * Uploads images that have been decoded since the last
+ * call to @a ctx. The context must be current.
+ * @param ctx	The render context to upload to.
+ * @return		true if any images were uploaded (and
+ *				cached drawings are stale), false otherwise.
+ * @pre			@a ctx must not be NULL.
+ */
+bool wima_image_context_upload(WimaRenderContext* ctx) yallnonnull;
+
+/**
+ * Returns the NanoVG image for @a img in @a ctx, or the
+ * placeholder if @a img has not been uploaded yet.
+ * @param ctx	The render context to query.
+ * @param img	The image to query.
+ * @return		The NanoVG image.
+ * @pre			@a ctx must not be NULL.
+ */
+int wima_image_context_get(WimaRenderContext* ctx, WimaImage img) yallnonnull;
+
+/**
+ * Takes images that have finished decoding and marks
+ * windows dirty so that they upload them. This must
+ * be called on the main thread.
+ */
+void wima_image_update(void);
+
+/**
+ * Frees all decoded pixels. The thread pool must
+ * have been stopped before this is called.
+ */
+void wima_image_free(void);
+
+/**
+ * Deletes the textures of all images. This is called
+ * when the last GL context that shares them is destroyed.
+ */
+void wima_image_release(void);
+
 /**
  * @}
  */
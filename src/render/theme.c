@@ -762,6 +762,8 @@ WimaProperty wima_theme_loadNode(WimaProperty* starts)
 
 	if (yerror(child == WIMA_PROP_INVALID)) goto malloc_err;
 
+	wima_prop_setTheme(child);
+
 	status = wima_prop_group_push(main, child);
 	if (yerror(status)) goto err;
 
@@ -786,6 +788,7 @@ void wima_theme_setBackground(WimaColor bg)
 
 	wassert(wima_prop_valid(wph, WIMA_PROP_COLOR), WIMA_ASSERT_PROP);
 
+	// This bumps the theme version.
 	wima_prop_color_update(wph, bg);
 }
 
@@ -906,6 +909,8 @@ void wima_theme_widget_setShaded(WimaThemeType type, bool shaded)
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 
 	data[WIMA_THEME_WIDGET_SHADED]._bool = shaded;
+
+	++(wg.themeVersion);
 }
 
 bool wima_theme_widget_shaded(WimaThemeType type)
@@ -1038,6 +1043,8 @@ void wima_theme_node_setWireCurving(int curving)
 	int max = data[WIMA_THEME_NODE_WIRE_CURVING]._int.max;
 
 	data[WIMA_THEME_NODE_WIRE_CURVING]._int.val = wima_clamp(curving, min, max);
+
+	++(wg.themeVersion);
 }
 
 int wima_theme_node_wireCurving()
@@ -1212,26 +1219,32 @@ static WimaProperty wima_theme_createProp(WimaPropType type, const char* name1,
 
 	wima_theme_createName(buffer, name1, name2);
 
+	WimaProperty wph;
+
 	switch (type)
 	{
 		case WIMA_PROP_MENU:
 		{
-			return wima_prop_group_register(buffer, label, desc, WIMA_ICON_INVALID);
+			wph = wima_prop_group_register(buffer, label, desc, WIMA_ICON_INVALID);
+			break;
 		}
 
 		case WIMA_PROP_BOOL:
 		{
-			return wima_prop_bool_register(buffer, label, desc, WIMA_ICON_INVALID, initial != 0);
+			wph = wima_prop_bool_register(buffer, label, desc, WIMA_ICON_INVALID, initial != 0);
+			break;
 		}
 
 		case WIMA_PROP_INT:
 		{
-			return wima_prop_int_register(buffer, label, desc, WIMA_ICON_INVALID, initial, -100, 100, 1);
+			wph = wima_prop_int_register(buffer, label, desc, WIMA_ICON_INVALID, initial, -100, 100, 1);
+			break;
 		}
 
 		case WIMA_PROP_COLOR:
 		{
-			return wima_prop_color_register(buffer, label, desc, WIMA_ICON_INVALID, colors[initial]);
+			wph = wima_prop_color_register(buffer, label, desc, WIMA_ICON_INVALID, colors[initial]);
+			break;
 		}
 
 		default:
@@ -1240,6 +1253,12 @@ static WimaProperty wima_theme_createProp(WimaPropType type, const char* name1,
 			return WIMA_PROP_INVALID;
 		}
 	}
+
+	// Theme props are marked so that they bump the theme
+	// version even when they are changed as plain props.
+	if (wph != WIMA_PROP_INVALID) wima_prop_setTheme(wph);
+
+	return wph;
 }
 
 static void wima_theme_setWidgetColor(WimaThemeType type, WimaWidgetThemeType idx, WimaColor color)
@@ -1256,6 +1275,8 @@ static void wima_theme_setWidgetColor(WimaThemeType type, WimaWidgetThemeType id
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 
 	data[idx]._color = color;
+
+	++(wg.themeVersion);
 }
 
 static WimaColor wima_theme_widgetColor(WimaThemeType type, WimaWidgetThemeType idx)
@@ -1292,6 +1313,8 @@ static void wima_theme_setWidgetDelta(WimaThemeType type, bool top, int delta)
 	int max = data[idx]._int.max;
 
 	data[idx]._int.val = wima_clamp(delta, min, max);
+
+	++(wg.themeVersion);
 }
 
 static int wima_theme_widgetDelta(WimaThemeType type, bool top)
@@ -1322,6 +1345,8 @@ static void wima_theme_setNodeColor(WimaNodeThemeType type, WimaColor color)
 	WimaPropData* data = dnvec_get(wg.props, WIMA_PROP_DATA_IDX, wph);
 
 	data[type]._color = color;
+
+	++(wg.themeVersion);
 }
 
 static WimaColor wima_theme_nodeColor(WimaNodeThemeType type)
@@ -70,6 +70,7 @@
 
 #include <dyna/nvector.h>
 
+#include <math.h>
 #include <string.h>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -847,6 +848,32 @@ void wima_ui_icon(WimaRenderContext* ctx, float x, float y, WimaIcon icon)
 
 	if (icon >= dnvec_len(wg.icons)) return;
 
+	float xform[6];
+	WimaIconSlot slot;
+
+	// The current transform includes the area scale.
+	nvgCurrentTransform(ctx->nvg, xform);
+	float xscale = sqrtf(xform[0] * xform[0] + xform[1] * xform[1]);
+
+	// Draw the rasterized icon if possible. Tessellating
+	// the paths every frame is much more expensive.
+	if (wima_icon_atlas_slot(ctx, icon, xscale, &slot))
+	{
+		float res = (float) WIMA_ICON_SHEET_RES;
+		float texel = res / slot.size;
+		float atlasSize = WIMA_ICON_ATLAS_SIZE * texel;
+
+		NVGpaint paint = nvgImagePattern(ctx->nvg, x - slot.x * texel, y - slot.y * texel, atlasSize, atlasSize, 0.0f,
+		                                 ctx->icons, 1.0f);
+
+		nvgBeginPath(ctx->nvg);
+		nvgRect(ctx->nvg, x, y, res, res);
+		nvgFillPaint(ctx->nvg, paint);
+		nvgFill(ctx->nvg);
+
+		return;
+	}
+
 	WimaIcn img = *((WimaIcn*) dnvec_get(wg.icons, WIMA_ICON_HANDLE_IDX, icon));
 
 	float scale = WIMA_ICON_SHEET_RES / wima_fmaxf(img->width, img->height);
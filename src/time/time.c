@@ -34,11 +34,64 @@
  *	******** END FILE DESCRIPTION ********
  */
 
+#include <wima/time.h>
 #include <wima/wima.h>
 
+#include "time.h"
+
+#include "../wima.h"
+
+#include "../windows/window.h"
+
 #include <GLFW/glfw3.h>
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions needed by the public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file time/time.c
+ */
+
+/**
+ * @defgroup time_internal time_internal
+ * @{
+ */
+
+/**
+ * Returns the duration of @a phase in the frame at
+ * @a idx of @a times, summing phases for the total.
+ * @param times	The frame times to query.
+ * @param idx	The index of the frame.
+ * @param phase	The phase to query.
+ * @return		The duration, in raw timer ticks.
+ */
+static uint64_t wima_time_frame_get(WimaFrameTimes* times, uint32_t idx, WimaFramePhase phase);
+
+/**
+ * Compares two uint64_t's. This is for qsort().
+ * @param a	A pointer to the first.
+ * @param b	A pointer to the second.
+ * @return	Less than, equal to, or greater than
+ *			zero, like strcmp().
+ */
+static int wima_time_cmp(const void* a, const void* b);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+////////////////////////////////////////////////////////////////////////////////
+// Public functions.
+////////////////////////////////////////////////////////////////////////////////
 
 void wima_setTime(double time)
 {
@@ -59,3 +112,97 @@ uint64_t wima_time_freq()
 {
 	return glfwGetTimerFrequency();
 }
+
+WimaFrameStats wima_time_frameStats(WimaWindow wwh, WimaFramePhase phase)
+{
+	wima_assert_init;
+
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+	wassert(phase <= WIMA_FRAME_PHASE_TOTAL, WIMA_ASSERT_SWITCH_DEFAULT);
+
+	WimaFrameTimes* times = &((WimaWin*) dvec_get(wg.windows, wwh))->times;
+
+	WimaFrameStats stats;
+
+	memset(&stats, 0, sizeof(WimaFrameStats));
+
+	uint32_t count = times->count;
+	if (!count) return stats;
+
+	uint64_t durs[WIMA_TIME_FRAMES];
+	uint64_t sum = 0;
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		durs[i] = wima_time_frame_get(times, i, phase);
+		sum += durs[i];
+	}
+
+	qsort(durs, count, sizeof(uint64_t), wima_time_cmp);
+
+	// The nearest-rank percentile.
+	uint32_t p99 = (count * 99 + 99) / 100 - 1;
+
+	double freq = (double) wima_time_freq();
+
+	stats.min = durs[0] / freq;
+	stats.avg = (sum / freq) / count;
+	stats.p99 = durs[p99] / freq;
+	stats.max = durs[count - 1] / freq;
+	stats.frames = count;
+
+	return stats;
+}
+
+void wima_time_clearFrames(WimaWindow wwh)
+{
+	wima_assert_init;
+
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaFrameTimes* times = &((WimaWin*) dvec_get(wg.windows, wwh))->times;
+
+	memset(times, 0, sizeof(WimaFrameTimes));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+void wima_time_frame_add(WimaFrameTimes* times, WimaFramePhase phase, uint64_t start)
+{
+	wassert(phase < WIMA_FRAME_PHASE_TOTAL, WIMA_ASSERT_SWITCH_DEFAULT);
+	times->current[phase] += wima_time_raw() - start;
+}
+
+void wima_time_frame_commit(WimaFrameTimes* times)
+{
+	memcpy(times->frames[times->next], times->current, sizeof(times->current));
+	memset(times->current, 0, sizeof(times->current));
+
+	times->next = (times->next + 1) & (WIMA_TIME_FRAMES - 1);
+	times->count += times->count < WIMA_TIME_FRAMES;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t wima_time_frame_get(WimaFrameTimes* times, uint32_t idx, WimaFramePhase phase)
+{
+	if (phase != WIMA_FRAME_PHASE_TOTAL) return times->frames[idx][phase];
+
+	uint64_t total = 0;
+
+	for (int i = 0; i < WIMA_FRAME_PHASE_TOTAL; ++i) total += times->frames[idx][i];
+
+	return total;
+}
+
+static int wima_time_cmp(const void* a, const void* b)
+{
+	uint64_t x = *((const uint64_t*) a);
+	uint64_t y = *((const uint64_t*) b);
+
+	return (x > y) - (x < y);
+}
@@ -0,0 +1,368 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Private data structures for timing frames.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#ifndef WIMA_TIME_PRIVATE_H
+#define WIMA_TIME_PRIVATE_H
+
+/* For C++ compatibility. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @cond INTERNAL
+
+#include <wima/time.h>
+
+#include <dyna/vector.h>
+#include <yc/opt.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @file time/time.h
+ */
+
+/**
+ * @defgroup time_internal time_internal
+ * Internal functions and data structures for timing.
+ * @{
+ */
+
+/**
+ * @def WIMA_TIME_FRAMES
+ * The number of recent frames that are kept for
+ * each window. This must be a power of 2.
+ */
+#define WIMA_TIME_FRAMES (128)
+
+/**
+ * A ring buffer of how long each phase took
+ * in the most recent frames of a window.
+ */
+typedef struct WimaFrameTimes
+{
+	/// The durations, in raw timer ticks, of the phases
+	/// of each frame. The total is not stored.
+	uint64_t frames[WIMA_TIME_FRAMES][WIMA_FRAME_PHASE_TOTAL];
+
+	/// The durations of the frame in progress.
+	uint64_t current[WIMA_FRAME_PHASE_TOTAL];
+
+	/// The index where the next frame will go.
+	uint32_t next;
+
+	/// The number of frames stored.
+	uint32_t count;
+
+} WimaFrameTimes;
+
+/**
+ * Adds the time since @a start to @a phase
+ * of the frame in progress.
+ * @param times	The frame times to add to.
+ * @param phase	The phase to add to.
+ * @param start	The value of @a wima_time_raw()
+ *				when the phase started.
+ * @pre			@a times must not be NULL.
+ */
+void wima_time_frame_add(WimaFrameTimes* times, WimaFramePhase phase, uint64_t start) yallnonnull;
+
+/**
+ * Ends the frame in progress, putting it in the ring
+ * buffer (and dropping the oldest if full).
+ * @param times	The frame times to commit to.
+ * @pre			@a times must not be NULL.
+ */
+void wima_time_frame_commit(WimaFrameTimes* times) yallnonnull;
+
+/**
+ * @def WIMA_TIMER_FREQ
+ * The number of timer wheel ticks per second.
+ */
+#define WIMA_TIMER_FREQ (1000)
+
+/**
+ * @def WIMA_TIMER_LEVELS
+ * The number of levels in the timer wheel. With 64
+ * slots per level and 1 ms ticks, the levels cover
+ * 64 ms, 4 s, 4.4 min, and 4.7 hours. Timers further
+ * out are cascaded back into the top level.
+ */
+#define WIMA_TIMER_LEVELS (4)
+
+/**
+ * @def WIMA_TIMER_SLOT_BITS
+ * The number of bits of a tick that index a level.
+ */
+#define WIMA_TIMER_SLOT_BITS (6)
+
+/**
+ * @def WIMA_TIMER_SLOTS
+ * The number of slots in each level of the timer wheel.
+ * This must fit in the bits of a uint64_t bitmap.
+ */
+#define WIMA_TIMER_SLOTS (1 << WIMA_TIMER_SLOT_BITS)
+
+/**
+ * @def WIMA_TIMER_NONE
+ * An index that means no timer (the end of a slot list).
+ */
+#define WIMA_TIMER_NONE ((uint32_t) -1)
+
+/**
+ * The states that a timer can be in.
+ */
+typedef enum WimaTimerState
+{
+	/// The timer's slot is free.
+	WIMA_TIMER_FREE = 0,
+
+	/// The timer is in the wheel.
+	WIMA_TIMER_PENDING,
+
+	/// The timer has been taken out of the
+	/// wheel to be run in this pass.
+	WIMA_TIMER_EXPIRED
+
+} WimaTimerState;
+
+/**
+ * A timer.
+ */
+typedef struct WimaTmr
+{
+	/// The function to call.
+	WimaTimerFunc func;
+
+	/// The user pointer to pass to @a func.
+	void* user;
+
+	/// The tick when the timer expires.
+	uint64_t expires;
+
+	/// The number of ticks between calls,
+	/// or 0 if this is a one-shot timer.
+	uint64_t interval;
+
+	/// The next timer in the same slot.
+	uint32_t next;
+
+	/// The previous timer in the same slot.
+	uint32_t prev;
+
+	/// Incremented every time the timer is freed,
+	/// so that stale handles can be detected.
+	uint16_t gen;
+
+	/// The level that the timer is in.
+	uint8_t level;
+
+	/// The slot that the timer is in.
+	uint8_t slot;
+
+	/// The state of the timer.
+	WimaTimerState state;
+
+} WimaTmr;
+
+/**
+ * A hierarchical timing wheel. Each level has a list
+ * of timers per slot and a bitmap of non-empty slots,
+ * so finding the next deadline and skipping idle
+ * ticks are both cheap.
+ */
+typedef struct WimaTimerWheel
+{
+	/// The timers (WimaTmr).
+	DynaVector timers;
+
+	/// Indices of free timers, which
+	/// are reused before pushing.
+	DynaVector free;
+
+	/// Handles of timers that have
+	/// expired in the current pass.
+	DynaVector expired;
+
+	/// The next tick to process.
+	uint64_t tick;
+
+	/// The heads of the slot lists.
+	uint32_t slots[WIMA_TIMER_LEVELS][WIMA_TIMER_SLOTS];
+
+	/// Bitmaps of the slots that are not empty.
+	uint64_t occupied[WIMA_TIMER_LEVELS];
+
+	/// The number of timers in the wheel.
+	uint32_t count;
+
+} WimaTimerWheel;
+
+/**
+ * Initializes the timer wheel.
+ * @return	WIMA_STATUS_SUCCESS on success, an
+ *			error code otherwise.
+ */
+WimaStatus wima_timer_init(void);
+
+/**
+ * Runs the callbacks of all timers that have expired.
+ * This must be called when all windows are in the
+ * process stage.
+ */
+void wima_timer_process(void);
+
+/**
+ * Returns the time (see @a wima_time()) when the
+ * timer wheel next needs to be processed. This is
+ * exact if the next timer is less than 64 ticks
+ * away, and a lower bound (when timers need to
+ * be cascaded) otherwise.
+ * @return	The next deadline, or a negative
+ *			number if there are no timers.
+ */
+double wima_timer_deadline(void);
+
+/**
+ * Frees the timer wheel.
+ */
+void wima_timer_free(void);
+
+/**
+ * @def WIMA_TRACE_CHUNK
+ * The number of spans in each chunk of a thread's trace buffer.
+ */
+#define WIMA_TRACE_CHUNK (4096)
+
+/**
+ * A traced span.
+ */
+typedef struct WimaTraceSpan
+{
+	/// The name of the span. This must
+	/// be a string literal.
+	const char* name;
+
+	/// An argument to put in the trace.
+	uint64_t arg;
+
+	/// The raw time when the span started.
+	uint64_t start;
+
+	/// The raw time when the span ended.
+	uint64_t end;
+
+} WimaTraceSpan;
+
+/**
+ * A chunk of a thread's trace buffer. Chunks are
+ * only written by their thread, and @a count and
+ * @a next are published so other threads can read
+ * the spans without locking.
+ */
+typedef struct WimaTraceChunk
+{
+	/// The next chunk, or NULL.
+	_Atomic(struct WimaTraceChunk*) next;
+
+	/// The number of spans in this chunk.
+	atomic_uint count;
+
+	/// The spans.
+	WimaTraceSpan spans[WIMA_TRACE_CHUNK];
+
+} WimaTraceChunk;
+
+/**
+ * A thread's trace buffer. These form a lock-free
+ * stack that threads push themselves onto the first
+ * time they record a span.
+ */
+typedef struct WimaTraceThread
+{
+	/// The next thread in the stack.
+	struct WimaTraceThread* next;
+
+	/// The last chunk. Only the owning thread uses this.
+	WimaTraceChunk* tail;
+
+	/// The thread ID to put in the trace.
+	uint32_t id;
+
+	/// The first chunk.
+	WimaTraceChunk head;
+
+} WimaTraceThread;
+
+/**
+ * Starts a span, if tracing is enabled.
+ * @return	The raw time, or 0 if tracing is disabled.
+ */
+uint64_t wima_trace_begin(void) yinline;
+
+/**
+ * Ends a span started by @a wima_trace_begin(). If
+ * @a start is 0 (tracing was disabled), nothing is
+ * recorded. If a buffer cannot be allocated, the
+ * span is dropped.
+ * @param start	The return value of @a wima_trace_begin().
+ * @param name	The name of the span. This must be a
+ *				string literal (or otherwise outlive
+ *				the trace) and must not need escaping.
+ * @param arg	An argument to put in the trace.
+ * @pre			@a name must not be NULL.
+ */
+void wima_trace_end(uint64_t start, const char* name, uint64_t arg) yallnonnull;
+
+/**
+ * Writes the trace, if tracing was ever started, and
+ * frees all trace buffers. No other threads may be
+ * recording spans when this is called.
+ */
+void wima_trace_free(void);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // WIMA_TIME_PRIVATE_H
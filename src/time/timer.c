@@ -0,0 +1,522 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Timers, kept in a hierarchical timing wheel.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#include <wima/time.h>
+#include <wima/wima.h>
+
+#include "time.h"
+
+#include "../wima.h"
+
+#include <dyna/vector.h>
+#include <yc/error.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions needed by the public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file time/timer.c
+ */
+
+/**
+ * @defgroup time_internal time_internal
+ * @{
+ */
+
+/**
+ * @def WIMA_TIMER_IDX
+ * Returns the index of the timer that @a t refers to.
+ * @param t	The timer handle.
+ * @return	The index of the timer.
+ */
+#define WIMA_TIMER_IDX(t) ((t) & 0xFFFF)
+
+/**
+ * @def WIMA_TIMER_GEN
+ * Returns the generation of the timer handle @a t.
+ * @param t	The timer handle.
+ * @return	The generation of the timer.
+ */
+#define WIMA_TIMER_GEN(t) ((t) >> 16)
+
+/**
+ * Converts @a secs to ticks, rounding up so
+ * that timers never fire early.
+ * @param secs	The number of seconds.
+ * @return		The number of ticks.
+ */
+static uint64_t wima_timer_ticks(double secs) yconst;
+
+/**
+ * Returns the timer that @a timer refers to, if
+ * it is still running, or NULL otherwise.
+ * @param timer	The timer handle.
+ * @return		The timer, or NULL.
+ */
+static WimaTmr* wima_timer_get(WimaTimer timer);
+
+/**
+ * Puts the timer at @a idx in the right slot
+ * of the wheel for its expiry time.
+ * @param idx	The index of the timer.
+ */
+static void wima_timer_insert(uint32_t idx);
+
+/**
+ * Takes the timer at @a idx out of the wheel.
+ * @param idx	The index of the timer.
+ */
+static void wima_timer_unlink(uint32_t idx);
+
+/**
+ * Frees the timer at @a idx so that its slot can be reused.
+ * @param idx	The index of the timer.
+ */
+static void wima_timer_release(uint32_t idx);
+
+/**
+ * Moves all timers in @a slot of @a level
+ * down to the levels they now belong in.
+ * @param level	The level to cascade.
+ * @param slot	The slot to cascade.
+ */
+static void wima_timer_cascade(uint8_t level, uint8_t slot);
+
+/**
+ * Rotates @a x right by @a n bits.
+ * @param x	The value to rotate.
+ * @param n	The number of bits to rotate by.
+ * @return	The rotated value.
+ */
+static uint64_t wima_timer_rotr(uint64_t x, unsigned int n) yconst;
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+////////////////////////////////////////////////////////////////////////////////
+// Public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaTimer wima_timer_start(double delay, double interval, WimaTimerFunc func, void* user)
+{
+	wima_assert_init;
+
+	wassert(func, WIMA_ASSERT_TIMER_FUNC);
+	wassert(isfinite(delay) && delay >= 0.0, WIMA_ASSERT_TIMER_TIME);
+	wassert(isfinite(interval) && interval >= 0.0, WIMA_ASSERT_TIMER_TIME);
+
+	WimaTimerWheel* w = &wg.timers;
+
+	uint32_t idx;
+	size_t freeLen = dvec_len(w->free);
+
+	if (freeLen)
+	{
+		idx = *((uint32_t*) dvec_get(w->free, freeLen - 1));
+		dvec_pop(w->free);
+	}
+	else
+	{
+		idx = dvec_len(w->timers);
+
+		wassert(idx < WIMA_TIMER_MAX, WIMA_ASSERT_TIMER_MAX);
+
+		WimaTmr tmr;
+		memset(&tmr, 0, sizeof(WimaTmr));
+
+		if (yerror(dvec_push(w->timers, &tmr)))
+		{
+			wima_error(WIMA_STATUS_MALLOC_ERR);
+			return WIMA_TIMER_INVALID;
+		}
+	}
+
+	WimaTmr* tmr = dvec_get(w->timers, idx);
+
+	tmr->func = func;
+	tmr->user = user;
+
+	// Rounding the absolute time up (instead of
+	// now and the delay separately) is what makes
+	// sure that the timer never fires early.
+	tmr->expires = wima_timer_ticks(wima_time() + delay);
+	tmr->interval = wima_timer_ticks(interval);
+
+	wima_timer_insert(idx);
+
+	return (((WimaTimer) tmr->gen) << 16) | idx;
+}
+
+void wima_timer_stop(WimaTimer timer)
+{
+	wima_assert_init;
+
+	WimaTmr* tmr = wima_timer_get(timer);
+	if (!tmr) return;
+
+	uint32_t idx = WIMA_TIMER_IDX(timer);
+
+	if (tmr->state == WIMA_TIMER_PENDING) wima_timer_unlink(idx);
+
+	wima_timer_release(idx);
+}
+
+bool wima_timer_active(WimaTimer timer)
+{
+	wima_assert_init;
+
+	return wima_timer_get(timer) != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaStatus wima_timer_init()
+{
+	WimaTimerWheel* w = &wg.timers;
+
+	w->timers = dvec_create(0, sizeof(WimaTmr), NULL, NULL);
+	if (yerror(!w->timers)) return WIMA_STATUS_MALLOC_ERR;
+
+	w->free = dvec_create(0, sizeof(uint32_t), NULL, NULL);
+	if (yerror(!w->free)) return WIMA_STATUS_MALLOC_ERR;
+
+	w->expired = dvec_create(0, sizeof(WimaTimer), NULL, NULL);
+	if (yerror(!w->expired)) return WIMA_STATUS_MALLOC_ERR;
+
+	// This sets every slot to WIMA_TIMER_NONE.
+	memset(w->slots, 0xFF, sizeof(w->slots));
+	memset(w->occupied, 0, sizeof(w->occupied));
+
+	w->tick = (uint64_t) floor(wima_time() * WIMA_TIMER_FREQ);
+	w->count = 0;
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+void wima_timer_process()
+{
+	wima_assert_init;
+
+	WimaTimerWheel* w = &wg.timers;
+
+	uint64_t now = (uint64_t) floor(wima_time() * WIMA_TIMER_FREQ);
+
+	dvec_setLength(w->expired, 0);
+
+	// First, take every expired timer out of the wheel. The
+	// callbacks are not run until after, so that timers they
+	// start or stop cannot change the wheel while it moves.
+	while (w->tick <= now)
+	{
+		if (!w->count)
+		{
+			w->tick = now + 1;
+			break;
+		}
+
+		uint8_t idx = w->tick & (WIMA_TIMER_SLOTS - 1);
+
+		// Cascade higher levels when the levels below them wrap.
+		for (uint8_t level = 1; level < WIMA_TIMER_LEVELS; ++level)
+		{
+			unsigned int shift = WIMA_TIMER_SLOT_BITS * level;
+
+			if (w->tick & ((((uint64_t) 1) << shift) - 1)) break;
+
+			wima_timer_cascade(level, (w->tick >> shift) & (WIMA_TIMER_SLOTS - 1));
+		}
+
+		uint64_t pending = w->occupied[0] >> idx;
+
+		// Nothing else is in this lap of level 0, so skip
+		// ahead to the start of the next one (or to now).
+		if (!pending)
+		{
+			uint64_t next = (w->tick | (WIMA_TIMER_SLOTS - 1)) + 1;
+			w->tick = next <= now ? next : now + 1;
+			continue;
+		}
+
+		uint64_t next = w->tick + __builtin_ctzll(pending);
+
+		if (next > now)
+		{
+			w->tick = now + 1;
+			break;
+		}
+
+		w->tick = next;
+		idx = next & (WIMA_TIMER_SLOTS - 1);
+
+		uint32_t t = w->slots[0][idx];
+
+		w->slots[0][idx] = WIMA_TIMER_NONE;
+		w->occupied[0] &= ~(((uint64_t) 1) << idx);
+
+		while (t != WIMA_TIMER_NONE)
+		{
+			WimaTmr* tmr = dvec_get(w->timers, t);
+
+			WimaTimer handle = (((WimaTimer) tmr->gen) << 16) | t;
+
+			tmr->state = WIMA_TIMER_EXPIRED;
+			--(w->count);
+
+			// If this fails, the timer is lost, but
+			// there is nothing better we can do.
+			if (yerror(dvec_push(w->expired, &handle))) wima_error(WIMA_STATUS_MALLOC_ERR);
+
+			t = tmr->next;
+		}
+
+		++(w->tick);
+	}
+
+	size_t len = dvec_len(w->expired);
+
+	for (size_t i = 0; i < len; ++i)
+	{
+		WimaTimer timer = *((WimaTimer*) dvec_get(w->expired, i));
+
+		WimaTmr* tmr = wima_timer_get(timer);
+
+		// An earlier callback could have stopped it.
+		if (!tmr || tmr->state != WIMA_TIMER_EXPIRED) continue;
+
+		uint32_t idx = WIMA_TIMER_IDX(timer);
+
+		WimaTimerFunc func = tmr->func;
+		void* user = tmr->user;
+
+		// One-shot timers are done before their callbacks,
+		// so the callbacks see them as stopped.
+		if (!tmr->interval)
+		{
+			wima_timer_release(idx);
+			func(timer, user);
+			continue;
+		}
+
+		func(timer, user);
+
+		// The callback could have stopped the timer or
+		// started others, which can move the vector.
+		tmr = wima_timer_get(timer);
+		if (!tmr || tmr->state != WIMA_TIMER_EXPIRED) continue;
+
+		tmr->expires += tmr->interval;
+
+		// Skip the periods that were missed.
+		if (tmr->expires < w->tick)
+			tmr->expires += (w->tick - tmr->expires + tmr->interval - 1) / tmr->interval * tmr->interval;
+
+		wima_timer_insert(idx);
+	}
+}
+
+double wima_timer_deadline()
+{
+	WimaTimerWheel* w = &wg.timers;
+
+	if (!w->count) return -1.0;
+
+	uint64_t deadline = UINT64_MAX;
+
+	for (uint8_t level = 0; level < WIMA_TIMER_LEVELS; ++level)
+	{
+		uint64_t occupied = w->occupied[level];
+		if (!occupied) continue;
+
+		unsigned int shift = WIMA_TIMER_SLOT_BITS * level;
+
+		// The first block of this level that starts at or
+		// after the next tick. Level 0 slots expire at their
+		// tick; higher slots need to be cascaded at theirs.
+		uint64_t first = (w->tick + (((uint64_t) 1) << shift) - 1) >> shift;
+
+		uint64_t rotated = wima_timer_rotr(occupied, first & (WIMA_TIMER_SLOTS - 1));
+		uint64_t tick = (first + __builtin_ctzll(rotated)) << shift;
+
+		if (tick < deadline) deadline = tick;
+	}
+
+	return (double) deadline / WIMA_TIMER_FREQ;
+}
+
+void wima_timer_free()
+{
+	WimaTimerWheel* w = &wg.timers;
+
+	if (w->expired) dvec_free(w->expired);
+	if (w->free) dvec_free(w->free);
+	if (w->timers) dvec_free(w->timers);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t wima_timer_ticks(double secs)
+{
+	return (uint64_t) ceil(secs * WIMA_TIMER_FREQ);
+}
+
+static WimaTmr* wima_timer_get(WimaTimer timer)
+{
+	uint32_t idx = WIMA_TIMER_IDX(timer);
+
+	if (timer == WIMA_TIMER_INVALID || idx >= dvec_len(wg.timers.timers)) return NULL;
+
+	WimaTmr* tmr = dvec_get(wg.timers.timers, idx);
+
+	if (tmr->state == WIMA_TIMER_FREE || tmr->gen != WIMA_TIMER_GEN(timer)) return NULL;
+
+	return tmr;
+}
+
+static void wima_timer_insert(uint32_t idx)
+{
+	WimaTimerWheel* w = &wg.timers;
+
+	WimaTmr* tmr = dvec_get(w->timers, idx);
+
+	// A timer that should have already fired goes in the
+	// next slot to be processed; it is never missed.
+	if (tmr->expires < w->tick) tmr->expires = w->tick;
+
+	uint64_t delta = tmr->expires - w->tick;
+	uint64_t expires = tmr->expires;
+
+	uint8_t level = 0;
+
+	while (level < WIMA_TIMER_LEVELS - 1 && delta >> (WIMA_TIMER_SLOT_BITS * (level + 1))) ++level;
+
+	uint64_t max = (((uint64_t) 1) << (WIMA_TIMER_SLOT_BITS * WIMA_TIMER_LEVELS)) - 1;
+
+	// Timers past the end of the wheel go in the furthest
+	// slot. When that is cascaded, they are put back in.
+	if (delta > max) expires = w->tick + max;
+
+	uint8_t slot = (expires >> (WIMA_TIMER_SLOT_BITS * level)) & (WIMA_TIMER_SLOTS - 1);
+
+	uint32_t head = w->slots[level][slot];
+
+	if (head != WIMA_TIMER_NONE) ((WimaTmr*) dvec_get(w->timers, head))->prev = idx;
+
+	tmr->next = head;
+	tmr->prev = WIMA_TIMER_NONE;
+	tmr->level = level;
+	tmr->slot = slot;
+	tmr->state = WIMA_TIMER_PENDING;
+
+	w->slots[level][slot] = idx;
+	w->occupied[level] |= ((uint64_t) 1) << slot;
+
+	++(w->count);
+}
+
+static void wima_timer_unlink(uint32_t idx)
+{
+	WimaTimerWheel* w = &wg.timers;
+
+	WimaTmr* tmr = dvec_get(w->timers, idx);
+
+	if (tmr->next != WIMA_TIMER_NONE) ((WimaTmr*) dvec_get(w->timers, tmr->next))->prev = tmr->prev;
+
+	if (tmr->prev != WIMA_TIMER_NONE)
+	{
+		((WimaTmr*) dvec_get(w->timers, tmr->prev))->next = tmr->next;
+	}
+	else
+	{
+		w->slots[tmr->level][tmr->slot] = tmr->next;
+
+		if (tmr->next == WIMA_TIMER_NONE) w->occupied[tmr->level] &= ~(((uint64_t) 1) << tmr->slot);
+	}
+
+	--(w->count);
+}
+
+static void wima_timer_release(uint32_t idx)
+{
+	WimaTmr* tmr = dvec_get(wg.timers.timers, idx);
+
+	tmr->state = WIMA_TIMER_FREE;
+	++(tmr->gen);
+
+	// If this fails, the slot leaks because it is
+	// never reused, so report it. Nothing else
+	// goes wrong.
+	yerror(dvec_push(wg.timers.free, &idx));
+}
+
+static void wima_timer_cascade(uint8_t level, uint8_t slot)
+{
+	WimaTimerWheel* w = &wg.timers;
+
+	uint32_t idx = w->slots[level][slot];
+
+	w->slots[level][slot] = WIMA_TIMER_NONE;
+	w->occupied[level] &= ~(((uint64_t) 1) << slot);
+
+	while (idx != WIMA_TIMER_NONE)
+	{
+		uint32_t next = ((WimaTmr*) dvec_get(w->timers, idx))->next;
+
+		--(w->count);
+		wima_timer_insert(idx);
+
+		idx = next;
+	}
+}
+
+static uint64_t wima_timer_rotr(uint64_t x, unsigned int n)
+{
+	return (x >> n) | (x << ((64 - n) & 63));
+}
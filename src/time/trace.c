@@ -0,0 +1,297 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Functions to record traces in Chrome trace-event format.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#include <wima/time.h>
+#include <wima/wima.h>
+
+#include "time.h"
+
+#include "../wima.h"
+
+#include <dyna/string.h>
+#include <yc/error.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions needed by the public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+//! @cond INTERNAL
+
+/**
+ * @file time/trace.c
+ */
+
+/**
+ * @defgroup time_internal time_internal
+ * @{
+ */
+
+/**
+ * Incremented every time trace buffers are freed so that
+ * threads know their thread-local buffer is gone.
+ */
+static atomic_uint wima_trace_gen;
+
+/**
+ * The trace buffer of the current thread.
+ */
+static _Thread_local WimaTraceThread* wima_trace_thread;
+
+/**
+ * The value of @a wima_trace_gen when @a
+ * wima_trace_thread was allocated.
+ */
+static _Thread_local unsigned int wima_trace_threadGen;
+
+/**
+ * Returns the trace buffer of the current thread,
+ * allocating it and pushing it onto the global
+ * stack if necessary.
+ * @return	The trace buffer, or NULL on malloc failure.
+ */
+static WimaTraceThread* wima_trace_getThread(void);
+
+/**
+ * @}
+ */
+
+//! @endcond INTERNAL
+
+////////////////////////////////////////////////////////////////////////////////
+// Public functions.
+////////////////////////////////////////////////////////////////////////////////
+
+WimaStatus wima_trace_start(const char* path)
+{
+	wima_assert_init;
+
+	if (!wg.tracePath)
+	{
+		wg.tracePath = dstr_create(path);
+		if (yerror(!wg.tracePath)) return WIMA_STATUS_MALLOC_ERR;
+	}
+	else if (yerror(dstr_set(wg.tracePath, path)))
+	{
+		return WIMA_STATUS_MALLOC_ERR;
+	}
+
+	atomic_store_explicit(&wg.tracing, true, memory_order_release);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+void wima_trace_stop()
+{
+	wima_assert_init;
+
+	atomic_store_explicit(&wg.tracing, false, memory_order_release);
+}
+
+bool wima_trace_enabled()
+{
+	return atomic_load_explicit(&wg.tracing, memory_order_relaxed);
+}
+
+WimaStatus wima_trace_write()
+{
+	wima_assert_init;
+
+	if (yerror(!wg.tracePath)) return WIMA_STATUS_INVALID_STATE;
+
+	FILE* f = fopen(dstr_str(wg.tracePath), "w");
+	if (yerror(!f)) return WIMA_STATUS_PLATFORM_ERR;
+
+	double scale = 1000000.0 / (double) wima_time_freq();
+	bool first = true;
+
+	fputs("{\"traceEvents\":[", f);
+
+	WimaTraceThread* thread = atomic_load_explicit(&wg.traceThreads, memory_order_acquire);
+
+	for (; thread; thread = thread->next)
+	{
+		WimaTraceChunk* chunk = &thread->head;
+
+		while (chunk)
+		{
+			// Only the spans published before this load are read,
+			// so the thread can keep recording while we write.
+			unsigned int count = atomic_load_explicit(&chunk->count, memory_order_acquire);
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				WimaTraceSpan* span = chunk->spans + i;
+
+				fprintf(f,
+				        "%s\n{\"name\":\"%s\",\"cat\":\"wima\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+				        "\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%llu}}",
+				        first ? "" : ",", span->name, span->start * scale, (span->end - span->start) * scale,
+				        thread->id, (unsigned long long) span->arg);
+
+				first = false;
+			}
+
+			chunk = atomic_load_explicit(&chunk->next, memory_order_acquire);
+		}
+	}
+
+	fputs("\n],\"displayTimeUnit\":\"ms\"}\n", f);
+
+	return fclose(f) ? WIMA_STATUS_PLATFORM_ERR : WIMA_STATUS_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Private functions.
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t wima_trace_begin()
+{
+	return atomic_load_explicit(&wg.tracing, memory_order_relaxed) ? wima_time_raw() : 0;
+}
+
+void wima_trace_end(uint64_t start, const char* name, uint64_t arg)
+{
+	if (!start) return;
+
+	uint64_t end = wima_time_raw();
+
+	WimaTraceThread* thread = wima_trace_getThread();
+	if (yerror(!thread)) return;
+
+	WimaTraceChunk* chunk = thread->tail;
+
+	// Only this thread writes the count, so relaxed is enough.
+	unsigned int count = atomic_load_explicit(&chunk->count, memory_order_relaxed);
+
+	if (count == WIMA_TRACE_CHUNK)
+	{
+		WimaTraceChunk* next = malloc(sizeof(WimaTraceChunk));
+		if (yerror(!next)) return;
+
+		atomic_init(&next->next, NULL);
+		atomic_init(&next->count, 0);
+
+		atomic_store_explicit(&chunk->next, next, memory_order_release);
+
+		thread->tail = next;
+		chunk = next;
+		count = 0;
+	}
+
+	WimaTraceSpan* span = chunk->spans + count;
+
+	span->name = name;
+	span->arg = arg;
+	span->start = start;
+	span->end = end;
+
+	// Publish the span.
+	atomic_store_explicit(&chunk->count, count + 1, memory_order_release);
+}
+
+void wima_trace_free()
+{
+	atomic_store_explicit(&wg.tracing, false, memory_order_relaxed);
+
+	if (wg.tracePath)
+	{
+		wima_trace_write();
+		dstr_free(wg.tracePath);
+		wg.tracePath = NULL;
+	}
+
+	WimaTraceThread* thread = atomic_exchange_explicit(&wg.traceThreads, NULL, memory_order_acquire);
+
+	while (thread)
+	{
+		WimaTraceThread* next = thread->next;
+		WimaTraceChunk* chunk = atomic_load_explicit(&thread->head.next, memory_order_relaxed);
+
+		while (chunk)
+		{
+			WimaTraceChunk* nextChunk = atomic_load_explicit(&chunk->next, memory_order_relaxed);
+			free(chunk);
+			chunk = nextChunk;
+		}
+
+		free(thread);
+		thread = next;
+	}
+
+	// Make threads allocate new buffers if tracing is started again.
+	atomic_fetch_add_explicit(&wima_trace_gen, 1, memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static WimaTraceThread* wima_trace_getThread()
+{
+	unsigned int gen = atomic_load_explicit(&wima_trace_gen, memory_order_relaxed);
+
+	if (wima_trace_thread && wima_trace_threadGen == gen) return wima_trace_thread;
+
+	WimaTraceThread* thread = malloc(sizeof(WimaTraceThread));
+	if (yerror(!thread)) return NULL;
+
+	thread->tail = &thread->head;
+	thread->id = atomic_fetch_add_explicit(&wg.traceIds, 1, memory_order_relaxed) + 1;
+
+	atomic_init(&thread->head.next, NULL);
+	atomic_init(&thread->head.count, 0);
+
+	thread->next = atomic_load_explicit(&wg.traceThreads, memory_order_relaxed);
+
+	// On failure, this reloads the current top into next. The
+	// release makes the initialized buffer visible to readers.
+	while (!atomic_compare_exchange_weak_explicit(&wg.traceThreads, &thread->next, thread, memory_order_release,
+	                                              memory_order_relaxed))
+	{
+		continue;
+	}
+
+	wima_trace_thread = thread;
+	wima_trace_threadGen = gen;
+
+	return thread;
+}
@@ -34,6 +34,8 @@
  *	******** END FILE DESCRIPTION ********
  */
 
+#include <wima/job.h>
+#include <wima/time.h>
 #include <wima/wima.h>
 
 #include "wima.h"
@@ -56,7 +58,6 @@
 #include <yc/utils.h>
 
 #include <stb_image.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 
@@ -136,6 +137,7 @@ const char* const wima_assert_msgs[] = {
 	"client tried to push too many render contexts (scrollable layouts) onto the stack",
 	"window title is NULL",
 	"window is in both split and join modes; this is a bug in wima",
+	"cannot change headless mode after windows have been created",
 
 	"tree is not valid",
 	"node is beyond max number of nodes for the given tree",
@@ -174,6 +176,8 @@ const char* const wima_assert_msgs[] = {
 	"layout is not valid",
 	"layout does not have children",
 	"split layout already has 2 children",
+	"virtual list is not in an area region",
+	"virtual list has no row height or height function",
 
 	"widget is not valid",
 	"client tried to create too many widgets/layouts",
@@ -235,6 +239,13 @@ const char* const wima_assert_msgs[] = {
 	"icon is not valid",
 	"client tried to load too many icons",
 
+	"timer is not valid",
+	"client tried to start too many timers",
+	"timer function is NULL",
+	"timer delay or interval is negative or not finite",
+
+	"job function is NULL",
+
 	"overlay is not valid",
 	"client tried to register too many overlays",
 	"overlay name is NULL",
@@ -272,6 +283,14 @@ const char* const wima_assert_msgs[] = {
  */
 WimaG wg;
 
+/**
+ * Decodes an app icon. This is run in parallel for all
+ * icons, and failed icons have NULL pixels.
+ * @param data	The array of icon paths.
+ * @param idx	The index of the icon to decode.
+ */
+static void wima_init_appIcon(void* data, size_t idx);
+
 /**
  * @}
  */
@@ -327,6 +346,13 @@ WimaStatus wima_init(const char* name, WimaAppFuncs funcs, const char* fontPath,
 
 	wg.funcs = funcs;
 
+	wg.layoutRegion.widget = WIMA_WIDGET_INVALID;
+	wg.layoutRegion.region = WIMA_REGION_INVALID_IDX;
+
+#ifdef WIMA_HEADLESS
+	wg.headless = true;
+#endif
+
 	wg.name = dstr_create(name);
 	if (yerror(!wg.name)) goto wima_init_malloc_err;
 
@@ -336,6 +362,9 @@ WimaStatus wima_init(const char* name, WimaAppFuncs funcs, const char* fontPath,
 	wg.props = dnvec_vcreate(2, 0, wima_prop_destroy, wima_prop_copy, sizeof(WimaPropInfo), sizeof(WimaPropData));
 	if (yerror(!wg.props)) goto wima_init_malloc_err;
 
+	wg.propFree = dvec_create(0, sizeof(WimaProperty), NULL, NULL);
+	if (yerror(!wg.propFree)) goto wima_init_malloc_err;
+
 	wg.dirGrid = wima_prop_bool_register("wima_directory_grid", "Grid", "Lay out the directory in a grid",
 	                                     WIMA_ICON_INVALID, true);
 	if (yerror(wg.dirGrid == WIMA_PROP_INVALID)) goto wima_init_malloc_err;
@@ -352,10 +381,10 @@ WimaStatus wima_init(const char* name, WimaAppFuncs funcs, const char* fontPath,
 	wg.editors = dvec_create(0, sizeof(WimaEdtr), NULL, NULL);
 	if (yerror(!wg.editors)) goto wima_init_malloc_err;
 
-	wg.dialogs = dvec_createTreeVec(0, sizeof(WimaAr), wima_area_destroy, wima_area_copy);
+	wg.dialogs = dvec_create(0, sizeof(WimaArTree), wima_area_tree_destroy, wima_area_tree_copy);
 	if (yerror(!wg.dialogs)) goto wima_init_malloc_err;
 
-	wg.workspaces = dvec_createTreeVec(0, sizeof(WimaAr), wima_area_destroy, wima_area_copy);
+	wg.workspaces = dvec_create(0, sizeof(WimaArTree), wima_area_tree_destroy, wima_area_tree_copy);
 	if (yerror(!wg.workspaces)) goto wima_init_malloc_err;
 
 	wg.workspaceProps = dvec_create(0, sizeof(WimaProperty), NULL, NULL);
@@ -388,31 +417,31 @@ WimaStatus wima_init(const char* name, WimaAppFuncs funcs, const char* fontPath,
 	wg.imageFlags = dvec_create(0, sizeof(WimaImageFlags), NULL, NULL);
 	if (yerror(!wg.imageFlags)) goto wima_init_malloc_err;
 
+	wg.imageData = dvec_create(0, sizeof(WimaImg), NULL, NULL);
+	if (yerror(!wg.imageData)) goto wima_init_malloc_err;
+
 	wg.fontPath = dstr_create(fontPath);
 	if (yerror(!wg.fontPath)) goto wima_init_malloc_err;
 
-	int x;
-	int y;
-	int components;
-	uint8_t* data;
-	uint32_t i;
-
-	for (i = 0; i < numIcons; ++i)
-	{
-		data = stbi_load(iconPaths[i], &x, &y, &components, 4);
-		if (yerror(!data || components != 4)) goto wima_init_img_load_err;
+	status = wima_job_init();
+	if (yerror(status)) goto wima_init_err;
 
-		GLFWimage image;
+	status = wima_job_parallel(numIcons, wima_init_appIcon, (void*) iconPaths);
+	if (yerror(status)) goto wima_init_err;
 
-		image.pixels = data;
-		image.width = x;
-		image.height = y;
+	// Icons that failed are NULL, which
+	// wima_exit() can free just fine.
+	wg.numAppIcons = numIcons;
 
-		wg.appIcons[i] = image;
+	for (uint32_t i = 0; i < numIcons; ++i)
+	{
+		if (yerror(!wg.appIcons[i].pixels))
+		{
+			status = WIMA_STATUS_IMAGE_LOAD_ERR;
+			goto wima_init_err;
+		}
 	}
 
-	wg.numAppIcons = numIcons;
-
 	wg.areaOptionsMenu = wima_prop_menu_register("wima_area_options", "Area Options", NULL, WIMA_ICON_INVALID);
 	if (yerror(wg.areaOptionsMenu == WIMA_PROP_INVALID)) goto wima_init_malloc_err;
 
@@ -442,16 +471,11 @@ WimaStatus wima_init(const char* name, WimaAppFuncs funcs, const char* fontPath,
 		if (yerror(!wg.cursors[i])) goto wima_init_init_err;
 	}
 
-	return WIMA_STATUS_SUCCESS;
-
-wima_init_img_load_err:
-
-	if (data) stbi_image_free(data);
-
-	wg.numAppIcons = i;
+	// This needs GLFW for the time.
+	status = wima_timer_init();
+	if (yerror(status)) goto wima_init_err;
 
-	status = WIMA_STATUS_IMAGE_LOAD_ERR;
-	goto wima_init_err;
+	return WIMA_STATUS_SUCCESS;
 
 wima_init_init_err:
 
@@ -473,50 +497,86 @@ WimaStatus wima_main()
 {
 	wima_assert_init;
 
-	GLFWwindow* win = glfwGetCurrentContext();
-	if (yerror(!win)) return WIMA_STATUS_INVALID_STATE;
+	if (yerror(!glfwGetCurrentContext())) return WIMA_STATUS_INVALID_STATE;
 
-	if (yunlikely(glfwWindowShouldClose(win))) return WIMA_STATUS_SUCCESS;
-
-	while (true)
+	while (wima_window_closeAll())
 	{
-#ifdef WIMA_LOOP_TIMER
-		// This is to time the loop.
-		double time = glfwGetTime();
-#endif
+		wima_window_drawAll();
 
-		WimaWindow wwh = WIMA_WIN(win);
+		// Block until the next event unless something is
+		// due before then. Idle windows never wake up.
+		double deadline = wima_window_deadline();
+		double timer = wima_timer_deadline();
 
-		WimaStatus status = wima_window_draw(wwh);
-		if (yerror(status)) wima_error_desc(status, "Wima encountered an error while rendering.");
+		if (timer >= 0.0 && (deadline < 0.0 || timer < deadline)) deadline = timer;
 
-		if (!wima_window_hasTooltip(wwh))
-			glfwWaitEventsTimeout(0.75);
-		else
+		if (deadline < 0.0)
+		{
 			glfwWaitEvents();
+		}
+		else
+		{
+			double timeout = deadline - wima_time();
 
-		win = glfwGetCurrentContext();
+			if (timeout > 0.0)
+				glfwWaitEventsTimeout(timeout);
+			else
+				glfwPollEvents();
+		}
 
-		if (yunlikely(!win || glfwWindowShouldClose(win))) break;
+		// Events posted from other threads are
+		// processed with the rest of the events.
+		wima_event_dispatchUser();
 
-		wwh = WIMA_WIN(win);
+		// Images that finished decoding are
+		// uploaded when windows are drawn.
+		wima_image_update();
 
-		wima_window_processEvents(wwh);
+		wima_window_processAll();
 
-#ifdef WIMA_LOOP_TIMER
-		// This is to time the loop.
-		time = glfwGetTime() - time;
-		printf("Loop: %f ms\n", time * 1000.0f);
-#endif
+		wima_timer_process();
 	}
 
 	return WIMA_STATUS_SUCCESS;
 }
 
+void wima_setHeadless(bool headless)
+{
+	wima_assert_init;
+
+	wassert(dvec_len(wg.windows) == 0, WIMA_ASSERT_WIN_HEADLESS);
+
+	wg.headless = headless;
+}
+
+bool wima_headless()
+{
+	return wg.headless;
+}
+
 void wima_exit()
 {
 	wima_assert_init;
 
+	// Jobs can use anything, so they must finish first.
+	wima_job_exit();
+
+	// This needs the timer, so GLFW must still be initialized.
+	wima_trace_free();
+
+	wima_event_freeUser();
+
+	wima_timer_free();
+
+	// Windows delete their GL objects in their own
+	// contexts, so they must go before GLFW does.
+	if (wg.windows) dvec_free(wg.windows);
+
+	// Windows use these, so they go after, but
+	// they own GL textures, so they go before GLFW.
+	wima_image_free();
+	wima_render_share_free();
+
 	if (wg.glfwInitialized) glfwTerminate();
 
 	for (size_t i = 0; i < wg.numAppIcons; ++i) stbi_image_free(wg.appIcons[i].pixels);
@@ -552,7 +612,8 @@ void wima_exit()
 		dnvec_free(wg.props);
 	}
 
-	if (wg.windows) dvec_free(wg.windows);
+	if (wg.propFree) dvec_free(wg.propFree);
+	if (wg.propIndex) free(wg.propIndex);
 
 	if (wg.name)
 	{
@@ -567,4 +628,35 @@ void wima_exit()
 // private functions.
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+// Static functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void wima_init_appIcon(void* data, size_t idx)
+{
+	const char** paths = (const char**) data;
+
+	int x = 0;
+	int y = 0;
+	int components;
+
+	wg.appIcons[idx].pixels = NULL;
+	wg.appIcons[idx].width = 0;
+	wg.appIcons[idx].height = 0;
+
+	uint8_t* pixels = stbi_load(paths[idx], &x, &y, &components, 4);
+	if (!pixels) return;
+
+	// Only images that are already RGBA are accepted.
+	if (components != 4)
+	{
+		stbi_image_free(pixels);
+		return;
+	}
+
+	wg.appIcons[idx].pixels = pixels;
+	wg.appIcons[idx].width = x;
+	wg.appIcons[idx].height = y;
+}
+
 //! @endcond Doxygen suppress.
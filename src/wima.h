@@ -48,8 +48,11 @@ extern "C" {
 #include <wima/render.h>
 #include <wima/wima.h>
 
+#include "events/event.h"
+#include "jobs/job.h"
 #include "props/prop.h"
 #include "render/render.h"
+#include "time/time.h"
 
 #include <GLFW/glfw3.h>
 #include <dyna/pool.h>
@@ -83,6 +86,20 @@ typedef struct WimaG
 	/// Properties.
 	DynaNVector props;
 
+	/// An open-addressing hash index from prop names
+	/// to props. Empty slots are WIMA_PROP_INVALID.
+	WimaProperty* propIndex;
+
+	/// The capacity of @a propIndex (a power of 2).
+	uint32_t propIndexCap;
+
+	/// The number of props in @a propIndex.
+	uint32_t propIndexLen;
+
+	/// Indices in @a props of freed props,
+	/// which are reused before pushing.
+	DynaVector propFree;
+
 	/// Custom properties. These become custom
 	/// widgets in the user interface.
 	DynaVector customProps;
@@ -93,6 +110,12 @@ typedef struct WimaG
 	/// Workspace properties. These are the names and icons.
 	DynaVector workspaceProps;
 
+	/// The version of each workspace tree. This is bumped
+	/// whenever the tree is updated from a window, and
+	/// windows copy it again when their copy is older.
+	/// It is never 0 for a registered workspace.
+	uint32_t workspaceVersions[WIMA_WORKSPACE_MAX];
+
 	/// Dialog types.
 	DynaVector dialogs;
 
@@ -134,12 +157,51 @@ typedef struct WimaG
 	/// Image flags.
 	DynaVector imageFlags;
 
+	/// Decoded images (@a WimaImg).
+	DynaVector imageData;
+
+	/// Images that have been decoded on the thread
+	/// pool, but not put in @a imageData yet.
+	_Atomic(WimaImageDecode*) imagesDecoded;
+
+	/// Incremented every time images finish
+	/// decoding, so render contexts know
+	/// when to upload them.
+	uint32_t imageVersion;
+
 	/// The app-wide callbacks.
 	WimaAppFuncs funcs;
 
+	/// Timers.
+	WimaTimerWheel timers;
+
+	/// The thread pool.
+	WimaJobPool jobs;
+
+	/// User events that have been posted from any
+	/// thread, but not moved to windows' queues yet.
+	_Atomic(WimaUserEventNode*) userEvents;
+
+	/// Trace buffers of all threads that have recorded
+	/// spans since tracing was started.
+	_Atomic(WimaTraceThread*) traceThreads;
+
+	/// The path to write traces to, or NULL
+	/// if tracing was never started.
+	DynaString tracePath;
+
+	/// The next thread ID for traces.
+	atomic_uint traceIds;
+
+	/// Whether or not spans are being recorded.
+	atomic_bool tracing;
+
 	/// The path to the font file.
 	DynaString fontPath;
 
+	/// GL resources shared by all windows.
+	WimaRenderShare render;
+
 	/// A property that says whether to draw path
 	/// props as grids or not.
 	WimaProperty dirGrid;
@@ -157,6 +219,17 @@ typedef struct WimaG
 	/// properties for all themes.
 	WimaProperty themes[WIMA_THEME_NUM_TYPES];
 
+	/// Incremented every time the theme changes.
+	/// This lets cached drawings know when they
+	/// need to be redrawn.
+	uint32_t themeVersion;
+
+	/// The region being generated, as a widget with
+	/// an invalid index. Props read while its region
+	/// is not @a WIMA_REGION_INVALID_IDX are linked to
+	/// it, so it is generated again when they change.
+	WimaWidget layoutRegion;
+
 	/// Whether or not GLFW is initialized.
 	/// This is put here because there is a
 	/// four byte hole.
@@ -165,6 +238,9 @@ typedef struct WimaG
 	/// Whether glad has been loaded or not.
 	bool gladLoaded;
 
+	/// Whether windows are headless or not.
+	bool headless;
+
 	/// The number of app icons.
 	uint16_t numAppIcons;
 
@@ -215,6 +291,7 @@ typedef enum WimaAssertType
 	WIMA_ASSERT_WIN_RENDER_STACK_MAX,
 	WIMA_ASSERT_WIN_TITLE,
 	WIMA_ASSERT_WIN_SPLIT_JOIN,
+	WIMA_ASSERT_WIN_HEADLESS,
 
 	WIMA_ASSERT_TREE,
 	WIMA_ASSERT_TREE_MAX,
@@ -253,6 +330,8 @@ typedef enum WimaAssertType
 	WIMA_ASSERT_LAYOUT,
 	WIMA_ASSERT_LAYOUT_NO_CHILDREN,
 	WIMA_ASSERT_LAYOUT_SPLIT_MAX,
+	WIMA_ASSERT_LAYOUT_LIST_REGION,
+	WIMA_ASSERT_LAYOUT_LIST_HEIGHT,
 
 	WIMA_ASSERT_WIDGET,
 	WIMA_ASSERT_WIDGET_MAX,
@@ -314,6 +393,13 @@ typedef enum WimaAssertType
 	WIMA_ASSERT_ICON,
 	WIMA_ASSERT_ICON_MAX,
 
+	WIMA_ASSERT_TIMER,
+	WIMA_ASSERT_TIMER_MAX,
+	WIMA_ASSERT_TIMER_FUNC,
+	WIMA_ASSERT_TIMER_TIME,
+
+	WIMA_ASSERT_JOB_FUNC,
+
 	WIMA_ASSERT_OVERLAY,
 	WIMA_ASSERT_OVERLAY_MAX,
 	WIMA_ASSERT_OVERLAY_NAME,
@@ -56,10 +56,10 @@ WimaDialog wima_dialog_register(WimaTree tree)
 
 	wassert(len < WIMA_DIALOG_MAX, WIMA_ASSERT_DIALOG_MAX);
 
-	WimaDlg dlg = dvec_pushTree(wg.dialogs);
+	WimaDlg dlg = wima_area_tree_push(wg.dialogs);
 	if (yerror(!dlg)) goto wima_dlg_reg_push;
 
-	if (yerror(dtree_copy(dlg, tree))) goto wima_dlg_reg_copy;
+	if (yerror(wima_area_tree_copy(dlg, tree))) goto wima_dlg_reg_copy;
 
 	return len;
 
@@ -46,6 +46,8 @@ extern "C" {
 
 #include <wima/wima.h>
 
+#include "../areas/area.h"
+
 /**
  * @file dialog.h
  */
@@ -59,7 +61,7 @@ extern "C" {
 /**
  * A dialog, which can be broken down into areas.
  */
-typedef DynaTree WimaDlg;
+typedef WimaArTree* WimaDlg;
 
 /**
  * Checks whether @a n is valid within @a wwh.
@@ -67,7 +69,7 @@ typedef DynaTree WimaDlg;
  * @param n		The node to test.
  * @return		true if @a n is valid, false otherwise.
  */
-bool wima_dialog_nodeValid(WimaDialog wwh, DynaNode n);
+bool wima_dialog_nodeValid(WimaDialog wwh, WimaAreaNode n);
 
 /**
  * @}
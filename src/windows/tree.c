@@ -41,11 +41,11 @@
 #include "../areas/area.h"
 #include "../areas/region.h"
 
-#include <dyna/tree.h>
 #include <yc/error.h>
 
 #include <math.h>
 #include <stdbool.h>
+#include <string.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Static function declarations needed for public functions.
@@ -67,32 +67,35 @@
 /**
  * Adds a parent node to @a tree.
  * @param tree		The tree to add to.
- * @param node		The node to add, which should be either
- *					the root, or a child of a node that has
- *					already been added.
+ * @param parent	The parent of the new node, or
+ *					WIMA_AREA_INVALID for the root.
+ * @param left		Whether the new node is the left
+ *					child of @a parent.
  * @param split		A value between [0, 1] that indicates
  *					where the split between this parent's
  *					children will be.
  * @param vertical	Whether the split is vertical (splitting
  *					width) or not.
- * @return			WIMA_STATUS_SUCCESS on success, or an
- *					error code.
+ * @return			The new node, or WIMA_AREA_INVALID
+ *					on error.
  * @pre				@a tree must not be NULL.
  */
-static WimaStatus wima_tree_addParent(WimaTree tree, DynaNode node, float split, bool vertical) yallnonnull;
+static WimaAreaNode wima_tree_addParent(WimaTree tree, WimaAreaNode parent, bool left, float split,
+                                        bool vertical) yallnonnull;
 
 /**
  * Adds an editor (leaf) to @a tree.
- * @param tree	The tree to add to.
- * @param node	The node to add, which should be either
- *				the root, or a child of a node that has
- *				already been added.
- * @param wed	The editor to set the type as.
- * @return		WIMA_STATUS_SUCCESS on success, or an
- *				error code.
- * @pre			@a tree must not be NULL.
+ * @param tree		The tree to add to.
+ * @param parent	The parent of the new node, or
+ *					WIMA_AREA_INVALID for the root.
+ * @param left		Whether the new node is the left
+ *					child of @a parent.
+ * @param wed		The editor to set the type as.
+ * @return			The new node, or WIMA_AREA_INVALID
+ *					on error.
+ * @pre				@a tree must not be NULL.
  */
-static WimaStatus wima_tree_addEditor(WimaTree tree, DynaNode node, WimaEditor wed) yallnonnull;
+static WimaAreaNode wima_tree_addEditor(WimaTree tree, WimaAreaNode parent, bool left, WimaEditor wed) yallnonnull;
 
 #ifdef __YASSERT__
 /**
@@ -103,7 +106,7 @@ static WimaStatus wima_tree_addEditor(WimaTree tree, DynaNode node, WimaEditor w
  * @return		true if valid, false otherwise.
  * @pre			@a tree must not be NULL.
  */
-static bool wima_tree_nodeValid(WimaTree tree, DynaNode n) yallnonnull yinline;
+static bool wima_tree_nodeValid(WimaTree tree, WimaAreaNode n) yallnonnull yinline;
 #endif  // __YASSERT__
 
 /**
@@ -121,7 +124,7 @@ static bool wima_tree_nodeValid(WimaTree tree, DynaNode n) yallnonnull yinline;
 WimaTree wima_tree_create()
 {
 	wima_assert_init;
-	return dtree_create(0, sizeof(WimaAr), wima_area_destroy, wima_area_copy);
+	return wima_area_tree_create();
 }
 
 WimaAreaNode wima_tree_addRootParent(WimaTree tree, float split, bool vertical)
@@ -130,19 +133,9 @@ WimaAreaNode wima_tree_addRootParent(WimaTree tree, float split, bool vertical)
 
 	wassert(tree, WIMA_ASSERT_TREE);
 
-	DynaNode root = dtree_root();
+	wassert(!wima_area_tree_exists(tree, WIMA_AREA_TREE_ROOT), WIMA_ASSERT_TREE_NODE_EXISTS);
 
-	wassert(!dtree_exists(tree, root), WIMA_ASSERT_TREE_NODE_EXISTS);
-
-	WimaStatus status = wima_tree_addParent(tree, root, split, vertical);
-
-	if (yerror(status))
-	{
-		wima_error(status);
-		return WIMA_AREA_INVALID;
-	}
-
-	return (WimaAreaNode) root;
+	return wima_tree_addParent(tree, WIMA_AREA_INVALID, false, split, vertical);
 }
 
 WimaAreaNode wima_tree_addRootEditor(WimaTree tree, WimaEditor wed)
@@ -151,19 +144,9 @@ WimaAreaNode wima_tree_addRootEditor(WimaTree tree, WimaEditor wed)
 
 	wassert(tree, WIMA_ASSERT_TREE);
 
-	DynaNode root = dtree_root();
-
-	wassert(!dtree_exists(tree, root), WIMA_ASSERT_TREE_NODE_EXISTS);
+	wassert(!wima_area_tree_exists(tree, WIMA_AREA_TREE_ROOT), WIMA_ASSERT_TREE_NODE_EXISTS);
 
-	WimaStatus status = wima_tree_addEditor(tree, root, wed);
-
-	if (yerror(status))
-	{
-		wima_error(status);
-		return WIMA_AREA_INVALID;
-	}
-
-	return (WimaAreaNode) root;
+	return wima_tree_addEditor(tree, WIMA_AREA_INVALID, false, wed);
 }
 
 WimaAreaNode wima_tree_addLeftParent(WimaTree tree, WimaAreaNode parent, float split, bool vertical)
@@ -173,21 +156,9 @@ WimaAreaNode wima_tree_addLeftParent(WimaTree tree, WimaAreaNode parent, float s
 	wassert(tree, WIMA_ASSERT_TREE);
 
 	wassert(wima_tree_nodeValid(tree, parent), WIMA_ASSERT_TREE_NODE);
+	wassert(wima_area_tree_left(tree, parent) == WIMA_AREA_INVALID, WIMA_ASSERT_TREE_NODE_EXISTS);
 
-	DynaNode node = dtree_left(parent);
-
-	wassert(!dtree_exists(tree, node), WIMA_ASSERT_TREE_NODE_EXISTS);
-	wassert(node <= WIMA_TREE_NODE_MAX, WIMA_ASSERT_TREE_MAX);
-
-	WimaStatus status = wima_tree_addParent(tree, node, split, vertical);
-
-	if (yerror(status))
-	{
-		wima_error(status);
-		return WIMA_AREA_INVALID;
-	}
-
-	return (WimaAreaNode) node;
+	return wima_tree_addParent(tree, parent, true, split, vertical);
 }
 
 WimaAreaNode wima_tree_addLeftEditor(WimaTree tree, WimaAreaNode parent, WimaEditor wed)
@@ -197,21 +168,9 @@ WimaAreaNode wima_tree_addLeftEditor(WimaTree tree, WimaAreaNode parent, WimaEdi
 	wassert(tree, WIMA_ASSERT_TREE);
 
 	wassert(wima_tree_nodeValid(tree, parent), WIMA_ASSERT_TREE_NODE);
+	wassert(wima_area_tree_left(tree, parent) == WIMA_AREA_INVALID, WIMA_ASSERT_TREE_NODE_EXISTS);
 
-	DynaNode node = dtree_left(parent);
-
-	wassert(!dtree_exists(tree, node), WIMA_ASSERT_TREE_NODE_EXISTS);
-	wassert(node <= WIMA_TREE_NODE_MAX, WIMA_ASSERT_TREE_MAX);
-
-	WimaStatus status = wima_tree_addEditor(tree, node, wed);
-
-	if (yerror(status))
-	{
-		wima_error(status);
-		return WIMA_AREA_INVALID;
-	}
-
-	return (WimaAreaNode) node;
+	return wima_tree_addEditor(tree, parent, true, wed);
 }
 
 WimaAreaNode wima_tree_addRightParent(WimaTree tree, WimaAreaNode parent, float split, bool vertical)
@@ -221,21 +180,9 @@ WimaAreaNode wima_tree_addRightParent(WimaTree tree, WimaAreaNode parent, float
 	wassert(tree, WIMA_ASSERT_TREE);
 
 	wassert(wima_tree_nodeValid(tree, parent), WIMA_ASSERT_TREE_NODE);
+	wassert(wima_area_tree_right(tree, parent) == WIMA_AREA_INVALID, WIMA_ASSERT_TREE_NODE_EXISTS);
 
-	DynaNode node = dtree_right(parent);
-
-	wassert(!dtree_exists(tree, node), WIMA_ASSERT_TREE_NODE_EXISTS);
-	wassert(node <= WIMA_TREE_NODE_MAX, WIMA_ASSERT_TREE_MAX);
-
-	WimaStatus status = wima_tree_addParent(tree, node, split, vertical);
-
-	if (yerror(status))
-	{
-		wima_error(status);
-		return WIMA_AREA_INVALID;
-	}
-
-	return (WimaAreaNode) node;
+	return wima_tree_addParent(tree, parent, false, split, vertical);
 }
 
 WimaAreaNode wima_tree_addRightEditor(WimaTree tree, WimaAreaNode parent, WimaEditor wed)
@@ -245,38 +192,27 @@ WimaAreaNode wima_tree_addRightEditor(WimaTree tree, WimaAreaNode parent, WimaEd
 	wassert(tree, WIMA_ASSERT_TREE);
 
 	wassert(wima_tree_nodeValid(tree, parent), WIMA_ASSERT_TREE_NODE);
+	wassert(wima_area_tree_right(tree, parent) == WIMA_AREA_INVALID, WIMA_ASSERT_TREE_NODE_EXISTS);
 
-	DynaNode node = dtree_right(parent);
-
-	wassert(!dtree_exists(tree, node), WIMA_ASSERT_TREE_NODE_EXISTS);
-	wassert(node <= WIMA_TREE_NODE_MAX, WIMA_ASSERT_TREE_MAX);
-
-	WimaStatus status = wima_tree_addEditor(tree, node, wed);
-
-	if (yerror(status))
-	{
-		wima_error(status);
-		return WIMA_AREA_INVALID;
-	}
-
-	return (WimaAreaNode) node;
+	return wima_tree_addEditor(tree, parent, false, wed);
 }
 
 WimaStatus wima_tree_reset(WimaTree tree)
 {
-	return dtree_empty(tree) ? WIMA_STATUS_MALLOC_ERR : WIMA_STATUS_SUCCESS;
+	wima_area_tree_empty(tree);
+	return WIMA_STATUS_SUCCESS;
 }
 
 void wima_tree_free(WimaTree tree)
 {
-	dtree_free(tree);
+	wima_area_tree_free(tree);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Private static functions.
 ////////////////////////////////////////////////////////////////////////////////
 
-static WimaStatus wima_tree_addParent(WimaTree tree, DynaNode node, float split, bool vertical)
+static WimaAreaNode wima_tree_addParent(WimaTree tree, WimaAreaNode parent, bool left, float split, bool vertical)
 {
 	WimaAr wan;
 
@@ -287,19 +223,24 @@ static WimaStatus wima_tree_addParent(WimaTree tree, DynaNode node, float split,
 	wan.parent.vertical = vertical;
 	wan.parent.split = fabs(split);
 
-	DynaStatus status = dtree_add(tree, node, &wan);
+	WimaAreaNode node = wima_area_tree_add(tree, parent, left, &wan);
+
+	if (yerror(node == WIMA_AREA_INVALID)) wima_error(WIMA_STATUS_MALLOC_ERR);
 
-	return status ? WIMA_STATUS_MALLOC_ERR : WIMA_STATUS_SUCCESS;
+	return node;
 }
 
-static WimaStatus wima_tree_addEditor(WimaTree tree, DynaNode node, WimaEditor wed)
+static WimaAreaNode wima_tree_addEditor(WimaTree tree, WimaAreaNode parent, bool left, WimaEditor wed)
 {
 	WimaAr wan;
 
 	wassert(wed < dvec_len(wg.editors), WIMA_ASSERT_EDITOR);
 
+	// Clear everything so the destructor
+	// knows what has not been allocated.
+	memset(&wan, 0, sizeof(WimaAr));
+
 	wan.isParent = false;
-	wan.node = node;
 	wan.rect.w = -1;
 	wan.rect.h = -1;
 
@@ -324,13 +265,18 @@ static WimaStatus wima_tree_addEditor(WimaTree tree, DynaNode node, WimaEditor w
 		wan.area.regions[i].flags = reg->flags;
 	}
 
-	return dtree_add(tree, node, &wan) ? WIMA_STATUS_MALLOC_ERR : WIMA_STATUS_SUCCESS;
+	// This sets the node of the area.
+	WimaAreaNode node = wima_area_tree_add(tree, parent, left, &wan);
+
+	if (yerror(node == WIMA_AREA_INVALID)) wima_error(WIMA_STATUS_MALLOC_ERR);
+
+	return node;
 }
 
 #ifdef __YASSERT__
-static bool wima_tree_nodeValid(WimaTree tree, DynaNode p)
+static bool wima_tree_nodeValid(WimaTree tree, WimaAreaNode p)
 {
-	return dtree_exists(tree, p) && WIMA_AREA_IS_PARENT((WimaAr*) dtree_node(tree, p));
+	return wima_area_tree_exists(tree, p) && WIMA_AREA_IS_PARENT(wima_area_tree_node(tree, p));
 }
 #endif  // __YASSERT__
 
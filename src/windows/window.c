@@ -36,12 +36,13 @@
 
 #include <wima/math.h>
 #include <wima/render.h>
+#include <wima/time.h>
 #include <wima/wima.h>
 
 #include <dyna/dyna.h>
-#include <dyna/tree.h>
 #include <yc/error.h>
 
+#include <math.h>
 #include <stdbool.h>
 #include <string.h>
 
@@ -49,6 +50,7 @@
 #define NANOVG_GL3_IMPLEMENTATION
 #include <nanovg.h>
 #include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
 //! @endcond Doxygen suppress.
 
 #include "dialog.h"
@@ -98,6 +100,26 @@ static void wima_window_setMinSize(WimaWin* win, WimaSizef* size);
 
 static WimaStatus wima_window_layoutHeader(WimaWin* win, WimaWindow wwh, WimaSizef* min);
 
+/**
+ * Makes sure that the framebuffer of @a win is the same
+ * size as the window's framebuffer, recreating it if not.
+ * A recreated framebuffer has nothing in it, so the
+ * window is marked dirty in that case.
+ * @param win	The window whose framebuffer will be checked.
+ * @return		WIMA_STATUS_SUCCESS on success, an error
+ *				code otherwise.
+ */
+static WimaStatus wima_window_checkFramebuffer(WimaWin* win);
+
+/**
+ * Checks whether drawing @a win will render anything,
+ * which means its context needs to be current.
+ * @param win	The window to check.
+ * @return		true if @a win will render,
+ *				false otherwise.
+ */
+static bool wima_window_needsDraw(WimaWin* win);
+
 /**
  * @}
  */
@@ -135,7 +157,8 @@ WimaWindow wima_window_create(WimaWorkspace wksph, WimaSize size, bool maximized
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	glfwWindowHint(GLFW_MAXIMIZED, maximized ? GLFW_TRUE : GLFW_FALSE);
-	glfwWindowHint(GLFW_FOCUSED, GLFW_TRUE);
+	glfwWindowHint(GLFW_VISIBLE, wg.headless ? GLFW_FALSE : GLFW_TRUE);
+	glfwWindowHint(GLFW_FOCUSED, wg.headless ? GLFW_FALSE : GLFW_TRUE);
 	glfwWindowHint(GLFW_DECORATED, decorated ? GLFW_TRUE : GLFW_FALSE);
 	glfwWindowHint(GLFW_RESIZABLE, resizable ? GLFW_TRUE : GLFW_FALSE);
 
@@ -151,7 +174,17 @@ WimaWindow wima_window_create(WimaWorkspace wksph, WimaSize size, bool maximized
 		goto wima_win_create_name_glfw_err;
 	}
 
-	GLFWwindow* win = glfwCreateWindow(size.w, size.h, name, NULL, NULL);
+	GLFWwindow* share = NULL;
+
+	// Every window shares GL objects with the others, so
+	// textures are created once. Any live window will do
+	// since they are all in the same share group.
+	for (size_t i = 0; !share && i < len; ++i)
+	{
+		if (wima_window_valid(i)) share = ((WimaWin*) dvec_get(wg.windows, i))->window;
+	}
+
+	GLFWwindow* win = glfwCreateWindow(size.w, size.h, name, NULL, share);
 	if (yerror(!win))
 	{
 		dstr_free(wwin.name);
@@ -161,8 +194,8 @@ WimaWindow wima_window_create(WimaWorkspace wksph, WimaSize size, bool maximized
 
 	wwin.window = win;
 
-	wwin.images = dvec_create(0, sizeof(int), NULL, NULL);
-	if (yerror(!wwin.images)) goto wima_win_create_noptr_err;
+	wwin.render.images = dvec_create(0, sizeof(int), NULL, NULL);
+	if (yerror(!wwin.render.images)) goto wima_win_create_noptr_err;
 
 	int w, h;
 
@@ -223,22 +256,32 @@ WimaWindow wima_window_create(WimaWorkspace wksph, WimaSize size, bool maximized
 	window->overlayStack = dvec_create(0, sizeof(WimaWinOverlay), NULL, NULL);
 	if (yerror(!window->overlayStack)) goto wima_win_create_malloc_err;
 
-	window->overlayItems = dvec_create(0, sizeof(WimaItem), NULL, NULL);
+	window->overlayItems = wima_item_store_create(NULL);
 	if (yerror(!window->overlayItems)) goto wima_win_create_malloc_err;
 
 	window->overlayPool = dpool_create(WIMA_POOL_LOAD, sizeof(uint64_t), NULL, NULL, NULL);
 	if (yerror(!window->overlayPool)) goto wima_win_create_malloc_err;
 
 	size_t cap = dvec_cap(wg.workspaces);
+	size_t wkspLen = dvec_len(wg.workspaces);
 
-	window->workspaces = dvec_createTreeVec(cap, sizeof(WimaAr), wima_area_destroy, wima_area_copy);
+	window->workspaces = dvec_create(cap, sizeof(WimaArTree), wima_area_tree_destroy, wima_area_tree_copy);
 	if (yerror(!window->workspaces)) goto wima_win_create_malloc_err;
 
-	if (yerror(dvec_copy(window->workspaces, wg.workspaces))) goto wima_win_create_malloc_err;
-
 	window->workspaceSizes = dvec_create(cap, sizeof(WimaSizef), NULL, NULL);
 	if (yerror(!window->workspaceSizes)) goto wima_win_create_malloc_err;
 
+	WimaSizef none;
+	none.w = none.h = 0.0f;
+
+	// Workspaces are not copied until they are shown,
+	// so windows start with empty trees for them.
+	for (size_t i = 0; i < wkspLen; ++i)
+	{
+		if (yerror(!wima_area_tree_push(window->workspaces))) goto wima_win_create_malloc_err;
+		if (yerror(dvec_push(window->workspaceSizes, &none))) goto wima_win_create_malloc_err;
+	}
+
 	window->rootLayouts = dvec_create(cap, sizeof(WimaLayout), NULL, NULL);
 	if (yerror(!window->rootLayouts)) goto wima_win_create_malloc_err;
 
@@ -277,6 +320,8 @@ WimaStatus wima_window_activate(WimaWindow wwh)
 
 	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
 
+	uint64_t span = wima_trace_begin();
+
 	WimaWin* win = dvec_get(wg.windows, wwh);
 
 	if (WIMA_WIN_HAS_HEADER(win) && wg.funcs.win_header)
@@ -285,35 +330,19 @@ WimaStatus wima_window_activate(WimaWindow wwh)
 		if (yerror(status)) return status;
 	}
 
-	WimaRect rect;
-
-	rect.x = 0;
-	rect.y = win->headerMinSize.h;
-	rect.w = win->fbsize.w;
-	rect.h = win->fbsize.h - win->headerMinSize.h;
-
-	uint8_t wkspLen = dvec_len(wg.workspaces);
-
-#ifdef __YASSERT__
-	win->ctx.stage = WIMA_UI_STAGE_LAYOUT;
-#endif
-
-	for (uint8_t i = 0; i < wkspLen; ++i)
-	{
-		status = wima_area_init(wwh, dvec_get(win->workspaces, i), rect, &min);
-		if (yerror(status)) return status;
-
-		wima_window_setMinSize(win, &min);
-
-		DynaStatus dstatus = dvec_push(win->workspaceSizes, &min);
-		if (dstatus) return WIMA_STATUS_MALLOC_ERR;
-	}
+	// Only the workspace that is shown is set up.
+	// The rest are set up when they are first shown.
+	status = wima_window_initWorkspace(win, wwh, win->wksp);
+	if (yerror(status)) return status;
 
 	wima_window_clearContext(&win->ctx);
 	wima_window_setDirty(win, true);
 
+	// Headless windows never wait for the vertical blank.
+	win->swapInterval = !wg.headless;
+
 	glfwMakeContextCurrent(win->window);
-	glfwSwapInterval(1);
+	glfwSwapInterval(win->swapInterval);
 
 	if (yerror(!wg.gladLoaded && !gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))) return WIMA_STATUS_OPENGL_ERR;
 
@@ -322,26 +351,17 @@ WimaStatus wima_window_activate(WimaWindow wwh)
 	win->render.nvg = nvgCreateGL3(NVG_ANTIALIAS);
 	if (yerror(!win->render.nvg)) return WIMA_STATUS_MALLOC_ERR;
 
-	win->render.font = nvgCreateFont(win->render.nvg, "default", dstr_str(wg.fontPath));
-	if (yerror(win->render.font == -1)) return WIMA_STATUS_MALLOC_ERR;
-
-	size_t imgLen = dvec_len(wg.imagePaths);
+	win->fb = nvgluCreateFramebuffer(win->render.nvg, win->fbsize.w, win->fbsize.h, 0);
+	if (yerror(!win->fb)) return WIMA_STATUS_OPENGL_ERR;
 
-	if (imgLen > 0)
-	{
-		WimaImageFlags* flags = dvec_get(wg.imageFlags, 0);
-
-		for (size_t i = 0; i < imgLen; ++i)
-		{
-			DynaString path = dvec_get(wg.imagePaths, i);
-
-			status = wima_window_addImage(win, dstr_str(path), flags[i]);
-			if (yerror(status)) return status;
-		}
-	}
+	status = wima_render_share_init(&win->render);
+	if (yerror(status)) return status;
 
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
+	// Failures are not traced; they are fatal anyway.
+	wima_trace_end(span, "window: activate", wwh);
+
 	return status;
 }
 
@@ -376,6 +396,34 @@ bool wima_window_headerEnabled(WimaWindow wwh)
 	return (((WimaWin*) dvec_get(wg.windows, wwh))->flags & WIMA_WIN_HEADER) != 0;
 }
 
+void wima_window_enableAreaCache(WimaWindow wwh)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	win->areaCache = true;
+	wima_window_setDirty(win, false);
+}
+
+void wima_window_disableAreaCache(WimaWindow wwh)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	// The caches themselves are freed on the next draw,
+	// when we know that the window's context is current.
+	win->areaCache = false;
+	wima_window_setDirty(win, false);
+}
+
+bool wima_window_areaCacheEnabled(WimaWindow wwh)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+	return ((WimaWin*) dvec_get(wg.windows, wwh))->areaCache;
+}
+
 void wima_window_setFocused(WimaWindow wwh)
 {
 	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
@@ -609,9 +657,9 @@ void wima_window_setHoverWidget(WimaWindow wwh, WimaWidget wih)
 
 	WimaWin* win = dvec_get(wg.windows, wwh);
 
-	wassert(dtree_exists(WIMA_WIN_AREAS(win), wih.area), WIMA_ASSERT_AREA);
-	wassert(WIMA_AREA_IS_LEAF(((WimaAr*) dtree_node(WIMA_WIN_AREAS(win), wih.area))), WIMA_ASSERT_AREA_LEAF);
-	wassert(wih.widget < dvec_len(wima_item_vector(wwh, wih.area, wih.region)), WIMA_ASSERT_WIDGET);
+	wassert(wima_area_tree_exists(WIMA_WIN_AREAS(win), wih.area), WIMA_ASSERT_AREA);
+	wassert(WIMA_AREA_IS_LEAF(((WimaAr*) wima_area_tree_node(WIMA_WIN_AREAS(win), wih.area))), WIMA_ASSERT_AREA_LEAF);
+	wassert(wih.widget < wima_item_len(wima_item_store(wwh, wih.area, wih.region)), WIMA_ASSERT_WIDGET);
 
 	win->ctx.hover = wih;
 }
@@ -629,9 +677,9 @@ void wima_window_setFocusWidget(WimaWindow wwh, WimaWidget wih)
 
 	WimaWin* win = dvec_get(wg.windows, wwh);
 
-	wassert(dtree_exists(WIMA_WIN_AREAS(win), wih.area), WIMA_ASSERT_AREA);
-	wassert(WIMA_AREA_IS_LEAF(((WimaAr*) dtree_node(WIMA_WIN_AREAS(win), wih.area))), WIMA_ASSERT_AREA_LEAF);
-	wassert(wih.widget < dvec_len(wima_item_vector(wwh, wih.area, wih.region)), WIMA_ASSERT_WIDGET);
+	wassert(wima_area_tree_exists(WIMA_WIN_AREAS(win), wih.area), WIMA_ASSERT_AREA);
+	wassert(WIMA_AREA_IS_LEAF(((WimaAr*) wima_area_tree_node(WIMA_WIN_AREAS(win), wih.area))), WIMA_ASSERT_AREA_LEAF);
+	wassert(wih.widget < wima_item_len(wima_item_store(wwh, wih.area, wih.region)), WIMA_ASSERT_WIDGET);
 
 	win->ctx.focus = wih;
 }
@@ -648,11 +696,116 @@ void wima_window_clearEvents(WimaWindow wwh)
 
 	WimaWin* win = dvec_get(wg.windows, wwh);
 
-	win->ctx.eventCount = 0;
+	wima_event_clear(&win->events);
+
 	win->ctx.scroll.x = 0;
 	win->ctx.scroll.y = 0;
 }
 
+WimaStatus wima_window_postEvent(WimaWindow wwh, WimaUserEvent event)
+{
+	wima_assert_init;
+
+	// The window is not checked here because that is
+	// not thread-safe. It is checked on dispatch.
+	WimaStatus status = wima_event_post(wwh, event);
+	if (yerror(status)) return status;
+
+	glfwPostEmptyEvent();
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+void wima_window_injectKey(WimaWindow wwh, WimaKeyEvent e)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	wima_callback_key(win->window, e.key, e.scancode, e.action, e.mods);
+}
+
+void wima_window_injectMouseBtn(WimaWindow wwh, WimaMouseBtnEvent e)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	// GLFW gives buttons as indices, not flags.
+	wima_callback_mouseBtn(win->window, wima_uint8_log2((uint8_t) e.button), e.action, e.mods);
+}
+
+void wima_window_injectMousePos(WimaWindow wwh, WimaVec pos)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	wima_callback_mousePos(win->window, pos.x, pos.y);
+}
+
+void wima_window_injectScroll(WimaWindow wwh, WimaScrollEvent e)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	// GLFW does not give mods with scrolls,
+	// so the callback uses the last ones.
+	win->ctx.mods = e.mods;
+
+	wima_callback_scroll(win->window, e.xoffset, e.yoffset);
+}
+
+void wima_window_injectChar(WimaWindow wwh, WimaCharEvent e)
+{
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	wima_callback_charMod(win->window, e.code, e.mods);
+}
+
+WimaStatus wima_window_step(WimaWindow wwh)
+{
+	wima_assert_init;
+
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	if (win->window != glfwGetCurrentContext()) glfwMakeContextCurrent(win->window);
+
+	wima_event_dispatchUser();
+	wima_image_update();
+
+	WimaStatus status = wima_window_processEvents(wwh);
+	if (yerror(status)) return status;
+
+	return wima_window_draw(wwh);
+}
+
+WimaStatus wima_window_readPixels(WimaWindow wwh, uint8_t* pixels)
+{
+	wima_assert_init;
+
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* win = dvec_get(wg.windows, wwh);
+
+	// The window has not been activated.
+	if (yerror(!win->fb)) return WIMA_STATUS_INVALID_STATE;
+
+	if (win->window != glfwGetCurrentContext()) glfwMakeContextCurrent(win->window);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, win->fb->fbo);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, win->fbsize.w, win->fbsize.h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+	return glGetError() == GL_NO_ERROR ? WIMA_STATUS_SUCCESS : WIMA_STATUS_OPENGL_ERR;
+}
+
 void wima_window_refresh(WimaWindow wwh)
 {
 	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
@@ -708,9 +861,26 @@ void wima_window_setWorkspace(WimaWindow wwh, WimaWorkspace wwksp)
 
 	wassert(wwksp < dvec_len(win->workspaces), WIMA_ASSERT_WIN_WKSP_INVALID);
 
+	// Windows that are not activated yet
+	// will set up the workspace then.
+	if (win->render.nvg)
+	{
+		WimaStatus status = wima_window_initWorkspace(win, wwh, wwksp);
+
+		if (yerror(status))
+		{
+			wima_error(status);
+			return;
+		}
+	}
+
 	win->wksp = wwksp;
 	WIMA_WIN_AREAS(win) = dvec_get(win->workspaces, wwksp);
 
+	// Props that changed while the tree was not shown could
+	// not mark its regions stale, so generate them all again.
+	win->flags |= WIMA_WIN_LAYOUT;
+
 	wima_window_setDirty(win, true);
 }
 
@@ -736,6 +906,9 @@ void wima_window_pushDialog(WimaWindow wwh, WimaDialog wdlg)
 
 	WIMA_WIN_AREAS(win) = dlg;
 
+	// See wima_window_setWorkspace().
+	win->flags |= WIMA_WIN_LAYOUT;
+
 	wima_window_setDirty(win, true);
 
 	WimaRect rect;
@@ -760,12 +933,15 @@ void wima_window_popDialog(WimaWindow wwh)
 	wassert(win->treeStackLen, WIMA_ASSERT_WIN_NO_WKSP);
 	wassert(win->treeStackLen > 1, WIMA_ASSERT_WIN_NO_DIALOG);
 
-	dtree_free(WIMA_WIN_AREAS(win));
+	wima_area_tree_destroy(WIMA_WIN_AREAS(win));
 
 	// Decrement the index. We only need to do this because
 	// now WIMA_WIN_AREAS will refer to the right one.
 	--(win->treeStackLen);
 
+	// See wima_window_setWorkspace().
+	win->flags |= WIMA_WIN_LAYOUT;
+
 	wima_window_setDirty(win, true);
 
 	WimaRect rect;
@@ -1093,6 +1269,13 @@ static WimaStatus wima_window_drawTooltip(WimaWin* win) yallnonnull;
  */
 static WimaStatus wima_window_processEvent(WimaWin* win, WimaWindow wwh, WimaWidget wdgt, WimaEvent e) yallnonnull;
 
+/**
+ * Returns the name of @a type to put in traces.
+ * @param type	The event type.
+ * @return		The name of the event type.
+ */
+static const char* wima_window_eventName(WimaEventType type) yconst;
+
 /**
  * Processes a mouse button event. This is
  * complicated, so it's in its own function.
@@ -1114,6 +1297,7 @@ static void wima_window_processFileDrop(WimaWindow wwh, DynaVector files) yallno
 /**
  * Joins two areas into one. It handles finding the common
  * ancestor and checking if the areas can be merged.
+ * @param win		The window with the areas.
  * @param ancestor	The area whose split was clicked.
  * @param squash	The area that will disappear.
  * @return			WIMA_STATUS_SUCCESS on success, an error
@@ -1121,7 +1305,7 @@ static void wima_window_processFileDrop(WimaWindow wwh, DynaVector files) yallno
  * @pre				@a ancestor must be valid.
  * @pre				@a squash must be valid.
  */
-static WimaStatus wima_window_joinAreas(WimaAreaNode ancestor, WimaAreaNode squash);
+static WimaStatus wima_window_joinAreas(WimaWin* win, WimaAreaNode ancestor, WimaAreaNode squash);
 
 /**
  * Split an area into two. The same editor is used for both.
@@ -1161,18 +1345,51 @@ void wima_window_destroy(void* ptr)
 
 	if (!win->window) return;
 
-	// This will also delete the images in NanoVG.
-	if (win->render.nvg) nvgDeleteGL3(win->render.nvg);
+	// Framebuffers and vertex arrays are not shared, so
+	// they have to be deleted in the window's own context.
+	GLFWwindow* current = glfwGetCurrentContext();
+	if (current != win->window) glfwMakeContextCurrent(win->window);
 
-	if (win->images) dvec_free(win->images);
+	if (win->fb) nvgluDeleteFramebuffer(win->fb);
 
-	for (uint8_t i = 1; i < win->treeStackLen; ++i) dtree_free(win->treeStack[i]);
+	// Area caches have to be freed while NanoVG is still alive.
+	if (win->render.nvg)
+	{
+		size_t len = win->workspaces ? dvec_len(win->workspaces) : 0;
+
+		for (size_t i = 0; i < len; ++i)
+		{
+			if (!WIMA_WIN_WKSP_INIT(win, i)) continue;
+			wima_area_updateCaches(&win->render, dvec_get(win->workspaces, i), win->pixelRatio, false, false);
+		}
+
+		for (uint8_t i = 1; i < win->treeStackLen; ++i)
+			wima_area_updateCaches(&win->render, win->treeStack[i], win->pixelRatio, false, false);
+	}
+
+	// This will also delete the images in NanoVG,
+	// except for shared ones, which are deleted
+	// by the last context that goes away.
+	if (win->render.nvg)
+	{
+		wima_render_share_release(&win->render);
+		nvgDeleteGL3(win->render.nvg);
+	}
+
+	// The window's context is going away.
+	glfwMakeContextCurrent(current != win->window ? current : NULL);
+
+	if (win->render.images) dvec_free(win->render.images);
+
+	wima_event_free(&win->events);
+
+	for (uint8_t i = 1; i < win->treeStackLen; ++i) wima_area_tree_destroy(win->treeStack[i]);
 
 	if (win->rootLayouts) dvec_free(win->rootLayouts);
 	if (win->workspaceSizes) dvec_free(win->workspaceSizes);
 	if (win->workspaces) dvec_free(win->workspaces);
 	if (win->overlayPool) dpool_free(win->overlayPool);
-	if (win->overlayItems) dvec_free(win->overlayItems);
+	if (win->overlayItems) wima_item_store_free(win->overlayItems);
 	if (win->overlayStack) dvec_free(win->overlayStack);
 
 	glfwDestroyWindow(win->window);
@@ -1180,32 +1397,88 @@ void wima_window_destroy(void* ptr)
 	if (win->name) dstr_free(win->name);
 }
 
-WimaStatus wima_window_addImage(WimaWin* win, const char* path, WimaImageFlags flags)
+void wima_window_setDirty(WimaWin* win, bool layout)
+{
+	wima_assert_init;
+	wassert(win, WIMA_ASSERT_WIN);
+
+	win->flags |= WIMA_WIN_DIRTY;
+
+	if (layout) win->flags |= WIMA_WIN_LAYOUT_FORCE;
+}
+
+void wima_window_damage(WimaWin* win, WimaRect rect)
 {
-	int id = nvgCreateImage(win->render.nvg, path, flags);
-	return dvec_push(win->images, &id) ? WIMA_STATUS_MALLOC_ERR : WIMA_STATUS_SUCCESS;
+	wima_assert_init;
+	wassert(win, WIMA_ASSERT_WIN);
+
+	win->damage = wima_rect_union(win->damage, rect);
 }
 
-void wima_window_removeImage(WimaWin* win)
+void wima_window_damageArea(WimaWin* win, WimaAreaNode node, bool layout)
 {
-	size_t len = dvec_len(win->images);
+	wima_assert_init;
+	wassert(win, WIMA_ASSERT_WIN);
+
+	WimaArTree* areas = WIMA_WIN_AREAS(win);
+
+	wassert(wima_area_tree_exists(areas, node), WIMA_ASSERT_AREA);
 
-	wassert(len, WIMA_ASSERT_IMG);
+	WimaAr* area = wima_area_tree_node(areas, node);
 
-	int id = *((int*) dvec_get(win->images, len));
+	area->damaged = true;
+	wima_window_damage(win, area->rect);
 
-	dvec_pop(win->images);
-	nvgDeleteImage(win->render.nvg, id);
+	if (layout) win->flags |= WIMA_WIN_LAYOUT_FORCE;
 }
 
-void wima_window_setDirty(WimaWin* win, bool layout)
+void wima_window_damageWidget(WimaWin* win, WimaWidget wdgt)
 {
 	wima_assert_init;
 	wassert(win, WIMA_ASSERT_WIN);
 
-	win->flags |= WIMA_WIN_DIRTY;
+	if (wdgt.widget == WIMA_WIDGET_INVALID) return;
 
-	if (layout) win->flags |= WIMA_WIN_LAYOUT_FORCE;
+	if (wdgt.region != WIMA_REGION_INVALID_IDX)
+	{
+		wima_window_damageArea(win, wdgt.area, false);
+	}
+	else if (wdgt.area == WIMA_AREA_INVALID)
+	{
+		WimaRect rect;
+
+		rect.x = rect.y = 0;
+		rect.w = win->winsize.w;
+		rect.h = win->headerMinSize.h;
+
+		wima_window_damage(win, rect);
+	}
+	else
+	{
+		// Overlays are always drawn completely.
+		wima_window_setDirty(win, false);
+	}
+}
+
+void wima_window_clearRect(WimaWin* win, WimaRect rect)
+{
+	wima_assert_init;
+	wassert(win, WIMA_ASSERT_WIN);
+
+	// GL's origin is the bottom left, and the
+	// scissor is in pixels, not window units.
+	float ratio = win->pixelRatio;
+
+	int x = (int) floorf(rect.x * ratio);
+	int w = (int) ceilf((rect.x + rect.w) * ratio) - x;
+	int h = (int) ceilf((rect.y + rect.h) * ratio);
+	int y = win->fbsize.h - h;
+	h -= (int) floorf(rect.y * ratio);
+
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(x, y, w, h);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
 }
 
 void wima_window_setModifier(WimaWin* win, WimaKey key, WimaAction action)
@@ -1314,6 +1587,65 @@ void wima_window_removeMenu(WimaWin* win, WimaProperty menu)
 	}
 }
 
+WimaStatus wima_window_initWorkspace(WimaWin* win, WimaWindow wwh, WimaWorkspace wwksp)
+{
+	wassert(win, WIMA_ASSERT_WIN);
+
+	if (WIMA_WIN_WKSP_CURRENT(win, wwksp)) return WIMA_STATUS_SUCCESS;
+
+	uint64_t span = wima_trace_begin();
+
+	WimaArTree* areas = dvec_get(win->workspaces, wwksp);
+
+	// An old copy may still have area caches. Framebuffers
+	// are not shared, and callers may not have the window's
+	// context current, so they are freed in that context.
+	if (WIMA_WIN_WKSP_INIT(win, wwksp))
+	{
+		GLFWwindow* current = glfwGetCurrentContext();
+		if (current != win->window) glfwMakeContextCurrent(win->window);
+
+		wima_area_updateCaches(&win->render, areas, win->pixelRatio, false, false);
+		win->workspaceVersions[wwksp] = 0;
+
+		if (current != win->window) glfwMakeContextCurrent(current);
+	}
+
+	wima_area_tree_destroy(areas);
+
+	if (yerror(wima_area_tree_copy(areas, dvec_get(wg.workspaces, wwksp)))) return WIMA_STATUS_MALLOC_ERR;
+
+	WimaRect rect;
+
+	rect.x = 0;
+	rect.y = win->headerMinSize.h;
+	rect.w = win->fbsize.w;
+	rect.h = win->fbsize.h - win->headerMinSize.h;
+
+	WimaSizef* min = dvec_get(win->workspaceSizes, wwksp);
+
+#ifdef __YASSERT__
+	uint8_t stage = win->ctx.stage;
+	win->ctx.stage = WIMA_UI_STAGE_LAYOUT;
+#endif
+
+	WimaStatus status = wima_area_init(wwh, areas, rect, min);
+
+#ifdef __YASSERT__
+	win->ctx.stage = stage;
+#endif
+
+	if (yerror(status)) return status;
+
+	wima_window_setMinSize(win, min);
+
+	win->workspaceVersions[wwksp] = wg.workspaceVersions[wwksp];
+
+	wima_trace_end(span, "workspace: init", wwksp);
+
+	return WIMA_STATUS_SUCCESS;
+}
+
 WimaStatus wima_window_draw(WimaWindow wwh)
 {
 	WimaStatus status;
@@ -1328,19 +1660,30 @@ WimaStatus wima_window_draw(WimaWindow wwh)
 
 	win->ctx.stage = WIMA_UI_STAGE_LAYOUT;
 
-	win->flags |= !win->ctx.eventCount * WIMA_WIN_TOOLTIP;
-	win->ctx.eventCount = 0;
-
 	bool header = wg.funcs.win_header != 0 && WIMA_WIN_HAS_HEADER(win) != 0;
+	bool damaged = !wima_rect_empty(win->damage);
+
+	// This is true when area layouts could have changed in
+	// unknown ways, which means that caches are invalid.
+	bool relayout = false;
+
+	uint64_t start;
 
 	if (WIMA_WIN_NEEDS_LAYOUT(win))
 	{
-		if (yerror(dvec_setLength(win->rootLayouts, 0) || dvec_setLength(win->overlayItems, 0)))
+		start = wima_time_raw();
+
+		if (yerror(dvec_setLength(win->rootLayouts, 0) || wima_item_setLength(win->overlayItems, 0)))
 			return WIMA_STATUS_MALLOC_ERR;
 
 		WimaSizef* min = dvec_get(win->workspaceSizes, win->wksp);
 
-		status = wima_area_layout(WIMA_WIN_AREAS(win), min);
+		// Only a layout that the user asked for generates
+		// every region again. Otherwise, regions are kept
+		// unless they are stale.
+		bool regen = (win->flags & WIMA_WIN_LAYOUT) != 0;
+
+		status = wima_area_layout(WIMA_WIN_AREAS(win), min, regen);
 		if (yerror(status)) return status;
 
 		if (header)
@@ -1353,26 +1696,65 @@ WimaStatus wima_window_draw(WimaWindow wwh)
 
 		// TODO: Lay out overlays.
 
-		win->flags |= WIMA_WIN_DIRTY;
+		// If nobody said what changed, we
+		// have to assume that everything did.
+		if (!damaged) win->flags |= WIMA_WIN_DIRTY;
+
+		relayout = WIMA_WIN_IS_DIRTY(win) != 0;
+
+		wima_time_frame_add(&win->times, WIMA_FRAME_PHASE_LAYOUT, start);
 	}
 
-	if (WIMA_WIN_IS_DIRTY(win))
+	status = wima_window_checkFramebuffer(win);
+	if (yerror(status)) return status;
+
+	// Anything that is drawn on top of the areas could
+	// be covering any of them, so we can't redraw only
+	// the damaged parts when one of those is up.
+	bool full = WIMA_WIN_IS_DIRTY(win) || WIMA_WIN_HAS_OVERLAY(win) || WIMA_WIN_IN_SPLIT_MODE(win) ||
+	            WIMA_WIN_IN_JOIN_MODE(win) || (WIMA_WIN_HAS_TOOLTIP(win) && win->ctx.hover.widget != WIMA_WIDGET_INVALID);
+
+	if (WIMA_WIN_IS_DIRTY(win) || damaged)
 	{
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		start = wima_time_raw();
+
+		win->render.pixelRatio = win->pixelRatio;
+
+		// Cached drawings have placeholders for these.
+		if (wima_image_context_upload(&win->render)) relayout = true;
+
+		status = wima_area_updateCaches(&win->render, WIMA_WIN_AREAS(win), win->pixelRatio, win->areaCache, relayout);
+		if (yerror(status)) return status;
+
+		nvgluBindFramebuffer(win->fb);
+		glViewport(0, 0, win->fbsize.w, win->fbsize.h);
+
+		if (full) glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
 		nvgBeginFrame(win->render.nvg, win->winsize.w, win->winsize.h, win->pixelRatio);
 
-		if (header)
+		WimaRect headerRect;
+		headerRect.x = headerRect.y = 0;
+		headerRect.w = win->winsize.w;
+		headerRect.h = win->headerMinSize.h;
+
+		if (header && (full || wima_rect_intersects(win->damage, headerRect)))
 		{
 			WimaLayout* root = dvec_get(win->rootLayouts, 0);
 
 			wassert(root, WIMA_ASSERT_LAYOUT);
 
-			status = wima_layout_draw(wima_layout_ptr(*root), &win->render);
-			if (yerror(status)) return status;
+			if (!full) wima_window_clearRect(win, headerRect);
+
+			status = wima_layout_draw(*root, &win->render);
+			if (yerror(status)) goto err;
 		}
 
-		status = wima_area_draw(&win->render, WIMA_WIN_AREAS(win));
+		if (full)
+			status = wima_area_draw(&win->render, WIMA_WIN_AREAS(win));
+		else
+			status = wima_area_drawDamaged(&win->render, WIMA_WIN_AREAS(win));
+
 		if (yerror(status)) goto err;
 
 		if (WIMA_WIN_HAS_OVERLAY(win))
@@ -1399,10 +1781,37 @@ WimaStatus wima_window_draw(WimaWindow wwh)
 			if (yerror(status)) goto err;
 		}
 
+		wima_time_frame_add(&win->times, WIMA_FRAME_PHASE_DRAW, start);
+		start = wima_time_raw();
+
+		wima_icon_atlas_upload(&win->render);
+
 		nvgEndFrame(win->render.nvg);
-		glfwSwapBuffers(win->window);
+
+		// Headless windows are only ever read back from
+		// their framebuffer, so there is nothing to show.
+		if (!wg.headless)
+		{
+			// The back buffer is undefined after a swap,
+			// so the whole framebuffer is always copied.
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, win->fb->fbo);
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+			glBlitFramebuffer(0, 0, win->fbsize.w, win->fbsize.h, 0, 0, win->fbsize.w, win->fbsize.h,
+			                  GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		wima_time_frame_add(&win->times, WIMA_FRAME_PHASE_END, start);
+		start = wima_time_raw();
+
+		if (!wg.headless) glfwSwapBuffers(win->window);
+
+		wima_time_frame_add(&win->times, WIMA_FRAME_PHASE_SWAP, start);
+		wima_time_frame_commit(&win->times);
 	}
 
+	win->damage.x = win->damage.y = win->damage.w = win->damage.h = 0;
 	win->flags &= ~(WIMA_WIN_DIRTY | WIMA_WIN_LAYOUT | WIMA_WIN_LAYOUT_FORCE);
 	win->ctx.stage = WIMA_UI_STAGE_POST_LAYOUT;
 
@@ -1411,6 +1820,7 @@ WimaStatus wima_window_draw(WimaWindow wwh)
 err:
 
 	nvgCancelFrame(win->render.nvg);
+	nvgluBindFramebuffer(NULL);
 
 	return status;
 }
@@ -1425,21 +1835,210 @@ WimaStatus wima_window_processEvents(WimaWindow wwh)
 
 	win->ctx.stage = WIMA_UI_STAGE_PROCESS;
 
-	WimaEvent* events = win->ctx.events;
-	WimaWidget* handles = win->ctx.eventItems;
-	int numEvents = win->ctx.eventCount;
+	uint64_t start = wima_time_raw();
 
 	win->ctx.cursorPos = win->ctx.last_cursor;
 
 	WimaStatus status = WIMA_STATUS_SUCCESS;
 
-	for (int i = 0; !status && i < numEvents; ++i) status = wima_window_processEvent(win, wwh, handles[i], events[i]);
+	WimaEvent event;
+	WimaWidget wdgt;
+
+	// Handlers can add events or clear the queue,
+	// so pop one at a time instead of iterating.
+	while (!status && wima_event_pop(&win->events, &event, &wdgt))
+	{
+		++(win->ctx.eventCount);
+
+		uint64_t span = wima_trace_begin();
+
+		status = wima_window_processEvent(win, wwh, wdgt, event);
+
+		wima_trace_end(span, wima_window_eventName(event.type), wwh);
+
+		// The window vector could have moved.
+		win = dvec_get(wg.windows, wwh);
+	}
 
 	win->ctx.last_cursor = win->ctx.cursorPos;
 
+	double now = wima_time();
+
+	if (win->ctx.eventCount)
+	{
+		win->lastEvent = now;
+		win->ctx.eventCount = 0;
+	}
+
+	// The tooltip is decided here, not when drawing, so that
+	// the window is known to need drawing before it is drawn.
+	bool tooltip = win->ctx.hover.widget != WIMA_WIDGET_INVALID && now - win->lastEvent >= WIMA_WIN_TOOLTIP_DELAY;
+
+	if (tooltip != (WIMA_WIN_HAS_TOOLTIP(win) != 0))
+	{
+		win->flags ^= WIMA_WIN_TOOLTIP;
+		wima_window_setDirty(win, false);
+	}
+
+	wima_time_frame_add(&win->times, WIMA_FRAME_PHASE_EVENTS, start);
+
 	return status;
 }
 
+void wima_window_drawAll()
+{
+	wima_assert_init;
+
+	WimaWindow order[WIMA_WINDOW_MAX];
+	uint8_t count = 0;
+	uint8_t last = 0;
+
+	GLFWwindow* current = glfwGetCurrentContext();
+	size_t len = dvec_len(wg.windows);
+
+	// Put the window with the current context first so
+	// that, if it renders, it doesn't need a switch.
+	for (WimaWindow i = 0; i < len; ++i)
+	{
+		if (!wima_window_valid(i)) continue;
+
+		WimaWin* win = dvec_get(wg.windows, i);
+
+		if (win->window == current && count)
+		{
+			order[count] = order[0];
+			order[0] = i;
+		}
+		else
+		{
+			order[count] = i;
+		}
+
+		++count;
+	}
+
+	// Find the last window that will render.
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		WimaWin* win = dvec_get(wg.windows, order[i]);
+		if (wima_window_needsDraw(win)) last = i;
+	}
+
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		WimaWin* win = dvec_get(wg.windows, order[i]);
+
+		if (wima_window_needsDraw(win))
+		{
+			if (win->window != glfwGetCurrentContext()) glfwMakeContextCurrent(win->window);
+
+			// Only the last swap in a frame waits for the
+			// vertical blank. Otherwise, every window would
+			// wait for its own, one after the other.
+			int interval = i == last && !wg.headless;
+
+			if (win->swapInterval != interval)
+			{
+				glfwSwapInterval(interval);
+				win->swapInterval = interval;
+			}
+		}
+
+		// Windows that don't render still need to go through
+		// this to update their state, but they don't touch GL.
+		WimaStatus status = wima_window_draw(order[i]);
+		if (yerror(status)) wima_error_desc(status, "Wima encountered an error while rendering.");
+	}
+}
+
+double wima_window_deadline()
+{
+	wima_assert_init;
+
+	double deadline = -1.0;
+
+	uint8_t len = dvec_len(wg.windows);
+
+	for (WimaWindow i = 0; i < len; ++i)
+	{
+		if (!wima_window_valid(i)) continue;
+
+		WimaWin* win = dvec_get(wg.windows, i);
+
+		// Only a tooltip that is not up yet is pending.
+		if (win->ctx.hover.widget == WIMA_WIDGET_INVALID || WIMA_WIN_HAS_TOOLTIP(win)) continue;
+
+		double due = win->lastEvent + WIMA_WIN_TOOLTIP_DELAY;
+
+		if (deadline < 0.0 || due < deadline) deadline = due;
+	}
+
+	return deadline;
+}
+
+void wima_window_processAll()
+{
+	wima_assert_init;
+
+	// Handlers can create windows, so the length is
+	// checked every time. New windows are skipped
+	// because they are not drawn yet.
+	for (WimaWindow i = 0; i < dvec_len(wg.windows); ++i)
+	{
+		if (!wima_window_valid(i)) continue;
+
+		WimaWin* win = dvec_get(wg.windows, i);
+
+		if (win->ctx.stage == WIMA_UI_STAGE_PROCESS) continue;
+
+		// Handlers may use the window's NanoVG context.
+		if (win->events.count && win->window != glfwGetCurrentContext()) glfwMakeContextCurrent(win->window);
+
+		wima_window_processEvents(i);
+	}
+}
+
+uint8_t wima_window_closeAll()
+{
+	wima_assert_init;
+
+	uint8_t count = 0;
+
+	for (WimaWindow i = 0; i < dvec_len(wg.windows); ++i)
+	{
+		if (!wima_window_valid(i)) continue;
+
+		WimaWin* win = dvec_get(wg.windows, i);
+
+		if (glfwWindowShouldClose(win->window))
+			wima_window_remove(i);
+		else
+			++count;
+	}
+
+	return count;
+}
+
+void wima_window_remove(WimaWindow wwh)
+{
+	wima_assert_init;
+
+	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
+
+	WimaWin* wwin = dvec_get(wg.windows, wwh);
+	wima_window_destroy(wwin);
+
+	// Either pop the window from the end,
+	// or set it all as NULL (so we know
+	// we can reuse it later. We do this
+	// instead of popping because we want
+	// all window handles to remain valid.
+	if (wwh == dvec_len(wg.windows) - 1)
+		dvec_pop(wg.windows);
+	else
+		memset(wwin, 0, sizeof(WimaWin));
+}
+
 bool wima_window_joinAreasMode(WimaWidget wdgt, WimaMouseClickEvent event yunused)
 {
 	wassert(wima_window_valid(wdgt.window), WIMA_ASSERT_WIN);
@@ -1476,9 +2075,9 @@ static WimaStatus wima_window_layoutHeader(WimaWin* win, WimaWindow wwh, WimaSiz
 	// TODO: Add the custom props for the workspace switcher.
 	// TODO: Add code to layout workspace switcher.
 
-	WimaItem* item = wima_layout_ptr(root);
+	wima_item_finish(win->overlayItems, root.layout);
 
-	WimaSizef headermin = wima_layout_size(item);
+	WimaSizef headermin = wima_layout_size(root);
 
 	min->w = min->w > headermin.w ? min->w : headermin.w;
 	min->h += headermin.h;
@@ -1486,7 +2085,7 @@ static WimaStatus wima_window_layoutHeader(WimaWin* win, WimaWindow wwh, WimaSiz
 	win->headerMinSize.w = (uint16_t) ceilf(headermin.w);
 	win->headerMinSize.h = (uint16_t) ceilf(headermin.h);
 
-	return wima_layout_layout(item);
+	return wima_layout_layout(root);
 }
 
 static WimaStatus wima_window_overlay_draw(WimaWin* win, WimaWindow wwh, size_t idx, float parentWidth)
@@ -1513,13 +2112,13 @@ static WimaStatus wima_window_overlay_draw(WimaWin* win, WimaWindow wwh, size_t
 	WimaStatus status = ovly->layout(wovly->ovly, idx, root);
 	if (yerror(status)) return status;
 
-	WimaItem* item = wima_item_ptr(root.window, root.area, root.region, root.layout);
+	wima_item_finish(win->overlayItems, root.layout);
 
-	WimaSizef size = wima_layout_size(item);
+	WimaSizef size = wima_layout_size(root);
 	wovly->rect.w = size.w;
 	wovly->rect.h = size.h;
 
-	status = wima_layout_layout(item);
+	status = wima_layout_layout(root);
 
 	nvgResetTransform(win->render.nvg);
 	nvgResetScissor(win->render.nvg);
@@ -1528,7 +2127,7 @@ static WimaStatus wima_window_overlay_draw(WimaWin* win, WimaWindow wwh, size_t
 
 	wima_ui_menu_background(&win->render, 0, 0, wovly->rect.w, wovly->rect.h, WIMA_CORNER_NONE);
 
-	status = wima_layout_draw(item, &win->render);
+	status = wima_layout_draw(root, &win->render);
 	if (yerror(status)) return status;
 
 	if (idx < dvec_len(win->overlayStack) - 1) status = wima_window_overlay_draw(win, wwh, idx + 1, wovly->rect.w);
@@ -1587,6 +2186,102 @@ static WimaStatus wima_window_drawTooltip(WimaWin* win)
 	return WIMA_STATUS_SUCCESS;
 }
 
+static const char* wima_window_eventName(WimaEventType type)
+{
+	switch (type)
+	{
+		case WIMA_EVENT_NONE:
+		{
+			return "event: none";
+		}
+
+		case WIMA_EVENT_KEY:
+		{
+			return "event: key";
+		}
+
+		case WIMA_EVENT_MOUSE_BTN:
+		{
+			return "event: mouse button";
+		}
+
+		case WIMA_EVENT_MOUSE_CLICK:
+		{
+			return "event: mouse click";
+		}
+
+		case WIMA_EVENT_MOUSE_POS:
+		{
+			return "event: mouse position";
+		}
+
+		case WIMA_EVENT_MOUSE_DRAG:
+		{
+			return "event: mouse drag";
+		}
+
+		case WIMA_EVENT_SCROLL:
+		{
+			return "event: scroll";
+		}
+
+		case WIMA_EVENT_CHAR:
+		{
+			return "event: char";
+		}
+
+		case WIMA_EVENT_AREA_ENTER:
+		{
+			return "event: area enter";
+		}
+
+		case WIMA_EVENT_FILE_DROP:
+		{
+			return "event: file drop";
+		}
+
+		case WIMA_EVENT_WIN_POS:
+		{
+			return "event: window position";
+		}
+
+		case WIMA_EVENT_FB_SIZE:
+		{
+			return "event: framebuffer size";
+		}
+
+		case WIMA_EVENT_WIN_SIZE:
+		{
+			return "event: window size";
+		}
+
+		case WIMA_EVENT_WIN_ENTER:
+		{
+			return "event: window enter";
+		}
+
+		case WIMA_EVENT_WIN_MINIMIZE:
+		{
+			return "event: window minimize";
+		}
+
+		case WIMA_EVENT_WIN_FOCUS:
+		{
+			return "event: window focus";
+		}
+
+		case WIMA_EVENT_USER:
+		{
+			return "event: user";
+		}
+
+		default:
+		{
+			return "event: unknown";
+		}
+	}
+}
+
 static WimaStatus wima_window_processEvent(WimaWin* win, WimaWindow wwh, WimaWidget wdgt, WimaEvent e)
 {
 	switch (e.type)
@@ -1602,11 +2297,19 @@ static WimaStatus wima_window_processEvent(WimaWin* win, WimaWindow wwh, WimaWid
 
 			if (e.area_key.area != WIMA_AREA_INVALID)
 			{
-				WimaAr* area = dtree_node(WIMA_WIN_AREAS(win), e.area_key.area);
+				WimaAr* area = wima_area_tree_node(WIMA_WIN_AREAS(win), e.area_key.area);
 				consumed = wima_area_key(area, e.area_key.key);
 			}
 
-			if (!consumed && wdgt.widget != WIMA_WIDGET_INVALID) wima_widget_key(wdgt, e.area_key.key);
+			if (!consumed && wdgt.widget != WIMA_WIDGET_INVALID)
+			{
+				wima_widget_key(wdgt, e.area_key.key);
+				wima_window_damageWidget(win, wdgt);
+			}
+			else if (consumed)
+			{
+				wima_window_damageArea(win, e.area_key.area, false);
+			}
 
 			break;
 		}
@@ -1618,14 +2321,22 @@ static WimaStatus wima_window_processEvent(WimaWin* win, WimaWindow wwh, WimaWid
 
 		case WIMA_EVENT_MOUSE_CLICK:
 		{
-			if (wdgt.widget != WIMA_WIDGET_INVALID) wima_widget_mouseClick(wdgt, e.click);
+			if (wdgt.widget != WIMA_WIDGET_INVALID)
+			{
+				wima_widget_mouseClick(wdgt, e.click);
+				wima_window_damageWidget(win, wdgt);
+			}
 			break;
 		}
 
 		case WIMA_EVENT_MOUSE_POS:
 		{
 			win->ctx.cursorPos = e.pos;
-			if (wdgt.widget != WIMA_WIDGET_INVALID) wima_widget_mousePos(wdgt, e.pos);
+			if (wdgt.widget != WIMA_WIDGET_INVALID)
+			{
+				wima_widget_mousePos(wdgt, e.pos);
+				wima_window_damageWidget(win, wdgt);
+			}
 			break;
 		}
 
@@ -1636,7 +2347,10 @@ static WimaStatus wima_window_processEvent(WimaWin* win, WimaWindow wwh, WimaWid
 				if (win->ctx.movingSplit)
 					wima_area_moveSplit(WIMA_WIN_AREAS(win), win->ctx.split.area, win->ctx.split, e.drag.pos);
 				else if (wdgt.widget != WIMA_WIDGET_INVALID)
+				{
 					wima_widget_mouseDrag(wdgt, e.drag);
+					wima_window_damageWidget(win, wdgt);
+				}
 			}
 
 			break;
@@ -1644,20 +2358,43 @@ static WimaStatus wima_window_processEvent(WimaWin* win, WimaWindow wwh, WimaWid
 
 		case WIMA_EVENT_AREA_ENTER:
 		{
-			WimaAr* area = dtree_node(WIMA_WIN_AREAS(win), e.area_enter.area);
+			WimaAr* area = wima_area_tree_node(WIMA_WIN_AREAS(win), e.area_enter.area);
 			wima_area_mouseEnter(area, e.area_enter.enter);
+			wima_window_damageArea(win, e.area_enter.area, false);
 			break;
 		}
 
 		case WIMA_EVENT_SCROLL:
 		{
-			if (wdgt.widget != WIMA_WIDGET_INVALID) wima_widget_scroll(wdgt, e.scroll);
+			if (wdgt.widget != WIMA_WIDGET_INVALID)
+			{
+				wima_widget_scroll(wdgt, e.scroll);
+				wima_window_damageWidget(win, wdgt);
+			}
+			else if (!WIMA_WIN_HAS_OVERLAY(win))
+			{
+				// Widgets that take scroll events come first,
+				// and everything else scrolls the list it is in.
+				WimaArTree* areas = WIMA_WIN_AREAS(win);
+				WimaAreaNode node = wima_area_mouseOver(areas, win->ctx.cursorPos);
+
+				if (node != WIMA_AREA_INVALID)
+				{
+					WimaAr* area = wima_area_tree_node(areas, node);
+
+					if (wima_area_scroll(area, win->ctx.cursorPos, e.scroll)) wima_window_damageArea(win, node, true);
+				}
+			}
 			break;
 		}
 
 		case WIMA_EVENT_CHAR:
 		{
-			if (wdgt.widget != WIMA_WIDGET_INVALID) wima_widget_char(wdgt, e.char_event);
+			if (wdgt.widget != WIMA_WIDGET_INVALID)
+			{
+				wima_widget_char(wdgt, e.char_event);
+				wima_window_damageWidget(win, wdgt);
+			}
 			break;
 		}
 
@@ -1702,6 +2439,12 @@ static WimaStatus wima_window_processEvent(WimaWin* win, WimaWindow wwh, WimaWid
 			wg.funcs.focus(wwh, e.focused);
 			break;
 		}
+
+		case WIMA_EVENT_USER:
+		{
+			if (wg.funcs.user) wg.funcs.user(wwh, e.user);
+			break;
+		}
 	}
 
 	return WIMA_STATUS_SUCCESS;
@@ -1712,7 +2455,7 @@ static WimaStatus wima_window_processMouseBtnEvent(WimaWin* win, WimaWidget wdgt
 	if (WIMA_WIN_IN_SPLIT_MODE(win))
 		return wima_window_splitArea(win, win->ctx.hover.area);
 	else if (WIMA_WIN_IN_JOIN_MODE(win))
-		return wima_window_joinAreas(win->ctx.split.area, win->ctx.hover.area);
+		return wima_window_joinAreas(win, win->ctx.split.area, win->ctx.hover.area);
 	// TODO: Write this.
 	else if (WIMA_WIN_HAS_OVERLAY(win))
 		return WIMA_STATUS_SUCCESS;
@@ -1720,7 +2463,10 @@ static WimaStatus wima_window_processMouseBtnEvent(WimaWin* win, WimaWidget wdgt
 	if (win->ctx.split.split >= 0 && e.action == WIMA_ACTION_RELEASE)
 		win->ctx.split.split = win->ctx.dragStart.x = -1;
 	else if (wdgt.widget != WIMA_WIDGET_INVALID)
+	{
 		wima_widget_mouseBtn(wdgt, e);
+		wima_window_damageWidget(win, wdgt);
+	}
 
 	return WIMA_STATUS_SUCCESS;
 }
@@ -1743,14 +2489,16 @@ static void wima_window_processFileDrop(WimaWindow wwh, DynaVector files)
 	dvec_free(files);
 }
 
-WimaStatus wima_window_joinAreas(WimaAreaNode ancestor, WimaAreaNode squash)
+WimaStatus wima_window_joinAreas(WimaWin* win, WimaAreaNode ancestor, WimaAreaNode squash)
 {
 	// TODO: Write this function.
 
-	DynaNode anc = ancestor;
-	DynaNode sq = squash;
+	WimaArTree* areas = WIMA_WIN_AREAS(win);
+
+	WimaAreaNode anc = ancestor;
+	WimaAreaNode sq = squash;
 
-	while (sq != anc && sq != DTREE_NO_PARENT) sq = dtree_parent(sq);
+	while (sq != anc && sq != WIMA_AREA_INVALID) sq = wima_area_tree_parent(areas, sq);
 
 	wassert(sq == anc, WIMA_ASSERT_AREA_NOT_ANCESTOR);
 
@@ -1759,15 +2507,13 @@ WimaStatus wima_window_joinAreas(WimaAreaNode ancestor, WimaAreaNode squash)
 
 WimaStatus wima_window_splitArea(WimaWin* win, WimaAreaNode node)
 {
-	DynaTree areas = WIMA_WIN_AREAS(win);
+	WimaArTree* areas = WIMA_WIN_AREAS(win);
 
-	DynaNode parent = node;
-	DynaNode left = dtree_left(parent);
-	DynaNode right = dtree_right(parent);
+	WimaAreaNode parent = node;
 
 	WimaAr larea, rarea;
 
-	WimaAr* parea = dtree_node(areas, parent);
+	WimaAr* parea = wima_area_tree_node(areas, parent);
 
 	wassert(WIMA_AREA_IS_LEAF(parea), WIMA_ASSERT_AREA_LEAF);
 
@@ -1811,8 +2557,6 @@ WimaStatus wima_window_splitArea(WimaWin* win, WimaAreaNode node)
 	}
 
 	larea.isParent = rarea.isParent = false;
-	larea.node = left;
-	rarea.node = right;
 
 	WimaStatus status = wima_area_setup(&larea, true);
 	if (yerror(status)) return status;
@@ -1822,14 +2566,15 @@ WimaStatus wima_window_splitArea(WimaWin* win, WimaAreaNode node)
 
 	status = WIMA_STATUS_MALLOC_ERR;
 
-	DynaStatus dstatus = dtree_add(areas, left, &larea);
-	if (yerror(dstatus)) goto left_push_err;
+	// This sets the nodes of the areas.
+	WimaAreaNode left = wima_area_tree_add(areas, parent, true, &larea);
+	if (yerror(left == WIMA_AREA_INVALID)) goto left_push_err;
 
-	dstatus = dtree_add(areas, right, &rarea);
-	if (yerror(dstatus))
+	WimaAreaNode right = wima_area_tree_add(areas, parent, false, &rarea);
+	if (yerror(right == WIMA_AREA_INVALID))
 	{
 		wima_area_destroy(&rarea);
-		dtree_remove(areas, left);
+		wima_area_tree_remove(areas, left);
 		return status;
 	}
 
@@ -1865,6 +2610,32 @@ static void wima_window_clearContext(WimaWinCtx* ctx)
 	memset(&ctx->hover, -1, sizeof(WimaWidget));
 }
 
+static bool wima_window_needsDraw(WimaWin* win)
+{
+	return WIMA_WIN_IS_DIRTY(win) || WIMA_WIN_NEEDS_LAYOUT(win) || !wima_rect_empty(win->damage);
+}
+
+static WimaStatus wima_window_checkFramebuffer(WimaWin* win)
+{
+	wassert(win, WIMA_ASSERT_WIN);
+	wassert(win->fb, WIMA_ASSERT_WIN_RENDER_CONTEXT);
+
+	int w, h;
+
+	nvgImageSize(win->render.nvg, win->fb->image, &w, &h);
+
+	if (ylikely(w == win->fbsize.w && h == win->fbsize.h)) return WIMA_STATUS_SUCCESS;
+
+	nvgluDeleteFramebuffer(win->fb);
+
+	win->fb = nvgluCreateFramebuffer(win->render.nvg, win->fbsize.w, win->fbsize.h, 0);
+	if (yerror(!win->fb)) return WIMA_STATUS_OPENGL_ERR;
+
+	win->flags |= WIMA_WIN_DIRTY;
+
+	return WIMA_STATUS_SUCCESS;
+}
+
 static void wima_window_setMinSize(WimaWin* win, WimaSizef* size)
 {
 	wassert(win, WIMA_ASSERT_WIN);
@@ -52,6 +52,7 @@ extern "C" {
 #include "workspace.h"
 
 #include "../render/render.h"
+#include "../time/time.h"
 
 #include <GLFW/glfw3.h>
 #include <dyna/pool.h>
@@ -156,6 +157,14 @@ extern "C" {
  */
 #define WIMA_WIN_HAS_TOOLTIP(win) (((win)->flags) & WIMA_WIN_TOOLTIP)
 
+/**
+ * @def WIMA_WIN_TOOLTIP_DELAY
+ * How long, in seconds, a window must go without
+ * events before the tooltip for the hover widget
+ * is shown.
+ */
+#define WIMA_WIN_TOOLTIP_DELAY (0.75)
+
 /**
  * @def WIMA_WIN_SPLIT_MODE
  * A bit indicating whether the window
@@ -252,8 +261,9 @@ typedef struct WimaWinCtx
 	/// The current layout stage.
 	uint8_t stage;
 
-	/// The number of events in the queue.
-	uint8_t eventCount;
+	/// The number of events processed since the
+	/// last frame. This is for showing tooltips.
+	uint32_t eventCount;
 
 	/// The current number of clicks.
 	/// This is for generating click events.
@@ -277,14 +287,6 @@ typedef struct WimaWinCtx
 	/// The split that the user is manipulating.
 	WimaAreaSplit split;
 
-	/// The event queue. The data in this struct, and in WimaWin,
-	/// has been carefully packed to ensure that this starts on a
-	/// cache line. Keep it that way.
-	WimaEvent events[WIMA_EVENT_MAX];
-
-	/// The widgets associated with the events.
-	WimaWidget eventItems[WIMA_EVENT_MAX];
-
 } WimaWinCtx;
 
 /**
@@ -298,6 +300,30 @@ typedef struct WimaWin
 	/// The render context for the window.
 	WimaRenderContext render;
 
+	/// The framebuffer that the window is drawn into.
+	/// It keeps the last frame around so that only the
+	/// damaged parts have to be redrawn. It is copied
+	/// to the window's back buffer before each swap.
+	struct NVGLUframebuffer* fb;
+
+	/// The union of all rectangles damaged since the
+	/// last frame. If this is empty and the window is
+	/// not dirty, there is nothing to draw.
+	WimaRect damage;
+
+	/// Whether leaf areas are drawn into their own
+	/// textures and composited, or drawn directly.
+	bool areaCache;
+
+	/// The swap interval last set on the window's
+	/// context. See @a wima_window_drawAll().
+	int swapInterval;
+
+	/// The time (see @a wima_time()) when the window
+	/// last processed events. Tooltips are shown
+	/// @a WIMA_WIN_TOOLTIP_DELAY seconds after this.
+	double lastEvent;
+
 	/// The window's framebuffer size. Even though
 	/// we can just query GLFW for this, it is used
 	/// often enough that storing it is a good idea
@@ -324,8 +350,8 @@ typedef struct WimaWin
 	/// A stack of overlays.
 	DynaVector overlayStack;
 
-	/// A vector of items for overlays.
-	DynaVector overlayItems;
+	/// The items for the header and overlays.
+	WimaItemStore* overlayItems;
 
 	/// A pool for overlay widgets to allocate from.
 	DynaPool overlayPool;
@@ -355,7 +381,7 @@ typedef struct WimaWin
 	uint8_t treeStackLen;
 
 	/// The area stack.
-	DynaTree treeStack[WIMA_WINDOW_STACK_MAX];
+	WimaArTree* treeStack[WIMA_WINDOW_STACK_MAX];
 
 	/// The window name. This starts as the app name.
 	DynaString name;
@@ -366,9 +392,17 @@ typedef struct WimaWin
 	/// The vector of workspaces (area trees).
 	DynaVector workspaces;
 
-	/// The vector of workspace minimum sizes.
+	/// The vector of workspace minimum sizes. These
+	/// are only valid for workspaces that are set up.
 	DynaVector workspaceSizes;
 
+	/// The version (see @a WimaG's workspaceVersions)
+	/// of each workspace that was copied into this
+	/// window and set up, or 0 if it has not been.
+	/// Workspaces are copied when they are shown and
+	/// the window's copy is older than the global one.
+	uint32_t workspaceVersions[WIMA_WORKSPACE_MAX];
+
 	/// The vector of root layouts. This is used to split
 	/// up size calculation and layout for regions.
 	DynaVector rootLayouts;
@@ -376,8 +410,11 @@ typedef struct WimaWin
 	/// The current cursor.
 	GLFWcursor* cursor;
 
-	/// The list of textures.
-	DynaVector images;
+	/// The event queue.
+	WimaEventQueue events;
+
+	/// How long the phases of recent frames took.
+	WimaFrameTimes times;
 
 	/// The UI context for the window.
 	WimaWinCtx ctx;
@@ -400,34 +437,55 @@ DynaStatus wima_window_copy(void* dest, const void *src) ynoreturn;
 void wima_window_destroy(void* ptr);
 
 /**
- * Adds an image to a window. This allows the NanoVG
- * context on the window to create a texture.
- * @param win	The window to add the image to.
- * @param path	The path to the image file.
- * @param flags	The flags to add the image with.
- * @return		WIMA_STATUS_SUCCESS on success, an
- *				error code otherwise.
- * @pre			@a win must not be NULL.
+ * Sets @a win as dirty, and if @a layout is true, forces a layout.
+ * @param win		The window to update.
+ * @param layout	Whether or not layout should be forced.
+ * @pre				@a win must not be NULL.
  */
-WimaStatus wima_window_addImage(WimaWin* win, const char* path, WimaImageFlags flags) yallnonnull;
+void wima_window_setDirty(WimaWin* win, bool layout) yallnonnull yinline;
 
 /**
- * Pops an image from a window. This should only
- * be used when there was an error adding an image
- * to a window. In any other case, the vectors of
- * images in windows could mismatch.
- * @param win	The window to pop an image from.
+ * Marks @a rect on @a win as damaged. If there is nothing
+ * else to redraw, only the header and areas that overlap
+ * damaged rectangles will be redrawn.
+ * @param win	The window to update.
+ * @param rect	The rectangle that needs to be redrawn.
  * @pre			@a win must not be NULL.
  */
-void wima_window_removeImage(WimaWin* win) yallnonnull;
+void wima_window_damage(WimaWin* win, WimaRect rect) yallnonnull;
 
 /**
- * Sets @a win as dirty, and if @a layout is true, forces a layout.
+ * Marks the area at @a node (and all of its children) as
+ * damaged. If @a layout is true, layout is also forced, but
+ * unlike @a wima_window_setDirty(), the window is not redrawn
+ * completely.
  * @param win		The window to update.
+ * @param node		The area to mark as damaged.
  * @param layout	Whether or not layout should be forced.
  * @pre				@a win must not be NULL.
+ * @pre				@a node must be valid in the current tree.
  */
-void wima_window_setDirty(WimaWin* win, bool layout) yallnonnull yinline;
+void wima_window_damageArea(WimaWin* win, WimaAreaNode node, bool layout) yallnonnull;
+
+/**
+ * Marks the part of @a win that @a wdgt is in as damaged.
+ * This is for after a widget has changed, whether because
+ * it handled an event or because it was (un)hovered.
+ * @param win	The window that @a wdgt is in.
+ * @param wdgt	The widget that was changed. If it is
+ *				invalid, nothing is damaged.
+ * @pre			@a win must not be NULL.
+ */
+void wima_window_damageWidget(WimaWin* win, WimaWidget wdgt) yallnonnull;
+
+/**
+ * Clears @a rect in @a win's framebuffer. This is used
+ * to clear damaged rectangles before they are redrawn.
+ * @param win	The window whose framebuffer will be cleared.
+ * @param rect	The rectangle to clear.
+ * @pre			@a win must not be NULL.
+ */
+void wima_window_clearRect(WimaWin* win, WimaRect rect) yallnonnull;
 
 /**
  * Sets the modifiers on @a win according to @a key and @a action.
@@ -458,6 +516,21 @@ void wima_window_setMouseBtn(WimaWin* win, WimaMouseBtn btn, WimaAction action)
  */
 void wima_window_removeMenu(WimaWin* win, WimaProperty menu) yallnonnull yinline;
 
+/**
+ * Copies @a wwksp into @a win and sets it up, including
+ * its min size, if the window does not have an up to
+ * date copy already. The window's context does not
+ * have to be current.
+ * @param win	The window to set up the workspace in.
+ * @param wwh	The handle of @a win.
+ * @param wwksp	The workspace to set up.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ * @pre			@a win must not be NULL.
+ * @pre			@a win must be activated.
+ */
+WimaStatus wima_window_initWorkspace(WimaWin* win, WimaWindow wwh, WimaWorkspace wwksp) yallnonnull;
+
 /**
  * Draws the window with the current layout.
  * @param win	The window to draw.
@@ -476,6 +549,46 @@ WimaStatus wima_window_draw(WimaWindow win);
  */
 WimaStatus wima_window_processEvents(WimaWindow win);
 
+/**
+ * Draws every valid window. The context is only switched
+ * for windows that will actually render, starting with the
+ * current one. Only the last window to render waits for
+ * vsync, so N windows cost one swap interval, not N.
+ */
+void wima_window_drawAll(void);
+
+/**
+ * Returns the earliest time (see @a wima_time()) when
+ * any window will need to be drawn without getting an
+ * event first, like when a tooltip is due.
+ * @return	The next deadline, or a negative number
+ *			if there is nothing pending, in which
+ *			case the event loop can block until
+ *			the next event.
+ */
+double wima_window_deadline(void);
+
+/**
+ * Processes the event queues of all valid windows. The
+ * context is only switched for windows with events.
+ */
+void wima_window_processAll(void);
+
+/**
+ * Destroys every window that has been asked to close
+ * (with @a wima_window_close()).
+ * @return	The number of windows that are left.
+ */
+uint8_t wima_window_closeAll(void);
+
+/**
+ * Destroys @a wwh and frees its slot.
+ * Handles to other windows stay valid.
+ * @param wwh	The window to remove.
+ * @pre			@a wwh must be valid.
+ */
+void wima_window_remove(WimaWindow wwh);
+
 /**
  * Callback to put Wima into "join areas" mode.
  * @param wdgt	The widget that received the event (unused).
@@ -507,6 +620,28 @@ bool wima_window_valid(WimaWindow wwh);
  */
 #define WIMA_WIN(win) ((WimaWindow)(long) glfwGetWindowUserPointer(win))
 
+/**
+ * @def WIMA_WIN_WKSP_INIT
+ * Returns true if @a wksp has been set up in the
+ * window, false otherwise.
+ * @param win	The window to test.
+ * @param wksp	The workspace to test.
+ * @return		true if @a wksp is set up in @a win,
+ *				false otherwise.
+ */
+#define WIMA_WIN_WKSP_INIT(win, wksp) ((win)->workspaceVersions[(wksp)] != 0)
+
+/**
+ * @def WIMA_WIN_WKSP_CURRENT
+ * Returns true if the copy of @a wksp in the window
+ * is up to date with the global one, false otherwise.
+ * @param win	The window to test.
+ * @param wksp	The workspace to test.
+ * @return		true if @a wksp is up to date in @a win,
+ *				false otherwise.
+ */
+#define WIMA_WIN_WKSP_CURRENT(win, wksp) ((win)->workspaceVersions[(wksp)] == wg.workspaceVersions[(wksp)])
+
 /**
  * @def WIMA_WIN_AREAS
  * Returns the current area tree in use on @a win.
@@ -108,36 +108,39 @@ WimaWorkspace wima_workspace_register(const char* const name, WimaIcon icon, Wim
 	WimaProperty prop = wima_prop_string_register(buffer, NULL, wima_wksp_desc, icon, name);
 	if (yerror(prop == WIMA_PROP_INVALID)) goto wima_wksp_reg_prop_reg_err;
 
-	WimaWksp wksp = dvec_pushTree(wg.workspaces);
+	WimaWksp wksp = wima_area_tree_push(wg.workspaces);
 	if (yerror(!wksp)) goto wima_wksp_reg_wksp_err;
 
-	if (yerror(dtree_copy(wksp, tree))) goto wima_wksp_reg_prop_push_err;
+	if (yerror(wima_area_tree_copy(wksp, tree))) goto wima_wksp_reg_prop_push_err;
 
 	if (yerror(dvec_push(wg.workspaceProps, &prop))) goto wima_wksp_reg_prop_push_err;
 
+	wg.workspaceVersions[len] = 1;
+
 	uint8_t winlen = dvec_len(wg.windows);
 
+	WimaSizef none;
+	none.w = none.h = 0.0f;
+
 	WimaWindow i;
 
-	for (i = 0; i < winlen;)
+	// Windows get an empty tree. It is only
+	// copied when the workspace is shown.
+	for (i = 0; i < winlen; ++i)
 	{
-		if (wima_window_valid(i))
-		{
-			WimaWin* win = dvec_get(wg.windows, i);
-
-			wima_window_setDirty(win, true);
+		if (!wima_window_valid(i)) continue;
 
-			WimaWksp wksp2 = dvec_pushTree(win->workspaces);
-			if (yerror(!wksp2)) goto wima_wksp_reg_win_err;
+		WimaWin* win = dvec_get(wg.windows, i);
 
-			// Increment i. This is done here to make
-			// the error handling loop handle this new
-			// workspace at this point.
-			++i;
+		if (yerror(!wima_area_tree_push(win->workspaces))) goto wima_wksp_reg_win_err;
 
-			DynaStatus status = dtree_copy(wksp2, wksp);
-			if (yerror(status)) goto wima_wksp_reg_win_err;
+		if (yerror(dvec_push(win->workspaceSizes, &none)))
+		{
+			dvec_pop(win->workspaces);
+			goto wima_wksp_reg_win_err;
 		}
+
+		wima_window_setDirty(win, true);
 	}
 
 	return len;
@@ -146,10 +149,11 @@ wima_wksp_reg_win_err:
 
 	for (WimaWindow j = 0; j < i; ++j)
 	{
-		if (wima_window_valid(i))
+		if (wima_window_valid(j))
 		{
-			WimaWin* win = dvec_get(wg.windows, i);
+			WimaWin* win = dvec_get(wg.windows, j);
 			dvec_pop(win->workspaces);
+			dvec_pop(win->workspaceSizes);
 		}
 	}
 
@@ -177,23 +181,45 @@ WimaStatus wima_workspace_updateFromWindow(WimaWorkspace wwksp, WimaWindow wwh)
 	wassert(wima_window_valid(wwh), WIMA_ASSERT_WIN);
 
 	WimaWin* win = dvec_get(wg.windows, wwh);
-	DynaTree areas = dvec_get(win->workspaces, wwksp);
+
+	// If the window never showed the workspace,
+	// it has nothing to update it with.
+	if (!WIMA_WIN_WKSP_INIT(win, wwksp)) return WIMA_STATUS_SUCCESS;
+
+	WimaArTree* areas = dvec_get(win->workspaces, wwksp);
 
 	wassert(wima_area_valid(areas), WIMA_ASSERT_AREA);
 
 	WimaWksp wksp = dvec_get(wg.workspaces, wwksp);
-	if (yerror(dtree_copy(wksp, areas))) return WIMA_STATUS_MALLOC_ERR;
+	wima_area_tree_destroy(wksp);
+
+	if (yerror(wima_area_tree_copy(wksp, areas))) return WIMA_STATUS_MALLOC_ERR;
+
+	// Other windows are not touched here. Their copies
+	// are now out of date, so they copy the new tree
+	// the next time that they show the workspace.
+	uint32_t version = wg.workspaceVersions[wwksp] + 1;
+	wg.workspaceVersions[wwksp] = version ? version : 1;
+
+	win->workspaceVersions[wwksp] = wg.workspaceVersions[wwksp];
 
 	WimaWindow winlen = dvec_len(wg.windows);
 
+	// Windows that are showing it need to copy it now.
+	// wima_window_initWorkspace() frees their old area
+	// caches in their own contexts.
 	for (WimaWindow i = 0; i < winlen; ++i)
 	{
 		if (i == wwh || !wima_window_valid(i)) continue;
 
 		WimaWin* win = dvec_get(wg.windows, i);
-		WimaWksp winWksp = dvec_get(win->workspaces, wwksp);
 
-		if (yerror(dtree_copy(winWksp, wksp))) return WIMA_STATUS_MALLOC_ERR;
+		if (win->wksp != wwksp || !WIMA_WIN_WKSP_INIT(win, wwksp)) continue;
+
+		WimaStatus status = wima_window_initWorkspace(win, i, wwksp);
+		if (yerror(status)) return status;
+
+		wima_window_setDirty(win, true);
 	}
 
 	return WIMA_STATUS_SUCCESS;
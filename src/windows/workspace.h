@@ -46,6 +46,8 @@ extern "C" {
 
 #include <wima/wima.h>
 
+#include "../areas/area.h"
+
 /**
  * @file workspace.h
  */
@@ -65,7 +67,7 @@ extern "C" {
 /**
  * A workspace, which can be broken down into areas.
  */
-typedef DynaTree WimaWksp;
+typedef WimaArTree* WimaWksp;
 
 /**
  * Checks whether @a n is valid within @a wwh.
@@ -73,7 +75,7 @@ typedef DynaTree WimaWksp;
  * @param n		The node to test.
  * @return		true if @a n is valid, false otherwise.
  */
-bool wima_workspace_nodeValid(WimaWorkspace wwh, DynaNode n);
+bool wima_workspace_nodeValid(WimaWorkspace wwh, WimaAreaNode n);
 
 /**
  * @}
@@ -0,0 +1,621 @@
+/*
+ *	***** BEGIN LICENSE BLOCK *****
+ *
+ *	Copyright 2017 Yzena Tech
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "Apache License")
+ *	with the following modification; you may not use this file except in
+ *	compliance with the Apache License and the following modification to it:
+ *	Section 6. Trademarks. is deleted and replaced with:
+ *
+ *	6. Trademarks. This License does not grant permission to use the trade
+ *		names, trademarks, service marks, or product names of the Licensor
+ *		and its affiliates, except as required to comply with Section 4(c) of
+ *		the License and to reproduce the content of the NOTICE file.
+ *
+ *	You may obtain a copy of the Apache License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the Apache License with the above modification is
+ *	distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *	KIND, either express or implied. See the Apache License for the specific
+ *	language governing permissions and limitations under the Apache License.
+ *
+ *	****** END LICENSE BLOCK ******
+ *
+ *	*****************************************************************
+ *
+ *	******* BEGIN FILE DESCRIPTION *******
+ *
+ *	Benchmarks for the layout, hit-test, and draw paths. Every
+ *	scenario runs a fixed script on a headless window and
+ *	reports ns/op and the distribution of frame times.
+ *
+ *	******** END FILE DESCRIPTION ********
+ */
+
+#include <wima/layout.h>
+#include <wima/prop.h>
+#include <wima/render.h>
+#include <wima/time.h>
+#include <wima/wima.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @def BENCH_WIDTH
+ * The width of the benchmark window.
+ */
+#define BENCH_WIDTH (1280)
+
+/**
+ * @def BENCH_HEIGHT
+ * The height of the benchmark window.
+ */
+#define BENCH_HEIGHT (720)
+
+/**
+ * @def BENCH_PROPS
+ * The number of props that widgets cycle through.
+ */
+#define BENCH_PROPS (64)
+
+/**
+ * @def BENCH_TREE_BUILDS
+ * The number of times each tree is built to time it.
+ */
+#define BENCH_TREE_BUILDS (1000)
+
+/**
+ * @def BENCH_GRIDS
+ * The number of area grid sizes.
+ */
+#define BENCH_GRIDS (4)
+
+/**
+ * @def BENCH_COUNTS
+ * The number of widget counts.
+ */
+#define BENCH_COUNTS (4)
+
+/**
+ * @def BENCH_LISTS
+ * The number of virtual list lengths.
+ */
+#define BENCH_LISTS (2)
+
+/**
+ * @def BENCH_ROW_HEIGHT
+ * The height of a virtual list row.
+ */
+#define BENCH_ROW_HEIGHT (24.0f)
+
+/**
+ * A benchmark operation. Each op is one frame.
+ * @param wwh	The window to run on.
+ * @param i		The index of the op.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+typedef WimaStatus (*BenchOp)(WimaWindow wwh, uint32_t i);
+
+/// The sizes (columns, rows) of area grids.
+const uint32_t grids[BENCH_GRIDS][2] = { { 2, 2 }, { 4, 4 }, { 8, 8 }, { 16, 16 } };
+
+/// The number of widgets in each widget region.
+const uint32_t counts[BENCH_COUNTS] = { 10, 1000, 50000, 100000 };
+
+/// The number of frames to run widget scenarios for.
+/// Fewer are run for big regions to keep times sane.
+const uint32_t countFrames[BENCH_COUNTS] = { 512, 128, 16, 8 };
+
+/// The names of the widget counts.
+const char* const countNames[BENCH_COUNTS] = { "10", "1k", "50k", "100k" };
+
+/// The number of rows in each virtual list. A long list
+/// should cost the same per frame as a short one.
+const uint32_t listRows[BENCH_LISTS] = { 50, 1000000 };
+
+/// The names of the list lengths.
+const char* const listNames[BENCH_LISTS] = { "50", "1M" };
+
+/// The props that widgets use.
+WimaProperty props[BENCH_PROPS];
+
+/// The menu for the menu scenario.
+WimaProperty menu;
+
+/// The workspaces with area grids.
+WimaWorkspace gridWksps[BENCH_GRIDS];
+
+/// The workspaces with widget regions.
+WimaWorkspace countWksps[BENCH_COUNTS];
+
+/// The workspaces with virtual lists.
+WimaWorkspace listWksps[BENCH_LISTS];
+
+/**
+ * Adds @a count widgets to @a root, cycling through the props.
+ * @param root	The layout to add to.
+ * @param count	The number of widgets to add.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+WimaStatus widgets(WimaLayout root, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		WimaWidget wdgt = wima_layout_widget(root, props[i % BENCH_PROPS]);
+		if (wdgt.widget == WIMA_WIDGET_INVALID) return WIMA_STATUS_LAYOUT_ERR;
+	}
+
+	return WIMA_STATUS_SUCCESS;
+}
+
+WimaStatus cb_layout10(WimaLayout root)
+{
+	return widgets(root, counts[0]);
+}
+
+WimaStatus cb_layout1k(WimaLayout root)
+{
+	return widgets(root, counts[1]);
+}
+
+WimaStatus cb_layout50k(WimaLayout root)
+{
+	return widgets(root, counts[2]);
+}
+
+WimaStatus cb_layout100k(WimaLayout root)
+{
+	return widgets(root, counts[3]);
+}
+
+WimaStatus cb_row(WimaLayout row, uint32_t idx)
+{
+	WimaWidget wdgt = wima_layout_widget(row, props[idx % BENCH_PROPS]);
+	return wdgt.widget == WIMA_WIDGET_INVALID ? WIMA_STATUS_LAYOUT_ERR : WIMA_STATUS_SUCCESS;
+}
+
+/**
+ * Adds a virtual list with @a rows rows to @a root.
+ * @param root	The layout to add to.
+ * @param rows	The number of rows.
+ * @return		WIMA_STATUS_SUCCESS on success, an
+ *				error code otherwise.
+ */
+WimaStatus list(WimaLayout root, uint32_t rows)
+{
+	WimaLayout wlh = wima_layout_virtualList(root, 0, rows, BENCH_ROW_HEIGHT, NULL, 0, cb_row);
+	return wlh.layout == WIMA_LAYOUT_INVALID ? WIMA_STATUS_LAYOUT_ERR : WIMA_STATUS_SUCCESS;
+}
+
+WimaStatus cb_list50(WimaLayout root)
+{
+	return list(root, listRows[0]);
+}
+
+WimaStatus cb_list1M(WimaLayout root)
+{
+	return list(root, listRows[1]);
+}
+
+void cb_error(WimaStatus status, const char* func, const char* desc)
+{
+	fprintf(stderr, "Wima returned the following error:\n");
+	fprintf(stderr, "    Error[%d]: %s\n    Function: %s\n", status, desc, func);
+	exit(status);
+}
+
+/**
+ * Adds a node that covers @a cols by @a rows areas to
+ * @a tree, splitting along the longer side each time.
+ * @param tree		The tree to add to.
+ * @param parent	The parent, or WIMA_AREA_INVALID for the root.
+ * @param left		Whether to add on the left of @a parent.
+ * @param cols		The number of columns of areas.
+ * @param rows		The number of rows of areas.
+ * @param editor	The editor for the areas.
+ * @param adds		A pointer to a count of adds to increment.
+ * @return			true on success, false otherwise.
+ */
+bool grid(WimaTree tree, WimaAreaNode parent, bool left, uint32_t cols, uint32_t rows, WimaEditor editor,
+          uint32_t* adds)
+{
+	WimaAreaNode node;
+
+	++(*adds);
+
+	if (cols == 1 && rows == 1)
+	{
+		if (parent == WIMA_AREA_INVALID)
+			node = wima_tree_addRootEditor(tree, editor);
+		else if (left)
+			node = wima_tree_addLeftEditor(tree, parent, editor);
+		else
+			node = wima_tree_addRightEditor(tree, parent, editor);
+
+		return node != WIMA_AREA_INVALID;
+	}
+
+	bool vertical = cols >= rows;
+	uint32_t n = vertical ? cols : rows;
+	uint32_t half = n / 2;
+	float split = (float) half / (float) n;
+
+	if (parent == WIMA_AREA_INVALID)
+		node = wima_tree_addRootParent(tree, split, vertical);
+	else if (left)
+		node = wima_tree_addLeftParent(tree, parent, split, vertical);
+	else
+		node = wima_tree_addRightParent(tree, parent, split, vertical);
+
+	if (node == WIMA_AREA_INVALID) return false;
+
+	if (vertical)
+	{
+		return grid(tree, node, true, half, rows, editor, adds) &&
+		       grid(tree, node, false, cols - half, rows, editor, adds);
+	}
+
+	return grid(tree, node, true, cols, half, editor, adds) && grid(tree, node, false, cols, rows - half, editor, adds);
+}
+
+/**
+ * Prints a row of frame stats, in milliseconds.
+ * @param name	The name of the row.
+ * @param s		The stats to print.
+ */
+void printStats(const char* name, WimaFrameStats s)
+{
+	printf("    %-8s min %9.3f  avg %9.3f  p99 %9.3f  max %9.3f ms\n", name, s.min * 1000.0, s.avg * 1000.0,
+	       s.p99 * 1000.0, s.max * 1000.0);
+}
+
+/**
+ * Runs @a ops ops of a scenario on @a wwh and prints
+ * the time per op and the frame time distribution.
+ * @param name	The name of the scenario.
+ * @param wwh	The window to run on.
+ * @param ops	The number of ops to run.
+ * @param op	The op to run.
+ */
+void run(const char* name, WimaWindow wwh, uint32_t ops, BenchOp op)
+{
+	static const char* const phases[] = { "events", "layout", "draw", "end", "swap", "total" };
+
+	// Settle the window first so that the
+	// scenario does not pay for the last one.
+	wima_window_layout(wwh);
+	if (wima_window_step(wwh)) exit(1);
+
+	wima_time_clearFrames(wwh);
+
+	uint64_t start = wima_time_raw();
+
+	for (uint32_t i = 0; i < ops; ++i)
+	{
+		WimaStatus status = op(wwh, i);
+		if (status) cb_error(status, name, "The scenario failed");
+	}
+
+	double secs = (double) (wima_time_raw() - start) / (double) wima_time_freq();
+
+	WimaFrameStats total = wima_time_frameStats(wwh, WIMA_FRAME_PHASE_TOTAL);
+
+	printf("%-24s %14.1f ns/op  (%u ops, %u frames drawn)\n", name, secs * 1e9 / ops, ops, total.frames);
+
+	if (!total.frames) return;
+
+	for (int i = 0; i <= WIMA_FRAME_PHASE_TOTAL; ++i)
+		printStats(phases[i], wima_time_frameStats(wwh, (WimaFramePhase) i));
+}
+
+WimaStatus op_layout(WimaWindow wwh, uint32_t i)
+{
+	(void) i;
+
+	wima_window_layout(wwh);
+
+	return wima_window_step(wwh);
+}
+
+WimaStatus op_draw(WimaWindow wwh, uint32_t i)
+{
+	(void) i;
+
+	wima_window_refresh(wwh);
+
+	return wima_window_step(wwh);
+}
+
+WimaStatus op_sweep(WimaWindow wwh, uint32_t i)
+{
+	// A raster sweep in 16 pixel steps.
+	uint32_t x = i * 16;
+
+	WimaVec pos;
+	pos.x = x % BENCH_WIDTH;
+	pos.y = (x / BENCH_WIDTH * 16) % BENCH_HEIGHT;
+
+	wima_window_injectMousePos(wwh, pos);
+
+	return wima_window_step(wwh);
+}
+
+WimaStatus op_drag(WimaWindow wwh, uint32_t i)
+{
+	// The root split is halfway across. Move it back and
+	// forth by up to a quarter of the window, 4 px at a time.
+	int range = BENCH_WIDTH / 4;
+	int offset = (int) (i * 4) % (range * 2);
+
+	WimaVec pos;
+	pos.x = BENCH_WIDTH / 2 - (offset < range ? offset : range * 2 - offset);
+	pos.y = BENCH_HEIGHT / 4;
+
+	wima_window_injectMousePos(wwh, pos);
+
+	return wima_window_step(wwh);
+}
+
+WimaStatus op_scroll(WimaWindow wwh, uint32_t i)
+{
+	// Eight steps down, then eight steps back up.
+	WimaScrollEvent e;
+	e.mods = WIMA_MOD_NONE;
+	e.xoffset = 0;
+	e.yoffset = (i / 8) & 1 ? 1 : -1;
+
+	wima_window_injectScroll(wwh, e);
+
+	return wima_window_step(wwh);
+}
+
+WimaStatus op_menu(WimaWindow wwh, uint32_t i)
+{
+	WimaStatus status;
+
+	if (i & 1)
+	{
+		status = wima_window_popOverlay(wwh);
+		wima_window_refresh(wwh);
+	}
+	else
+	{
+		status = wima_window_setContextMenu(wwh, menu);
+	}
+
+	if (status) return status;
+
+	return wima_window_step(wwh);
+}
+
+WimaStatus op_theme(WimaWindow wwh, uint32_t i)
+{
+	bool dark = i & 1;
+
+	wima_theme_setBackground(dark ? wima_color_rgb(40, 40, 40) : wima_color_rgb(200, 200, 200));
+	wima_theme_widget_setInner(WIMA_THEME_REGULAR, dark ? wima_color_rgb(80, 80, 80) : wima_color_rgb(160, 160, 160));
+
+	wima_window_refresh(wwh);
+
+	return wima_window_step(wwh);
+}
+
+int main()
+{
+	WimaAppFuncs appfuncs;
+	memset(&appfuncs, 0, sizeof(WimaAppFuncs));
+	appfuncs.error = cb_error;
+
+	WimaStatus status = wima_ninit("Wima Bench", appfuncs, "./res/DejaVuSans.ttf", 0);
+	if (status) return status;
+
+	wima_setHeadless(true);
+
+	char name[32];
+
+	for (uint32_t i = 0; i < BENCH_PROPS; ++i)
+	{
+		sprintf(name, "bench_int_%u", i);
+
+		props[i] = wima_prop_int_register(name, "Int", "A benchmark int", WIMA_ICON_INVALID, i, 0, 1000, 1);
+		if (props[i] == WIMA_PROP_INVALID) return 1;
+	}
+
+	menu = wima_prop_menu_register("bench_menu", "Menu", "A benchmark menu", WIMA_ICON_INVALID);
+	if (menu == WIMA_PROP_INVALID) return 1;
+
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		sprintf(name, "bench_menu_item_%u", i);
+
+		WimaProperty item = wima_prop_bool_register(name, "Item", "A benchmark menu item", WIMA_ICON_INVALID, false);
+		if (item == WIMA_PROP_INVALID) return 1;
+
+		status = wima_prop_menu_push(menu, item);
+		if (status) return status;
+	}
+
+	WimaRegionLayout layouts[BENCH_COUNTS] = { cb_layout10, cb_layout1k, cb_layout50k, cb_layout100k };
+	WimaEditor editors[BENCH_COUNTS];
+
+	WimaEditorFuncs funcs;
+	memset(&funcs, 0, sizeof(WimaEditorFuncs));
+
+	for (uint32_t i = 0; i < BENCH_COUNTS; ++i)
+	{
+		WimaRegion region = wima_region_register(layouts[i], WIMA_REGION_FLAG_SCROLL_VER);
+		if (region == WIMA_REGION_INVALID) return 1;
+
+		sprintf(name, "%s Widgets", countNames[i]);
+
+		editors[i] = wima_editor_nregister(name, funcs, WIMA_ICON_INVALID, true, 1, region);
+		if (editors[i] == WIMA_EDITOR_INVALID) return 1;
+	}
+
+	WimaRegionLayout lists[BENCH_LISTS] = { cb_list50, cb_list1M };
+	WimaEditor listEditors[BENCH_LISTS];
+
+	for (uint32_t i = 0; i < BENCH_LISTS; ++i)
+	{
+		WimaRegion region = wima_region_register(lists[i], WIMA_REGION_FLAG_SCROLL_VER);
+		if (region == WIMA_REGION_INVALID) return 1;
+
+		sprintf(name, "%s Rows", listNames[i]);
+
+		listEditors[i] = wima_editor_nregister(name, funcs, WIMA_ICON_INVALID, true, 1, region);
+		if (listEditors[i] == WIMA_EDITOR_INVALID) return 1;
+	}
+
+	// Time building the trees, then register them.
+	for (uint32_t i = 0; i < BENCH_GRIDS; ++i)
+	{
+		uint32_t adds = 0;
+
+		WimaTree tree = wima_tree_create();
+		if (!tree) return 1;
+
+		uint64_t start = wima_time_raw();
+
+		for (uint32_t j = 0; j < BENCH_TREE_BUILDS; ++j)
+		{
+			if (wima_tree_reset(tree)) return 1;
+			if (!grid(tree, WIMA_AREA_INVALID, true, grids[i][0], grids[i][1], editors[0], &adds)) return 1;
+		}
+
+		double secs = (double) (wima_time_raw() - start) / (double) wima_time_freq();
+
+		sprintf(name, "tree/add %ux%u", grids[i][0], grids[i][1]);
+		printf("%-24s %14.1f ns/op  (%u ops)\n", name, secs * 1e9 / adds, adds);
+
+		sprintf(name, "%ux%u Grid", grids[i][0], grids[i][1]);
+
+		gridWksps[i] = wima_workspace_register(name, WIMA_ICON_INVALID, tree);
+		if (gridWksps[i] == WIMA_WORKSPACE_INVALID) return 1;
+
+		wima_tree_free(tree);
+	}
+
+	for (uint32_t i = 0; i < BENCH_COUNTS; ++i)
+	{
+		WimaTree tree = wima_tree_create();
+		if (!tree) return 1;
+
+		if (wima_tree_addRootEditor(tree, editors[i]) == WIMA_AREA_INVALID) return 1;
+
+		sprintf(name, "%s Widgets", countNames[i]);
+
+		countWksps[i] = wima_workspace_register(name, WIMA_ICON_INVALID, tree);
+		if (countWksps[i] == WIMA_WORKSPACE_INVALID) return 1;
+
+		wima_tree_free(tree);
+	}
+
+	for (uint32_t i = 0; i < BENCH_LISTS; ++i)
+	{
+		WimaTree tree = wima_tree_create();
+		if (!tree) return 1;
+
+		if (wima_tree_addRootEditor(tree, listEditors[i]) == WIMA_AREA_INVALID) return 1;
+
+		sprintf(name, "%s Rows", listNames[i]);
+
+		listWksps[i] = wima_workspace_register(name, WIMA_ICON_INVALID, tree);
+		if (listWksps[i] == WIMA_WORKSPACE_INVALID) return 1;
+
+		wima_tree_free(tree);
+	}
+
+	WimaSize size;
+	size.w = BENCH_WIDTH;
+	size.h = BENCH_HEIGHT;
+
+	WimaWindow wwh = wima_window_create(gridWksps[0], size, false, false, false);
+	if (wwh == WIMA_WINDOW_INVALID) return EXIT_FAILURE;
+
+	status = wima_window_activate(wwh);
+	if (status) return status;
+
+	for (uint32_t i = 0; i < BENCH_GRIDS; ++i)
+	{
+		wima_window_setWorkspace(wwh, gridWksps[i]);
+
+		sprintf(name, "layout/grid %ux%u", grids[i][0], grids[i][1]);
+		run(name, wwh, 256, op_layout);
+	}
+
+	for (uint32_t i = 0; i < BENCH_COUNTS; ++i)
+	{
+		wima_window_setWorkspace(wwh, countWksps[i]);
+
+		sprintf(name, "layout/%s widgets", countNames[i]);
+		run(name, wwh, countFrames[i], op_layout);
+
+		sprintf(name, "draw/%s widgets", countNames[i]);
+		run(name, wwh, countFrames[i], op_draw);
+
+		sprintf(name, "sweep/%s widgets", countNames[i]);
+		run(name, wwh, countFrames[i], op_sweep);
+	}
+
+	// Scrolling needs the mouse over the list.
+	WimaVec pos;
+	pos.x = BENCH_WIDTH / 2;
+	pos.y = BENCH_HEIGHT / 2;
+
+	for (uint32_t i = 0; i < BENCH_LISTS; ++i)
+	{
+		wima_window_setWorkspace(wwh, listWksps[i]);
+		wima_window_injectMousePos(wwh, pos);
+
+		sprintf(name, "layout/list %s rows", listNames[i]);
+		run(name, wwh, 128, op_layout);
+
+		sprintf(name, "scroll/list %s rows", listNames[i]);
+		run(name, wwh, 128, op_scroll);
+	}
+
+	wima_window_setWorkspace(wwh, gridWksps[1]);
+
+	// Grab the root split, drag it, and let it go.
+	pos.x = BENCH_WIDTH / 2;
+	pos.y = BENCH_HEIGHT / 4;
+
+	WimaMouseBtnEvent btn;
+	btn.button = WIMA_MOUSE_LEFT;
+	btn.mods = WIMA_MOD_NONE;
+	btn.action = WIMA_ACTION_PRESS;
+
+	wima_window_injectMousePos(wwh, pos);
+	wima_window_injectMouseBtn(wwh, btn);
+
+	run("drag/split 4x4", wwh, 512, op_drag);
+
+	btn.action = WIMA_ACTION_RELEASE;
+	wima_window_injectMouseBtn(wwh, btn);
+
+	wima_window_setWorkspace(wwh, countWksps[0]);
+
+	pos.x = BENCH_WIDTH / 2;
+	pos.y = BENCH_HEIGHT / 2;
+	wima_window_injectMousePos(wwh, pos);
+
+	run("menu/open+close", wwh, 512, op_menu);
+
+	wima_window_setWorkspace(wwh, countWksps[1]);
+
+	run("theme/switch 1k widgets", wwh, 256, op_theme);
+
+	wima_exit();
+
+	return 0;
+}